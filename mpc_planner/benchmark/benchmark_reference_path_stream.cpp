@@ -0,0 +1,79 @@
+#include <mpc_planner/reference_path_stream.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#ifdef MPC_PLANNER_ROS
+#include <geometry_msgs/Quaternion.h>
+#else
+#include <geometry_msgs/msg/quaternion.hpp>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Minimal stand-in for nav_msgs/Path
+struct PathMsg
+{
+    struct Pose
+    {
+        struct
+        {
+            struct
+            {
+                double x, y, z;
+            } position;
+#ifdef MPC_PLANNER_ROS
+            geometry_msgs::Quaternion orientation;
+#else
+            geometry_msgs::msg::Quaternion orientation;
+#endif
+        } pose;
+    };
+
+    std::vector<Pose> poses;
+};
+
+// Times ReferencePathStream::update on messages of a rolling window over a winding route
+int main()
+{
+    MUTABLE_CONFIG["rolling_path"]["enable"] = true;
+    MUTABLE_CONFIG["debug_output"] = false;
+
+    // A winding route sampled every 0.5 m
+    double psi = 0.;
+    std::vector<double> route_x = {0.}, route_y = {0.};
+    for (int i = 1; i < 200; i++)
+    {
+        psi += 0.1 * std::sin(0.1 * i);
+        route_x.push_back(route_x.back() + 0.5 * std::cos(psi));
+        route_y.push_back(route_y.back() + 0.5 * std::sin(psi));
+    }
+
+    const int num_updates = 1000;
+    std::vector<PathMsg> messages(num_updates);
+    for (int i = 0; i < num_updates; i++)
+    {
+        for (int j = i % 100; j < i % 100 + 100; j++)
+        {
+            PathMsg::Pose pose;
+            pose.pose.position = {route_x[j], route_y[j], 0.};
+            pose.pose.orientation.w = 1.;
+            messages[i].poses.push_back(pose);
+        }
+    }
+
+    ReferencePathStream stream(1);
+    ReferencePath path;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto &msg : messages)
+        stream.update(msg, path);
+    double time = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "ReferencePathStream::update (100 points): " << time / num_updates << " us" << std::endl;
+    return 0;
+}
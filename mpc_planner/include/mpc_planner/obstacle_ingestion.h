@@ -0,0 +1,126 @@
+#ifndef OBSTACLE_INGESTION_H
+#define OBSTACLE_INGESTION_H
+
+#include <mpc_planner_types/data_types.h>
+
+#include <ros_tools/convertions.h>
+#include <ros_tools/logging.h>
+#include <ros_tools/profiling.h>
+
+#include <Eigen/Dense>
+
+#include <unordered_map>
+#include <vector>
+
+namespace MPCPlanner
+{
+    struct State;
+
+    /**
+     * @brief Converts obstacle messages (mpc_planner_msgs/ObstacleArray in ROS1 or ROS2) into dynamic obstacles.
+     *
+     * Obstacles are written into slots that are kept between messages and reused for the same obstacle ID, so that the
+     * prediction buffers are allocated once instead of on every callback. The output always holds max_obstacles
+     * obstacles: the obstacles of the message in message order, completed with dummy obstacles that are also kept between
+     * messages. If the message holds more than max_obstacles obstacles, the closest are output sorted on their distance
+     * with sequential IDs (0, 1, ...), as ensureObstacleSize.
+     */
+    class ObstacleIngestion
+    {
+    public:
+        ObstacleIngestion();
+
+    public:
+        /**
+         * @brief Convert the message into @p obstacles_out, reusing its storage where possible
+         * @param state The closest obstacles to the robot are kept and dummies are placed away from it
+         */
+        template <class ObstacleArrayMsg>
+        void ingest(const ObstacleArrayMsg &msg, const State &state, std::vector<DynamicObstacle> &obstacles_out)
+        {
+            PROFILE_SCOPE("ObstacleIngestion::ingest");
+            auto &benchmarker = BENCHMARKERS.getBenchmarker("obstacle_ingestion");
+            benchmarker.start();
+
+            beginMessage();
+
+            for (const auto &obstacle : msg.obstacles)
+            {
+                DynamicObstacle &dynamic_obstacle = _slots[claimSlot(obstacle.id)];
+
+                // Save the obstacle (ID, position, orientation, radius)
+                dynamic_obstacle.index = obstacle.id;
+                dynamic_obstacle.position = Eigen::Vector2d(obstacle.pose.position.x, obstacle.pose.position.y);
+                dynamic_obstacle.angle = RosTools::quaternionToAngle(obstacle.pose.orientation);
+                dynamic_obstacle.radius = _obstacle_radius;
+                dynamic_obstacle.type = ObstacleType::DYNAMIC;
+
+                auto &prediction = dynamic_obstacle.prediction;
+                prediction.modes[0].clear(); // Keeps its capacity
+
+                if (obstacle.probabilities.size() == 0) // No Predictions!
+                {
+                    prediction.type = PredictionType::NONE;
+                    continue;
+                }
+
+                ROSTOOLS_ASSERT(obstacle.probabilities.size() == 1, "Multiple modes not yet supported");
+
+                // Save the prediction (position, orientation, major/minor bivariate Gaussian size)
+                const auto &mode = obstacle.gaussians[0];
+                for (size_t k = 0; k < mode.mean.poses.size(); k++)
+                {
+                    prediction.modes[0].emplace_back(
+                        Eigen::Vector2d(mode.mean.poses[k].pose.position.x, mode.mean.poses[k].pose.position.y),
+                        RosTools::quaternionToAngle(mode.mean.poses[k].pose.orientation),
+                        mode.major_semiaxis[k],
+                        mode.minor_semiaxis[k]);
+                }
+
+                if (mode.major_semiaxis.empty() || mode.major_semiaxis.back() == 0. || !_probabilistic) // If uncertainty is zero
+                    prediction.type = PredictionType::DETERMINISTIC;
+                else
+                    prediction.type = PredictionType::GAUSSIAN;
+            }
+
+            endMessage(state, obstacles_out);
+
+            benchmarker.stop();
+        }
+
+        /** @brief Duration of the last call to ingest() (as reported by the "obstacle_ingestion" benchmarker) */
+        double getLastIngestionTime() const;
+
+        int numSlots() const { return (int)_slots.size(); }
+
+        void reset();
+
+    private:
+        std::vector<DynamicObstacle> _slots;   // Persistent obstacle storage
+        std::vector<bool> _slot_used;          // Whether the slot was filled by the current message
+        std::vector<int> _free_slots;          // Slots without an obstacle ID
+        std::vector<int> _message_slots;       // Slots in the order of the current message
+        std::unordered_map<int, int> _id_to_slot;
+
+        std::vector<DynamicObstacle> _dummies; // Fill the output up to max_obstacles
+        std::vector<double> _distances;
+        std::vector<int> _order;
+
+        int _N;
+        int _max_obstacles;
+        double _obstacle_radius;
+        bool _probabilistic;
+
+        void beginMessage();
+        int claimSlot(int id);
+        int addSlot();
+        void endMessage(const State &state, std::vector<DynamicObstacle> &obstacles_out);
+
+        /** @brief Keep the max_obstacles closest obstacles of the message, sorted on distance */
+        void keepClosest(const State &state);
+
+        void updateDummy(DynamicObstacle &dummy, const State &state);
+    };
+} // namespace MPCPlanner
+
+#endif // OBSTACLE_INGESTION_H
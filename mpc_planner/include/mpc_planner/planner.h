@@ -20,6 +20,7 @@ namespace MPCPlanner
     class ControllerModule;
     class Solver;
     class ExperimentUtil;
+    class ReplayRecorder;
 
     struct PlannerOutput
     {
@@ -35,6 +36,7 @@ namespace MPCPlanner
     {
     public:
         Planner();
+        ~Planner();
 
     public:
         PlannerOutput solveMPC(State &state, RealTimeData &data);
@@ -65,6 +67,10 @@ namespace MPCPlanner
         std::unique_ptr<RosTools::Timer> _startup_timer;
 
         std::vector<std::shared_ptr<ControllerModule>> _modules;
+
+        std::unique_ptr<ReplayRecorder> _recorder; // Only when recording for offline replay
+
+        PlannerOutput solveCycle(State &state, RealTimeData &data);
     };
 
 }
@@ -0,0 +1,82 @@
+#ifndef REFERENCE_PATH_STREAM_H
+#define REFERENCE_PATH_STREAM_H
+
+#include <mpc_planner_types/data_types.h>
+
+#include <ros_tools/convertions.h>
+#include <ros_tools/profiling.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Converts path messages (nav_msgs/Path in ROS1 or ROS2) into the reference path
+     *
+     * Changes are detected with a hash over all points of the message. With `rolling_path/enable`, a message that
+     * continues the previous one (passed points dropped at the front, new points appended at the back) is spliced into
+     * the current path: the s-coordinates of the points that remain are kept, such that the path progress of the
+     * planner stays valid, and the path is marked as a continuation.
+     *
+     * The modules still refit their splines over the whole new path on each change (RosTools::Spline2D cannot be
+     * extended in place). A continuation keeps the s-coordinates and the closest point search progress stable, not the
+     * spline coefficients.
+     */
+    class ReferencePathStream
+    {
+    public:
+        ReferencePathStream(int downsample = 1);
+
+    public:
+        /** @brief Update @p path from the message, returns false if the message did not change the path */
+        template <class PathMsg>
+        bool update(const PathMsg &msg, ReferencePath &path)
+        {
+            PROFILE_SCOPE("ReferencePathStream::update");
+
+            _msg_x.clear();
+            _msg_y.clear();
+            _msg_psi.clear();
+
+            for (const auto &pose : msg.poses)
+            {
+                _msg_x.push_back(pose.pose.position.x);
+                _msg_y.push_back(pose.pose.position.y);
+                _msg_psi.push_back(RosTools::quaternionToAngle(pose.pose.orientation));
+            }
+
+            return updatePath(path);
+        }
+
+        void reset();
+
+        bool isRolling() const { return _rolling; }
+
+    private:
+        int _downsample;
+        bool _rolling;
+
+        std::vector<double> _msg_x, _msg_y, _msg_psi; // Points of the incoming message
+        std::vector<double> _prev_x, _prev_y;         // Points of the previous message
+
+        std::vector<long> _route_index, _prev_route_index; // Index in the route of each path point
+        std::vector<double> _prev_s;
+
+        std::uint64_t _hash{0};
+        bool _has_path{false};
+        long _first_route_index{0}; // Index in the route of the first message point
+
+        bool updatePath(ReferencePath &path);
+
+        /** @brief Offset of the first message point in the previous message, if the message continues it (-1 otherwise) */
+        int findContinuation() const;
+
+        /** @brief Fill in the s-coordinates, reusing those of the previous path. Returns false if this was not possible. */
+        bool computeDistance(ReferencePath &path, bool continuation);
+
+        static std::uint64_t computeHash(const std::vector<double> &x, const std::vector<double> &y);
+    };
+} // namespace MPCPlanner
+
+#endif // REFERENCE_PATH_STREAM_H
@@ -0,0 +1,128 @@
+#ifndef MPC_PLANNER_REPLAY_H
+#define MPC_PLANNER_REPLAY_H
+
+#include <mpc_planner/planner.h>
+
+#include <mpc_planner_types/realtime_data.h>
+
+#include <yaml-cpp/yaml.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace costmap_2d
+{
+    class Costmap2D;
+}
+
+namespace MPCPlanner
+{
+    struct State;
+
+    /** @brief Data received (Planner::onDataReceived) or a reset between two cycles */
+    struct ReplayEvent
+    {
+        enum class Type
+        {
+            DATA = 0,
+            RESET
+        };
+
+        Type type;
+        std::string name; // Data name
+        bool success{true}; // Reset after success
+    };
+
+    /** @brief Cells of the full costmap window */
+    struct CostmapWindow
+    {
+        unsigned int size_x{0}, size_y{0};
+        double resolution{0.}, origin_x{0.}, origin_y{0.};
+        std::vector<unsigned char> cells; // Row-major (as the costmap char map)
+
+        bool empty() const { return cells.empty(); }
+    };
+
+    /** @brief Inputs and outputs of one call to Planner::solveMPC */
+    struct ReplayCycle
+    {
+        int index{0};
+        std::vector<ReplayEvent> events; // Since the previous cycle
+
+        std::vector<std::pair<std::string, double>> state;
+        RealTimeData data; // Without costmap, see costmap
+        CostmapWindow costmap;
+        double preparation_time{0.}; // [s] From data.planning_start_time until the call
+
+        YAML::Node config; // Null if unchanged since the previous cycle
+
+        PlannerOutput output;
+        std::map<std::string, double> timings; // [ms] Per planning stage
+    };
+
+    /**
+     * @brief Records the inputs and outputs of the planner per cycle, for offline replay (see mpc_planner_replay)
+     *
+     * Each cycle is a YAML document in the recording. Inputs are copied in the control loop, the documents are written
+     * by a background thread. The full costmap window is recorded, such that the replayed costmap has the geometry of the
+     * live costmap (modules that update incrementally, e.g., DecompConstraints, see the same moves of its origin).
+     */
+    class ReplayRecorder
+    {
+    public:
+        ReplayRecorder(const std::string &file);
+        ~ReplayRecorder(); // Writes the remaining cycles
+
+        ReplayRecorder(const ReplayRecorder &) = delete;
+        ReplayRecorder &operator=(const ReplayRecorder &) = delete;
+
+    public:
+        void onDataReceived(const std::string &data_name);
+        void onReset(bool success);
+
+        /** @brief Copy the inputs of the cycle, before the planner modifies them */
+        void recordInput(const State &state, const RealTimeData &data);
+
+        /** @brief Complete the cycle with its output and queue it to be written */
+        void recordOutput(const PlannerOutput &output, const std::map<std::string, double> &timings);
+
+    private:
+        std::ofstream _file;
+
+        ReplayCycle _cycle;
+        std::vector<std::string> _state_names;
+        int _config_version{-1}; // Configuration version of the last recorded configuration
+        int _num_cycles{0};
+
+        std::thread _writer;
+        std::mutex _mutex;
+        std::condition_variable _cycle_available;
+        std::deque<ReplayCycle> _queue;
+        bool _stop{false};
+
+        void write();
+    };
+
+    /** @brief Read all cycles of a recording, false if the file could not be read */
+    bool loadReplayRecording(const std::string &file, std::vector<ReplayCycle> &cycles);
+
+    /** @brief Load the recorded inputs of a cycle into the state and data (the costmap pointer is kept) */
+    void loadReplayInputs(const ReplayCycle &cycle, State &state, RealTimeData &data);
+
+    /**
+     * @brief Write the cells of the window into the costmap, which is created or resized if its geometry differs
+     * @note Without ROS costmaps, the costmap remains a nullptr
+     */
+    void loadCostmapWindow(const CostmapWindow &window, std::shared_ptr<costmap_2d::Costmap2D> &costmap);
+
+} // namespace MPCPlanner
+
+#endif // MPC_PLANNER_REPLAY_H
@@ -9,6 +9,7 @@
 #include <ros_tools/logging.h>
 #include <ros_tools/math.h>
 
+#include <algorithm>
 #include <numeric>
 
 namespace MPCPlanner
@@ -134,18 +135,17 @@ namespace MPCPlanner
                         std::sort(indices.begin(), indices.end(), [&](const int a, const int b)
                                   { return (distances[a] < distances[b]); });
 
-                        // Keep the closest obstacles
+                        // Keep the closest obstacles, in their original order and with their own IDs, such that
+                        // obstacles can be tracked over time
+                        indices.resize(max_obstacles);
+                        std::sort(indices.begin(), indices.end());
+
                         std::vector<DynamicObstacle> processed_obstacles;
-                        processed_obstacles.clear();
+                        processed_obstacles.reserve(max_obstacles);
 
                         for (size_t v = 0; v < max_obstacles; v++)
                                 processed_obstacles.push_back(obstacles[indices[v]]);
 
-                        for (size_t i = 0; i < processed_obstacles.size(); i++) // Sequential IDs
-                        {
-                                processed_obstacles[i].index = i;
-                        }
-
                         obstacles = processed_obstacles;
                 }
                 else if (obstacles.size() < max_obstacles)
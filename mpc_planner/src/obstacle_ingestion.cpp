@@ -0,0 +1,219 @@
+#include <mpc_planner/obstacle_ingestion.h>
+
+#include <mpc_planner/data_preparation.h>
+
+#include <mpc_planner_solver/state.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace MPCPlanner
+{
+    ObstacleIngestion::ObstacleIngestion()
+    {
+        _N = CONFIG["N"].as<int>();
+        _max_obstacles = CONFIG["max_obstacles"].as<int>();
+        _obstacle_radius = CONFIG["obstacle_radius"].as<double>();
+        _probabilistic = CONFIG["probabilistic"]["enable"].as<bool>();
+
+        // Typically, the obstacles in a message are the tracked obstacles, of which we keep max_obstacles
+        int expected_obstacles = 2 * CONFIG["max_obstacles"].as<int>();
+        _slots.reserve(expected_obstacles);
+        _slot_used.reserve(expected_obstacles);
+        _free_slots.reserve(expected_obstacles);
+        _message_slots.reserve(expected_obstacles);
+        _id_to_slot.reserve(expected_obstacles);
+        _distances.reserve(expected_obstacles);
+        _order.reserve(expected_obstacles);
+
+        for (int i = 0; i < _max_obstacles; i++)
+            _free_slots.push_back(addSlot());
+
+        _dummies.reserve(_max_obstacles);
+        for (int i = 0; i < _max_obstacles; i++)
+        {
+            _dummies.emplace_back(-1, Eigen::Vector2d(0., 0.), 0., 0.);
+            _dummies.back().prediction = Prediction(PredictionType::GAUSSIAN); // One mode
+            _dummies.back().prediction.modes[0].reserve(_N);
+        }
+    }
+
+    int ObstacleIngestion::addSlot()
+    {
+        _slots.emplace_back(-1, Eigen::Vector2d(0., 0.), 0., _obstacle_radius);
+        _slots.back().prediction = Prediction(PredictionType::GAUSSIAN); // One mode
+        _slots.back().prediction.modes[0].reserve(_N);
+        _slot_used.push_back(false);
+
+        return (int)_slots.size() - 1;
+    }
+
+    void ObstacleIngestion::beginMessage()
+    {
+        _message_slots.clear();
+        std::fill(_slot_used.begin(), _slot_used.end(), false);
+    }
+
+    int ObstacleIngestion::claimSlot(int id)
+    {
+        int slot;
+
+        auto it = _id_to_slot.find(id);
+        if (it != _id_to_slot.end() && !_slot_used[it->second]) // Known obstacle: reuse its slot
+        {
+            slot = it->second;
+        }
+        else
+        {
+            if (_free_slots.empty())
+                _free_slots.push_back(addSlot());
+
+            slot = _free_slots.back();
+            _free_slots.pop_back();
+
+            if (it == _id_to_slot.end()) // Duplicate IDs in one message do not get a persistent slot
+                _id_to_slot[id] = slot;
+        }
+
+        _slot_used[slot] = true;
+        _message_slots.push_back(slot);
+        return slot;
+    }
+
+    void ObstacleIngestion::endMessage(const State &state, std::vector<DynamicObstacle> &obstacles_out)
+    {
+        // Release the slots of obstacles that are no longer tracked (their memory is kept)
+        for (auto it = _id_to_slot.begin(); it != _id_to_slot.end();)
+        {
+            if (!_slot_used[it->second])
+            {
+                _free_slots.push_back(it->second);
+                it = _id_to_slot.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Duplicate ID slots are not in the map and are returned directly
+        for (int slot : _message_slots)
+        {
+            auto it = _id_to_slot.find(_slots[slot].index);
+            if (it == _id_to_slot.end() || it->second != slot)
+                _free_slots.push_back(slot);
+        }
+
+        bool sequential_ids = (int)_message_slots.size() > _max_obstacles;
+        if (sequential_ids)
+        {
+            LOG_MARK("Received " << _message_slots.size() << " > " << _max_obstacles << " obstacles. Keeping the closest.");
+            keepClosest(state);
+        }
+
+        // Complete the message with dummies, then copy assignment reuses the prediction buffers of the output obstacles
+        size_t num_obstacles = _message_slots.size();
+        for (size_t i = 0; i < (size_t)_max_obstacles; i++)
+        {
+            const DynamicObstacle *obstacle;
+            if (i < num_obstacles)
+            {
+                obstacle = &_slots[_message_slots[i]];
+            }
+            else
+            {
+                updateDummy(_dummies[i - num_obstacles], state);
+                obstacle = &_dummies[i - num_obstacles];
+            }
+
+            if (i < obstacles_out.size())
+                obstacles_out[i] = *obstacle;
+            else
+                obstacles_out.push_back(*obstacle);
+
+            if (sequential_ids)
+                obstacles_out[i].index = i;
+        }
+
+        if (obstacles_out.size() > (size_t)_max_obstacles)
+            obstacles_out.erase(obstacles_out.begin() + _max_obstacles, obstacles_out.end());
+    }
+
+    void ObstacleIngestion::keepClosest(const State &state)
+    {
+        Eigen::Vector2d position = state.getPos();
+        Eigen::Vector2d direction(std::cos(state.get("psi")), std::sin(state.get("psi")));
+        double v = state.get("v");
+
+        // Distance of the prediction to the constant velocity motion of the robot, scaled over the horizon
+        _distances.clear();
+        for (int slot : _message_slots)
+        {
+            const auto &obstacle = _slots[slot];
+            const auto &mode = obstacle.prediction.modes[0];
+            if (mode.empty()) // Without prediction, the current position is used
+            {
+                _distances.push_back((obstacle.position - position).norm());
+                continue;
+            }
+
+            double min_distance = 1e5;
+            for (int k = 0; k < std::min(_N, (int)mode.size()); k++)
+            {
+                double distance = (double)(k + 1) * 0.6 * (mode[k].position - (position + v * (double)k * direction)).norm();
+                min_distance = std::min(min_distance, distance);
+            }
+            _distances.push_back(min_distance);
+        }
+
+        _order.resize(_message_slots.size());
+        std::iota(_order.begin(), _order.end(), 0);
+        std::sort(_order.begin(), _order.end(), [&](const int a, const int b)
+                  { return _distances[a] < _distances[b]; });
+
+        // Keep the closest obstacles, closest first
+        for (int i = 0; i < _max_obstacles; i++)
+            _order[i] = _message_slots[_order[i]];
+        _message_slots.assign(_order.begin(), _order.begin() + _max_obstacles);
+    }
+
+    void ObstacleIngestion::updateDummy(DynamicObstacle &dummy, const State &state)
+    {
+        // As getDummyObstacle() with getConstantVelocityPrediction(), without allocating
+        dummy.index = -1;
+        dummy.position = state.getPos() + Eigen::Vector2d(100., 100.);
+        dummy.angle = 0.;
+        dummy.radius = 0.;
+        dummy.type = ObstacleType::DYNAMIC;
+
+        auto &prediction = dummy.prediction;
+        prediction.type = _probabilistic ? PredictionType::GAUSSIAN : PredictionType::DETERMINISTIC;
+        double noise = _probabilistic ? 0.3 : 0.;
+
+        prediction.modes[0].clear();
+        for (int k = 0; k < _N; k++)
+            prediction.modes[0].emplace_back(dummy.position, 0., noise, noise);
+
+        if (_probabilistic)
+            propagatePredictionUncertainty(prediction);
+    }
+
+    double ObstacleIngestion::getLastIngestionTime() const
+    {
+        return BENCHMARKERS.getBenchmarker("obstacle_ingestion").getLast();
+    }
+
+    void ObstacleIngestion::reset()
+    {
+        _id_to_slot.clear();
+        _message_slots.clear();
+        _free_slots.clear();
+        for (size_t i = 0; i < _slots.size(); i++)
+            _free_slots.push_back(i);
+
+        std::fill(_slot_used.begin(), _slot_used.end(), false);
+    }
+} // namespace MPCPlanner
@@ -0,0 +1,197 @@
+/**
+ * @brief Replays a recording of the planner (replay/record) offline, without ROS
+ *
+ * Each recorded cycle is fed through Planner::solveMPC as fast as possible. Reports the timings per planning stage
+ * (next to the recorded timings) and the difference between the replayed and recorded trajectories.
+ *
+ * Usage: mpc_planner_replay <recording> [repetitions = 1] [tolerance = 1e-3 m]
+ * Returns 2 if a replayed cycle differs from the recording by more than the tolerance.
+ */
+#include <mpc_planner/planner.h>
+#include <mpc_planner/replay.h>
+
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_types/realtime_data.h>
+#include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
+
+#include <ros_tools/profiling.h>
+
+#ifdef MPC_PLANNER_ROS
+#include <ros/time.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace MPCPlanner;
+
+namespace
+{
+    const std::vector<std::string> STAGES = {"planning", "update", "set_parameters", "optimization"};
+
+    /** @brief Largest distance between the positions of two trajectories (infinite if the lengths differ) */
+    double trajectoryDifference(const Trajectory &a, const Trajectory &b)
+    {
+        if (a.positions.size() != b.positions.size())
+            return std::numeric_limits<double>::infinity();
+
+        double difference = 0.;
+        for (size_t k = 0; k < a.positions.size(); k++)
+            difference = std::max(difference, (a.positions[k] - b.positions[k]).norm());
+        return difference;
+    }
+
+    void printTimings(const std::string &name, std::vector<double> times)
+    {
+        if (times.empty())
+            return;
+
+        std::sort(times.begin(), times.end());
+        double mean = 0.;
+        for (auto &time : times)
+            mean += time / times.size();
+
+        std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << mean
+                  << std::setw(10) << times[times.size() / 2]
+                  << std::setw(10) << times[std::min(times.size() - 1, (size_t)(0.95 * times.size()))]
+                  << std::setw(10) << times.back() << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <recording> [repetitions = 1] [tolerance = 1e-3 m]" << std::endl;
+        return 1;
+    }
+
+    int repetitions = argc > 2 ? std::stoi(argv[2]) : 1;
+    double tolerance = argc > 3 ? std::stod(argv[3]) : 1e-3;
+
+    std::vector<ReplayCycle> cycles;
+    if (!loadReplayRecording(argv[1], cycles) || cycles.empty() || cycles[0].config.IsNull())
+    {
+        std::cout << "No cycles with configuration in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Configure the planner as recorded
+    auto applyConfig = [](const YAML::Node &config)
+    {
+        MUTABLE_CONFIG = YAML::Clone(config);
+        MUTABLE_CONFIG["replay"]["record"] = false;   // Do not record the replay
+        MUTABLE_CONFIG["recording"]["enable"] = false; // Nor export experiment data
+    };
+    applyConfig(cycles[0].config);
+
+#ifdef MPC_PLANNER_ROS
+    ros::Time::init(); // Wall clock time, without a ROS master
+#endif
+
+    // There is no ROS node: the markers are never built or published
+    setVisualizationSubscriberCheck([](const std::string &)
+                                    { return false; });
+
+    std::map<std::string, std::vector<double>> recorded_times, replayed_times;
+    for (auto &cycle : cycles)
+    {
+        if (!cycle.output.success)
+            continue;
+
+        for (auto &stage : STAGES)
+        {
+            if (cycle.timings.find(stage) != cycle.timings.end())
+                recorded_times[stage].push_back(cycle.timings.at(stage));
+        }
+    }
+
+    int num_different = 0;
+    double max_difference = 0.;
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        Planner planner;
+        State state;
+        RealTimeData data;
+        std::shared_ptr<costmap_2d::Costmap2D> costmap;
+
+        for (auto &cycle : cycles)
+        {
+            if (!cycle.config.IsNull() && cycle.index > 0)
+                applyConfig(cycle.config);
+
+            loadCostmapWindow(cycle.costmap, costmap);
+            for (auto &event : cycle.events)
+            {
+                if (event.type == ReplayEvent::Type::RESET)
+                {
+                    planner.reset(state, data, event.success);
+                }
+                else
+                {
+                    loadReplayInputs(cycle, state, data);
+                    data.costmap = cycle.costmap.empty() ? nullptr : costmap.get();
+                    planner.onDataReceived(data, std::string(event.name));
+                }
+            }
+
+            loadReplayInputs(cycle, state, data);
+            data.costmap = cycle.costmap.empty() ? nullptr : costmap.get();
+            data.planning_start_time = std::chrono::system_clock::now() -
+                                       std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                                           std::chrono::duration<double>(cycle.preparation_time));
+
+            auto start = std::chrono::steady_clock::now();
+            PlannerOutput output = planner.solveMPC(state, data);
+            double solve_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            double difference = output.success == cycle.output.success
+                                    ? (output.success ? trajectoryDifference(output.trajectory, cycle.output.trajectory) : 0.)
+                                    : std::numeric_limits<double>::infinity();
+            if (difference > tolerance)
+            {
+                num_different++;
+                std::cout << "Cycle " << cycle.index << " differs: "
+                          << (output.success != cycle.output.success ? "success " + std::to_string(output.success) +
+                                                                           " (recorded " + std::to_string(cycle.output.success) + ")"
+                                                                     : "trajectory by " + std::to_string(difference) + " m")
+                          << std::endl;
+            }
+            if (output.success && cycle.output.success)
+                max_difference = std::max(max_difference, difference);
+
+            if (!output.success)
+                continue;
+
+            replayed_times["solveMPC"].push_back(solve_time);
+            for (auto &stage : STAGES)
+                replayed_times[stage].push_back(BENCHMARKERS.getBenchmarker(stage).getLast());
+        }
+    }
+
+    std::cout << std::endl
+              << "Replayed " << cycles.size() << " cycles " << repetitions << " time(s), "
+              << num_different << " differ from the recording (largest trajectory difference "
+              << max_difference << " m)" << std::endl
+              << std::endl;
+
+    std::cout << std::left << std::setw(32) << "Timing of solved cycles [ms]" << std::right
+              << std::setw(10) << "mean" << std::setw(10) << "median" << std::setw(10) << "p95" << std::setw(10) << "max"
+              << std::endl;
+    printTimings("solveMPC (replay)", replayed_times["solveMPC"]);
+    for (auto &stage : STAGES)
+    {
+        printTimings(stage + " (recorded)", recorded_times[stage]);
+        printTimings(stage + " (replay)", replayed_times[stage]);
+    }
+
+    return num_different > 0 ? 2 : 0;
+}
@@ -1,6 +1,7 @@
 #include <mpc_planner/planner.h>
 
 #include <mpc_planner/experiment_util.h>
+#include <mpc_planner/replay.h>
 
 /** @note: Autogenerated */
 #include <mpc_planner_modules/modules.h>
@@ -31,10 +32,29 @@ namespace MPCPlanner
         _experiment_util = std::make_shared<ExperimentUtil>();
 
         _startup_timer = std::make_unique<RosTools::Timer>(1.0); // Give some time to receive data
+
+        if (CONFIG["replay"]["record"].as<bool>())
+            _recorder = std::make_unique<ReplayRecorder>(CONFIG["replay"]["file"].as<std::string>());
     }
 
+    Planner::~Planner() = default;
+
     // Given real-time data, solve the MPC problem
     PlannerOutput Planner::solveMPC(State &state, RealTimeData &data)
+    {
+        if (!_recorder)
+            return solveCycle(state, data);
+
+        _recorder->recordInput(state, data);
+        solveCycle(state, data);
+        _recorder->recordOutput(_output, {{"planning", BENCHMARKERS.getBenchmarker("planning").getLast()},
+                                          {"update", BENCHMARKERS.getBenchmarker("update").getLast()},
+                                          {"set_parameters", BENCHMARKERS.getBenchmarker("set_parameters").getLast()},
+                                          {"optimization", BENCHMARKERS.getBenchmarker("optimization").getLast()}});
+        return _output;
+    }
+
+    PlannerOutput Planner::solveCycle(State &state, RealTimeData &data)
     {
         LOG_MARK("Planner::solveMPC");
         bool was_feasible = _output.success;
@@ -91,14 +111,18 @@ namespace MPCPlanner
             {
                 LOG_MARK("Updating modules");
                 PROFILE_SCOPE("Update");
+                BENCHMARKERS.getBenchmarker("update").start();
 
                 for (auto &module : _modules)
                     module->update(state, data, _module_data);
+
+                BENCHMARKERS.getBenchmarker("update").stop();
             }
 
             {
                 LOG_MARK("Setting parameters");
                 PROFILE_SCOPE("SetParameters");
+                BENCHMARKERS.getBenchmarker("set_parameters").start();
                 for (int k = 0; k < _solver->N; k++)
                 {
                     for (auto &module : _modules)
@@ -106,6 +130,7 @@ namespace MPCPlanner
                         module->setParameters(data, _module_data, k);
                     }
                 }
+                BENCHMARKERS.getBenchmarker("set_parameters").stop();
             }
 
             _warmstart = Trajectory();
@@ -169,6 +194,9 @@ namespace MPCPlanner
 
     void Planner::onDataReceived(RealTimeData &data, std::string &&data_name)
     {
+        if (_recorder)
+            _recorder->onDataReceived(data_name);
+
         for (auto &module : _modules)
             module->onDataReceived(data, std::forward<std::string>(data_name));
     }
@@ -182,24 +210,36 @@ namespace MPCPlanner
         for (auto &module : _modules)
             module->visualize(data, _module_data);
 
-        visualizeTrajectory(_output.trajectory, "planned_trajectory", true, 0.2);
+        // Markers are only built for topics with subscribers, within their rate
+        double robot_radius = CONFIG["robot_radius"].as<double>();
+        if (shouldVisualize("planned_trajectory"))
+            visualizeTrajectory(_output.trajectory, "planned_trajectory", robot_radius, true, 0.2);
 
-        if (CONFIG["debug_visuals"].as<bool>())
-            visualizeTrajectory(_warmstart, "warmstart_trajectory", true, 0.2);
+        if (CONFIG["debug_visuals"].as<bool>() && shouldVisualize("warmstart_trajectory"))
+            visualizeTrajectory(_warmstart, "warmstart_trajectory", robot_radius, true, 0.2);
 
-        visualizeObstacles(data.dynamic_obstacles, "obstacles", true, 1.0);
-        visualizeObstaclePredictions(data.dynamic_obstacles, "obstacle_predictions", true);
-        visualizeRobotArea(state.getPos(), state.get("psi"), data.robot_area, "robot_area", true);
+        if (shouldVisualize("obstacles"))
+            visualizeObstacles(data.dynamic_obstacles, "obstacles", true, 1.0);
+        if (shouldVisualize("obstacle_predictions"))
+            visualizeObstaclePredictions(data.dynamic_obstacles, "obstacle_predictions", true);
+        if (shouldVisualize("robot_area"))
+            visualizeRobotArea(state.getPos(), state.get("psi"), data.robot_area, "robot_area", true);
 
-        std::vector<double> angles;
-        for (int k = 1; k < _solver->N; k++)
-            angles.emplace_back(_solver->getOutput(k, "psi"));
+        if (shouldVisualize("robot_rect_area"))
+        {
+            visualizeRectangularRobotArea(state.getPos(), state.get("psi"),
+                                          CONFIG["robot"]["length"].as<double>(), CONFIG["robot"]["width"].as<double>(),
+                                          "robot_rect_area", true);
+        }
 
-        visualizeRectangularRobotArea(state.getPos(), state.get("psi"),
-                                      CONFIG["robot"]["length"].as<double>(), CONFIG["robot"]["width"].as<double>(),
-                                      "robot_rect_area", true);
+        if (shouldVisualize("robot_area_trajectory"))
+        {
+            std::vector<double> angles;
+            for (int k = 1; k < _solver->N; k++)
+                angles.emplace_back(_solver->getOutput(k, "psi"));
 
-        visualizeRobotAreaTrajectory(_output.trajectory, angles, data.robot_area, "robot_area_trajectory", true, 0.1);
+            visualizeRobotAreaTrajectory(_output.trajectory, angles, data.robot_area, "robot_area_trajectory", true, 0.1);
+        }
         LOG_MARK("Planner::visualize Done");
     }
 
@@ -233,6 +273,9 @@ namespace MPCPlanner
         if (CONFIG["recording"]["enable"].as<bool>())
             _experiment_util->onTaskComplete(success); // Save data
 
+        if (_recorder)
+            _recorder->onReset(success);
+
         _solver->reset(); // Reset the solver
 
         for (auto &module : _modules) // Reset modules
@@ -0,0 +1,160 @@
+#include <mpc_planner/reference_path_stream.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MPCPlanner
+{
+    ReferencePathStream::ReferencePathStream(int downsample)
+        : _downsample(std::max(downsample, 1))
+    {
+        _rolling = CONFIG["rolling_path"]["enable"].as<bool>();
+    }
+
+    void ReferencePathStream::reset()
+    {
+        _has_path = false;
+        _hash = 0;
+        _first_route_index = 0;
+        _prev_x.clear();
+        _prev_y.clear();
+        _route_index.clear();
+    }
+
+    bool ReferencePathStream::updatePath(ReferencePath &path)
+    {
+        std::uint64_t hash = computeHash(_msg_x, _msg_y);
+        if (_has_path && hash == _hash) // The path did not change
+            return false;
+
+        int offset = (_rolling && _has_path) ? findContinuation() : -1;
+        bool continuation = offset >= 0;
+        _first_route_index = continuation ? _first_route_index + offset : 0;
+
+        // Keep the previous path to reuse its s-coordinates
+        _prev_route_index.swap(_route_index);
+        _prev_s.swap(path.s);
+
+        path.clear();
+        _route_index.clear();
+
+        int num_points = _msg_x.size();
+        for (int i = 0; i < num_points; i++)
+        {
+            // Downsample relative to the start of the route, so that the same points are kept in every message
+            long route_index = _first_route_index + i;
+            if (route_index % _downsample != 0 && i != num_points - 1)
+                continue;
+
+            path.x.push_back(_msg_x[i]);
+            path.y.push_back(_msg_y[i]);
+            path.psi.push_back(_msg_psi[i]);
+            _route_index.push_back(route_index);
+        }
+
+        if (_rolling && !computeDistance(path, continuation))
+        {
+            continuation = false; // The previous path could not be continued
+            _first_route_index = 0;
+            computeDistance(path, false);
+        }
+
+        path.is_continuation = continuation;
+        if (continuation)
+            LOG_MARK("Reference path continued (" << offset << " points dropped)");
+
+        _prev_x.swap(_msg_x);
+        _prev_y.swap(_msg_y);
+        _hash = hash;
+        _has_path = true;
+        return true;
+    }
+
+    int ReferencePathStream::findContinuation() const
+    {
+        if (_msg_x.empty())
+            return -1;
+
+        for (size_t offset = 0; offset < _prev_x.size(); offset++)
+        {
+            if (_prev_x[offset] != _msg_x[0] || _prev_y[offset] != _msg_y[0])
+                continue;
+
+            // All overlapping points need to be the same
+            bool overlaps = true;
+            for (size_t i = 1; i < _msg_x.size() && offset + i < _prev_x.size(); i++)
+            {
+                if (_prev_x[offset + i] != _msg_x[i] || _prev_y[offset + i] != _msg_y[i])
+                {
+                    overlaps = false;
+                    break;
+                }
+            }
+
+            if (overlaps)
+                return offset;
+        }
+
+        return -1;
+    }
+
+    bool ReferencePathStream::computeDistance(ReferencePath &path, bool continuation)
+    {
+        path.s.clear();
+        if (path.x.empty())
+            return true;
+
+        for (size_t i = 0; i < path.x.size(); i++)
+        {
+            if (continuation)
+            {
+                // Points that were already in the path keep their s
+                auto it = std::lower_bound(_prev_route_index.begin(), _prev_route_index.end(), _route_index[i]);
+                if (it != _prev_route_index.end() && *it == _route_index[i] &&
+                    (size_t)(it - _prev_route_index.begin()) < _prev_s.size())
+                {
+                    path.s.push_back(_prev_s[it - _prev_route_index.begin()]);
+                    continue;
+                }
+
+                if (i == 0) // The start of the path should be known
+                    return false;
+            }
+
+            if (i == 0)
+                path.s.push_back(0.);
+            else
+                path.s.push_back(path.s.back() + std::hypot(path.x[i] - path.x[i - 1], path.y[i] - path.y[i - 1]));
+        }
+
+        return true;
+    }
+
+    std::uint64_t ReferencePathStream::computeHash(const std::vector<double> &x, const std::vector<double> &y)
+    {
+        // FNV-1a over the bits of all coordinates
+        std::uint64_t hash = 14695981039346656037ULL;
+        auto add = [&](double value)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int byte = 0; byte < 8; byte++)
+            {
+                hash ^= (bits >> (8 * byte)) & 0xff;
+                hash *= 1099511628211ULL;
+            }
+        };
+
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            add(x[i]);
+            add(y[i]);
+        }
+        return hash;
+    }
+} // namespace MPCPlanner
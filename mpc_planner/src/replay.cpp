@@ -0,0 +1,457 @@
+#include <mpc_planner/replay.h>
+
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/logging.h>
+
+#ifdef MPC_PLANNER_ROS
+#include <costmap_2d/costmap_2d.h>
+#endif
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace MPCPlanner
+{
+    namespace
+    {
+        void emitVector(YAML::Emitter &out, const std::vector<double> &values)
+        {
+            out << YAML::Flow << YAML::BeginSeq;
+            for (auto &value : values)
+                out << value;
+            out << YAML::EndSeq;
+        }
+
+        void emitPosition(YAML::Emitter &out, const Eigen::Vector2d &position)
+        {
+            out << YAML::Flow << YAML::BeginSeq << position(0) << position(1) << YAML::EndSeq;
+        }
+
+        void emitPositions(YAML::Emitter &out, const std::vector<Eigen::Vector2d> &positions)
+        {
+            out << YAML::BeginSeq;
+            for (auto &position : positions)
+                emitPosition(out, position);
+            out << YAML::EndSeq;
+        }
+
+        void emitPath(YAML::Emitter &out, const ReferencePath &path)
+        {
+            out << YAML::BeginMap;
+            out << YAML::Key << "x" << YAML::Value;
+            emitVector(out, path.x);
+            out << YAML::Key << "y" << YAML::Value;
+            emitVector(out, path.y);
+            out << YAML::Key << "psi" << YAML::Value;
+            emitVector(out, path.psi);
+            out << YAML::Key << "v" << YAML::Value;
+            emitVector(out, path.v);
+            out << YAML::Key << "s" << YAML::Value;
+            emitVector(out, path.s);
+            out << YAML::Key << "is_continuation" << YAML::Value << path.is_continuation;
+            out << YAML::EndMap;
+        }
+
+        void emitObstacle(YAML::Emitter &out, const DynamicObstacle &obstacle)
+        {
+            out << YAML::BeginMap;
+            out << YAML::Key << "index" << YAML::Value << obstacle.index;
+            out << YAML::Key << "position" << YAML::Value;
+            emitPosition(out, obstacle.position);
+            out << YAML::Key << "angle" << YAML::Value << obstacle.angle;
+            out << YAML::Key << "radius" << YAML::Value << obstacle.radius;
+            out << YAML::Key << "type" << YAML::Value << (int)obstacle.type;
+
+            const auto &prediction = obstacle.prediction;
+            out << YAML::Key << "prediction" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "type" << YAML::Value << (int)prediction.type;
+            out << YAML::Key << "probabilities" << YAML::Value;
+            emitVector(out, prediction.probabilities);
+            out << YAML::Key << "modes" << YAML::Value << YAML::BeginSeq;
+            for (auto &mode : prediction.modes)
+            {
+                out << YAML::BeginSeq;
+                for (auto &step : mode) // [x, y, angle, major radius, minor radius]
+                {
+                    out << YAML::Flow << YAML::BeginSeq << step.position(0) << step.position(1) << step.angle
+                        << step.major_radius << step.minor_radius << YAML::EndSeq;
+                }
+                out << YAML::EndSeq;
+            }
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+
+            out << YAML::EndMap;
+        }
+
+        void emitCostmap(YAML::Emitter &out, const CostmapWindow &window)
+        {
+            out << YAML::BeginMap;
+            out << YAML::Key << "size" << YAML::Value << YAML::Flow << YAML::BeginSeq << window.size_x << window.size_y << YAML::EndSeq;
+            out << YAML::Key << "resolution" << YAML::Value << window.resolution;
+            out << YAML::Key << "origin" << YAML::Value << YAML::Flow << YAML::BeginSeq << window.origin_x << window.origin_y << YAML::EndSeq;
+
+            // Run-length encoded: [cost, count, cost, count, ...]
+            out << YAML::Key << "cells" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+            for (size_t i = 0; i < window.cells.size();)
+            {
+                size_t count = 1;
+                while (i + count < window.cells.size() && window.cells[i + count] == window.cells[i])
+                    count++;
+                out << (int)window.cells[i] << count;
+                i += count;
+            }
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+        }
+
+        void emitCycle(YAML::Emitter &out, const ReplayCycle &cycle)
+        {
+            out << YAML::BeginMap;
+            out << YAML::Key << "cycle" << YAML::Value << cycle.index;
+
+            out << YAML::Key << "events" << YAML::Value << YAML::BeginSeq;
+            for (auto &event : cycle.events)
+            {
+                out << YAML::Flow << YAML::BeginMap;
+                if (event.type == ReplayEvent::Type::RESET)
+                    out << YAML::Key << "reset" << YAML::Value << event.success;
+                else
+                    out << YAML::Key << "data" << YAML::Value << event.name;
+                out << YAML::EndMap;
+            }
+            out << YAML::EndSeq;
+
+            if (!cycle.config.IsNull())
+                out << YAML::Key << "config" << YAML::Value << cycle.config;
+
+            out << YAML::Key << "preparation_time" << YAML::Value << cycle.preparation_time;
+
+            out << YAML::Key << "state" << YAML::Value << YAML::Flow << YAML::BeginMap;
+            for (auto &value : cycle.state)
+                out << YAML::Key << value.first << YAML::Value << value.second;
+            out << YAML::EndMap;
+
+            const auto &data = cycle.data;
+            out << YAML::Key << "data" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "robot_area" << YAML::Value << YAML::BeginSeq;
+            for (auto &disc : data.robot_area)
+                out << YAML::Flow << YAML::BeginSeq << disc.offset << disc.radius << YAML::EndSeq;
+            out << YAML::EndSeq;
+            out << YAML::Key << "past_trajectory" << YAML::Value;
+            emitPositions(out, data.past_trajectory.positions);
+            out << YAML::Key << "dynamic_obstacles" << YAML::Value << YAML::BeginSeq;
+            for (auto &obstacle : data.dynamic_obstacles)
+                emitObstacle(out, obstacle);
+            out << YAML::EndSeq;
+            out << YAML::Key << "reference_path" << YAML::Value;
+            emitPath(out, data.reference_path);
+            out << YAML::Key << "left_bound" << YAML::Value;
+            emitPath(out, data.left_bound);
+            out << YAML::Key << "right_bound" << YAML::Value;
+            emitPath(out, data.right_bound);
+            out << YAML::Key << "goal" << YAML::Value;
+            emitPosition(out, data.goal);
+            out << YAML::Key << "goal_received" << YAML::Value << data.goal_received;
+            out << YAML::Key << "intrusion" << YAML::Value << data.intrusion;
+            if (!cycle.costmap.empty())
+            {
+                out << YAML::Key << "costmap" << YAML::Value;
+                emitCostmap(out, cycle.costmap);
+            }
+            out << YAML::EndMap;
+
+            out << YAML::Key << "output" << YAML::Value << YAML::BeginMap;
+            out << YAML::Key << "success" << YAML::Value << cycle.output.success;
+            out << YAML::Key << "trajectory" << YAML::Value;
+            emitPositions(out, cycle.output.trajectory.positions);
+            out << YAML::EndMap;
+
+            out << YAML::Key << "timings" << YAML::Value << YAML::Flow << YAML::BeginMap;
+            for (auto &timing : cycle.timings)
+                out << YAML::Key << timing.first << YAML::Value << timing.second;
+            out << YAML::EndMap;
+
+            out << YAML::EndMap;
+        }
+
+        Eigen::Vector2d readPosition(const YAML::Node &node)
+        {
+            return Eigen::Vector2d(node[0].as<double>(), node[1].as<double>());
+        }
+
+        std::vector<Eigen::Vector2d> readPositions(const YAML::Node &node)
+        {
+            std::vector<Eigen::Vector2d> positions;
+            positions.reserve(node.size());
+            for (auto &position : node)
+                positions.emplace_back(readPosition(position));
+            return positions;
+        }
+
+        void readPath(const YAML::Node &node, ReferencePath &path)
+        {
+            path.clear();
+            path.x = node["x"].as<std::vector<double>>();
+            path.y = node["y"].as<std::vector<double>>();
+            path.psi = node["psi"].as<std::vector<double>>();
+            path.v = node["v"].as<std::vector<double>>();
+            path.s = node["s"].as<std::vector<double>>();
+            path.is_continuation = node["is_continuation"].as<bool>();
+        }
+
+        DynamicObstacle readObstacle(const YAML::Node &node)
+        {
+            DynamicObstacle obstacle(node["index"].as<int>(), readPosition(node["position"]), node["angle"].as<double>(),
+                                     node["radius"].as<double>(), (ObstacleType)node["type"].as<int>());
+
+            const auto &prediction = node["prediction"];
+            obstacle.prediction.type = (PredictionType)prediction["type"].as<int>();
+            obstacle.prediction.probabilities = prediction["probabilities"].as<std::vector<double>>();
+            for (auto &mode : prediction["modes"])
+            {
+                obstacle.prediction.modes.emplace_back();
+                for (auto &step : mode)
+                {
+                    obstacle.prediction.modes.back().emplace_back(Eigen::Vector2d(step[0].as<double>(), step[1].as<double>()),
+                                                                  step[2].as<double>(), step[3].as<double>(), step[4].as<double>());
+                }
+            }
+            return obstacle;
+        }
+
+        void readCostmap(const YAML::Node &node, CostmapWindow &window)
+        {
+            window.size_x = node["size"][0].as<unsigned int>();
+            window.size_y = node["size"][1].as<unsigned int>();
+            window.resolution = node["resolution"].as<double>();
+            window.origin_x = node["origin"][0].as<double>();
+            window.origin_y = node["origin"][1].as<double>();
+
+            const auto &cells = node["cells"];
+            window.cells.reserve(window.size_x * window.size_y);
+            for (size_t i = 0; i + 1 < cells.size(); i += 2)
+                window.cells.insert(window.cells.end(), cells[i + 1].as<size_t>(), (unsigned char)cells[i].as<int>());
+        }
+
+        void readCycle(const YAML::Node &node, ReplayCycle &cycle)
+        {
+            cycle.index = node["cycle"].as<int>();
+
+            for (auto &event : node["events"])
+            {
+                if (event["reset"])
+                    cycle.events.push_back({ReplayEvent::Type::RESET, "", event["reset"].as<bool>()});
+                else
+                    cycle.events.push_back({ReplayEvent::Type::DATA, event["data"].as<std::string>(), true});
+            }
+
+            if (node["config"])
+                cycle.config = node["config"];
+
+            cycle.preparation_time = node["preparation_time"].as<double>();
+
+            for (auto it = node["state"].begin(); it != node["state"].end(); ++it)
+                cycle.state.emplace_back(it->first.as<std::string>(), it->second.as<double>());
+
+            const auto &data_node = node["data"];
+            auto &data = cycle.data;
+            for (auto &disc : data_node["robot_area"])
+                data.robot_area.emplace_back(disc[0].as<double>(), disc[1].as<double>());
+            data.past_trajectory.positions = readPositions(data_node["past_trajectory"]);
+            for (auto &obstacle : data_node["dynamic_obstacles"])
+                data.dynamic_obstacles.push_back(readObstacle(obstacle));
+            readPath(data_node["reference_path"], data.reference_path);
+            readPath(data_node["left_bound"], data.left_bound);
+            readPath(data_node["right_bound"], data.right_bound);
+            data.goal = readPosition(data_node["goal"]);
+            data.goal_received = data_node["goal_received"].as<bool>();
+            data.intrusion = data_node["intrusion"].as<double>();
+            if (data_node["costmap"])
+                readCostmap(data_node["costmap"], cycle.costmap);
+
+            cycle.output.success = node["output"]["success"].as<bool>();
+            cycle.output.trajectory.positions = readPositions(node["output"]["trajectory"]);
+
+            for (auto it = node["timings"].begin(); it != node["timings"].end(); ++it)
+                cycle.timings[it->first.as<std::string>()] = it->second.as<double>();
+        }
+
+#ifdef MPC_PLANNER_ROS
+        /** @brief Copy all cells of the costmap with its geometry */
+        void extractCostmapWindow(const costmap_2d::Costmap2D &costmap, CostmapWindow &window)
+        {
+            window.size_x = costmap.getSizeInCellsX();
+            window.size_y = costmap.getSizeInCellsY();
+            window.resolution = costmap.getResolution();
+            window.origin_x = costmap.getOriginX();
+            window.origin_y = costmap.getOriginY();
+
+            const unsigned char *char_map = costmap.getCharMap();
+            window.cells.assign(char_map, char_map + window.size_x * window.size_y);
+        }
+#endif
+    }
+
+    ReplayRecorder::ReplayRecorder(const std::string &file)
+        : _file(file)
+    {
+        if (!_file.is_open())
+            LOG_WARN("Could not open the replay recording " << file);
+        else
+            LOG_VALUE("Replay Recording", file);
+
+        _writer = std::thread(&ReplayRecorder::write, this);
+    }
+
+    ReplayRecorder::~ReplayRecorder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cycle_available.notify_one();
+        _writer.join();
+    }
+
+    void ReplayRecorder::onDataReceived(const std::string &data_name)
+    {
+        _cycle.events.push_back({ReplayEvent::Type::DATA, data_name, true});
+    }
+
+    void ReplayRecorder::onReset(bool success)
+    {
+        _cycle.events.push_back({ReplayEvent::Type::RESET, "", success});
+    }
+
+    void ReplayRecorder::recordInput(const State &state, const RealTimeData &data)
+    {
+        _cycle.preparation_time = std::chrono::duration<double>(std::chrono::system_clock::now() - data.planning_start_time).count();
+
+        if (_state_names.empty())
+            _state_names = state.getNames();
+
+        _cycle.state.clear();
+        for (auto &name : _state_names)
+            _cycle.state.emplace_back(name, state.get(std::string(name)));
+
+        _cycle.data = data;
+        _cycle.data.costmap = nullptr;
+
+#ifdef MPC_PLANNER_ROS
+        if (data.costmap != nullptr)
+            extractCostmapWindow(*data.costmap, _cycle.costmap);
+#endif
+    }
+
+    void ReplayRecorder::recordOutput(const PlannerOutput &output, const std::map<std::string, double> &timings)
+    {
+        _cycle.index = _num_cycles++;
+        _cycle.output = output;
+        _cycle.timings = timings;
+
+        // Recorded with the first cycle and after each write (see Configuration::getMutableYAMLNode), written by the other thread
+        int config_version = Configuration::getInstance().getVersion();
+        if (config_version != _config_version)
+        {
+            _cycle.config = YAML::Clone(CONFIG);
+            _config_version = config_version;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(std::move(_cycle));
+        }
+        _cycle_available.notify_one();
+
+        _cycle.config.reset(); // Detach from the queued cycle (assigning a YAML node modifies the node it references)
+        _cycle = ReplayCycle();
+    }
+
+    void ReplayRecorder::write()
+    {
+        while (true)
+        {
+            ReplayCycle cycle;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cycle_available.wait(lock, [this]()
+                                      { return _stop || !_queue.empty(); });
+
+                if (_queue.empty()) // Stopped and all cycles were written
+                    return;
+
+                cycle = std::move(_queue.front());
+                _queue.pop_front();
+            }
+
+            YAML::Emitter out;
+            out.SetDoublePrecision(std::numeric_limits<double>::max_digits10); // Exact doubles
+            emitCycle(out, cycle);
+
+            _file << "---\n"
+                  << out.c_str() << "\n";
+            _file.flush(); // Keep the recording up to date in case the planner crashes
+        }
+    }
+
+    bool loadReplayRecording(const std::string &file, std::vector<ReplayCycle> &cycles)
+    {
+        cycles.clear();
+        try
+        {
+            std::vector<YAML::Node> documents = YAML::LoadAllFromFile(file);
+            cycles.resize(documents.size());
+            for (size_t i = 0; i < documents.size(); i++)
+                readCycle(documents[i], cycles[i]);
+        }
+        catch (const YAML::Exception &e)
+        {
+            LOG_WARN("Could not read the replay recording " << file << ": " << e.what());
+            cycles.clear();
+            return false;
+        }
+        return true;
+    }
+
+    void loadReplayInputs(const ReplayCycle &cycle, State &state, RealTimeData &data)
+    {
+        for (auto &value : cycle.state)
+            state.set(std::string(value.first), value.second);
+
+        costmap_2d::Costmap2D *costmap = data.costmap;
+        data = cycle.data;
+        data.costmap = costmap;
+    }
+
+    void loadCostmapWindow(const CostmapWindow &window, std::shared_ptr<costmap_2d::Costmap2D> &costmap)
+    {
+#ifdef MPC_PLANNER_ROS
+        if (window.empty())
+            return;
+
+        if (costmap == nullptr)
+        {
+            costmap = std::make_shared<costmap_2d::Costmap2D>(window.size_x, window.size_y, window.resolution,
+                                                              window.origin_x, window.origin_y);
+        }
+        else if (costmap->getSizeInCellsX() != window.size_x || costmap->getSizeInCellsY() != window.size_y ||
+                 costmap->getResolution() != window.resolution)
+        {
+            costmap->resizeMap(window.size_x, window.size_y, window.resolution, window.origin_x, window.origin_y);
+        }
+        else if (costmap->getOriginX() != window.origin_x || costmap->getOriginY() != window.origin_y)
+        {
+            costmap->updateOrigin(window.origin_x, window.origin_y); // Rolling window (the cells are overwritten below)
+        }
+
+        std::memcpy(costmap->getCharMap(), window.cells.data(), window.cells.size());
+#else
+        (void)window;
+        (void)costmap;
+#endif
+    }
+} // namespace MPCPlanner
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner/obstacle_ingestion.h"
+
+#include <mpc_planner_solver/state.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#ifdef MPC_PLANNER_ROS
+#include <geometry_msgs/Quaternion.h>
+#else
+#include <geometry_msgs/msg/quaternion.hpp>
+#endif
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+using namespace MPCPlanner;
+
+class ObstacleIngestionTest : public ::testing::Test
+{
+protected:
+    // Minimal stand-in for mpc_planner_msgs/ObstacleArray
+    struct Pose
+    {
+        struct
+        {
+            double x, y, z;
+        } position;
+#ifdef MPC_PLANNER_ROS
+        geometry_msgs::Quaternion orientation;
+#else
+        geometry_msgs::msg::Quaternion orientation;
+#endif
+    };
+
+    struct ObstacleMsg
+    {
+        int id;
+        Pose pose;
+        std::vector<double> probabilities;
+
+        struct Gaussian
+        {
+            struct
+            {
+                struct PoseStamped
+                {
+                    Pose pose;
+                };
+                std::vector<PoseStamped> poses;
+            } mean;
+            std::vector<double> major_semiaxis, minor_semiaxis;
+        };
+        std::vector<Gaussian> gaussians;
+    };
+
+    struct ObstacleArrayMsg
+    {
+        std::vector<ObstacleMsg> obstacles;
+    };
+
+    void SetUp() override
+    {
+        std::string path = std::filesystem::path(__FILE__).parent_path().string() + "/../../mpc_planner_jackal/src/src";
+        path = SYSTEM_CONFIG_PATH(path, "settings");
+        Configuration::getInstance().initialize(path);
+        MUTABLE_CONFIG["max_obstacles"] = 3;
+        MUTABLE_CONFIG["probabilistic"]["enable"] = false;
+        MUTABLE_CONFIG["debug_output"] = false;
+
+        N = CONFIG["N"].as<int>();
+
+        // The robot stands at the origin
+        state.set("x", 0.);
+        state.set("y", 0.);
+        state.set("psi", 0.);
+        state.set("v", 0.);
+    }
+
+    // A static obstacle at (x, y) with a deterministic prediction
+    ObstacleMsg createObstacle(int id, double x, double y)
+    {
+        ObstacleMsg obstacle;
+        obstacle.id = id;
+        obstacle.pose.position = {x, y, 0.};
+        obstacle.pose.orientation.w = 1.;
+        obstacle.probabilities = {1.};
+
+        obstacle.gaussians.emplace_back();
+        auto &mode = obstacle.gaussians.back();
+        mode.mean.poses.resize(N);
+        for (auto &pose : mode.mean.poses)
+        {
+            pose.pose.position = {x, y, 0.};
+            pose.pose.orientation.w = 1.;
+        }
+        mode.major_semiaxis.assign(N, 0.);
+        mode.minor_semiaxis.assign(N, 0.);
+        return obstacle;
+    }
+
+    int N;
+    State state;
+};
+
+TEST_F(ObstacleIngestionTest, MessageOrderWithDummies)
+{
+    ObstacleIngestion ingestion;
+    std::vector<DynamicObstacle> obstacles;
+
+    ObstacleArrayMsg msg;
+    msg.obstacles = {createObstacle(7, 5., 0.), createObstacle(3, 1., 0.)};
+    ingestion.ingest(msg, state, obstacles);
+
+    ASSERT_EQ(obstacles.size(), 3u);
+    EXPECT_EQ(obstacles[0].index, 7);
+    EXPECT_EQ(obstacles[1].index, 3);
+    EXPECT_DOUBLE_EQ(obstacles[0].position(0), 5.);
+    EXPECT_EQ(obstacles[0].prediction.type, PredictionType::DETERMINISTIC);
+    EXPECT_EQ((int)obstacles[0].prediction.modes[0].size(), N);
+
+    EXPECT_EQ(obstacles[2].index, -1); // Dummy, away from the robot
+    EXPECT_GT(obstacles[2].position.norm(), 100.);
+    EXPECT_EQ((int)obstacles[2].prediction.modes[0].size(), N);
+}
+
+TEST_F(ObstacleIngestionTest, KeepsClosestSortedOnDistance)
+{
+    ObstacleIngestion ingestion;
+    std::vector<DynamicObstacle> obstacles;
+
+    // As ensureObstacleSize: the closest obstacles, closest first, with sequential IDs
+    ObstacleArrayMsg msg;
+    msg.obstacles = {createObstacle(10, 5., 0.), createObstacle(11, 1., 0.), createObstacle(12, 0., 4.),
+                     createObstacle(13, -2., 0.), createObstacle(14, 0., -3.)};
+    ingestion.ingest(msg, state, obstacles);
+
+    ASSERT_EQ(obstacles.size(), 3u);
+    std::vector<double> distances = {1., 2., 3.};
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(obstacles[i].index, i);
+        EXPECT_DOUBLE_EQ(obstacles[i].position.norm(), distances[i]);
+    }
+
+    // The next message within the limit keeps its IDs and order
+    msg.obstacles = {createObstacle(14, 0., -3.), createObstacle(10, 5., 0.)};
+    ingestion.ingest(msg, state, obstacles);
+    EXPECT_EQ(obstacles[0].index, 14);
+    EXPECT_EQ(obstacles[1].index, 10);
+    EXPECT_EQ(obstacles[2].index, -1);
+}
+
+TEST_F(ObstacleIngestionTest, Heading)
+{
+    ObstacleIngestion ingestion;
+    std::vector<DynamicObstacle> obstacles;
+
+    ObstacleArrayMsg msg;
+    msg.obstacles = {createObstacle(0, 1., 0.)};
+    msg.obstacles[0].pose.orientation.z = std::sin(0.25);
+    msg.obstacles[0].pose.orientation.w = std::cos(0.25);
+    ingestion.ingest(msg, state, obstacles);
+
+    EXPECT_NEAR(obstacles[0].angle, 0.5, 1e-9);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner/reference_path_stream.h"
+
+#include <mpc_planner_util/parameters.h>
+
+#ifdef MPC_PLANNER_ROS
+#include <geometry_msgs/Quaternion.h>
+#else
+#include <geometry_msgs/msg/quaternion.hpp>
+#endif
+
+#include <cmath>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the conversion of (rolling) path messages into the reference path
+class ReferencePathStreamTest : public ::testing::Test
+{
+protected:
+    // Minimal stand-in for nav_msgs/Path
+    struct PathMsg
+    {
+        struct Pose
+        {
+            struct
+            {
+                struct
+                {
+                    double x, y, z;
+                } position;
+#ifdef MPC_PLANNER_ROS
+                geometry_msgs::Quaternion orientation;
+#else
+                geometry_msgs::msg::Quaternion orientation;
+#endif
+            } pose;
+        };
+
+        std::vector<Pose> poses;
+    };
+
+    std::vector<double> route_x, route_y;
+
+    void SetUp() override
+    {
+        MUTABLE_CONFIG["rolling_path"]["enable"] = true;
+        MUTABLE_CONFIG["debug_output"] = false;
+
+        // A winding route sampled every 0.5 m
+        double psi = 0.;
+        route_x = {0.};
+        route_y = {0.};
+        for (int i = 1; i < 200; i++)
+        {
+            psi += 0.1 * std::sin(0.1 * i);
+            route_x.push_back(route_x.back() + 0.5 * std::cos(psi));
+            route_y.push_back(route_y.back() + 0.5 * std::sin(psi));
+        }
+    }
+
+    // Message with the route points [first, last)
+    PathMsg createMessage(int first, int last, double y_offset = 0.)
+    {
+        PathMsg msg;
+        for (int i = first; i < last; i++)
+        {
+            PathMsg::Pose pose;
+            pose.pose.position = {route_x[i], route_y[i] + y_offset, 0.};
+            pose.pose.orientation.w = 1.;
+            msg.poses.push_back(pose);
+        }
+        return msg;
+    }
+
+    // s-coordinate of the path point at (x, y), -1 if the point is not in the path
+    double findDistance(const ReferencePath &path, double x, double y)
+    {
+        for (size_t i = 0; i < path.x.size(); i++)
+        {
+            if (path.x[i] == x && path.y[i] == y)
+                return path.s[i];
+        }
+        return -1.;
+    }
+};
+
+TEST_F(ReferencePathStreamTest, ContinuationWithDownsampling)
+{
+    ReferencePathStream stream(2);
+    ReferencePath path;
+
+    ASSERT_TRUE(stream.update(createMessage(0, 40), path));
+    EXPECT_FALSE(path.is_continuation);
+    EXPECT_EQ(path.x.size(), 21u); // Every second point and the last point
+    EXPECT_DOUBLE_EQ(path.s.front(), 0.);
+    ReferencePath previous = path;
+
+    // Three points passed, five points appended
+    ASSERT_TRUE(stream.update(createMessage(3, 45), path));
+    EXPECT_TRUE(path.is_continuation);
+
+    // The same route points are kept (relative to the route start), the first kept point is route point 4
+    EXPECT_EQ(path.x.front(), route_x[4]);
+    EXPECT_EQ(path.x.back(), route_x[44]);
+    for (size_t i = 0; i + 1 < path.x.size(); i++)
+        EXPECT_NEAR(std::hypot(path.x[i] - route_x[4 + 2 * i], path.y[i] - route_y[4 + 2 * i]), 0., 1e-12);
+
+    // Points that remain keep their s-coordinate
+    for (int i = 4; i <= 38; i += 2)
+        EXPECT_DOUBLE_EQ(findDistance(path, route_x[i], route_y[i]), findDistance(previous, route_x[i], route_y[i]));
+
+    // New points continue the distance along the path
+    for (size_t i = 1; i < path.s.size(); i++)
+        EXPECT_NEAR(path.s[i] - path.s[i - 1], std::hypot(path.x[i] - path.x[i - 1], path.y[i] - path.y[i - 1]), 1e-9);
+
+    // A second continuation keeps counting from the route start
+    ASSERT_TRUE(stream.update(createMessage(8, 50), path));
+    EXPECT_TRUE(path.is_continuation);
+    EXPECT_EQ(path.x.front(), route_x[8]);
+    EXPECT_DOUBLE_EQ(findDistance(path, route_x[8], route_y[8]), findDistance(previous, route_x[8], route_y[8]));
+}
+
+TEST_F(ReferencePathStreamTest, NonContinuingMessage)
+{
+    ReferencePathStream stream(2);
+    ReferencePath path;
+
+    ASSERT_TRUE(stream.update(createMessage(0, 40), path));
+
+    // A shifted route does not overlap with the previous message
+    ASSERT_TRUE(stream.update(createMessage(3, 45, 1.), path));
+    EXPECT_FALSE(path.is_continuation);
+    EXPECT_DOUBLE_EQ(path.s.front(), 0.);
+    EXPECT_EQ(path.x.front(), route_x[3]); // Downsampled from the start of the new route
+    EXPECT_EQ(path.x.size(), 22u);
+
+    // Neither does a message that changes the overlapping points
+    PathMsg msg = createMessage(10, 50, 1.);
+    msg.poses[5].pose.position.x += 0.1;
+    ASSERT_TRUE(stream.update(msg, path));
+    EXPECT_FALSE(path.is_continuation);
+    EXPECT_DOUBLE_EQ(path.s.front(), 0.);
+}
+
+TEST_F(ReferencePathStreamTest, UnchangedMessage)
+{
+    ReferencePathStream stream(2);
+    ReferencePath path;
+
+    ASSERT_TRUE(stream.update(createMessage(0, 40), path));
+    ReferencePath previous = path;
+
+    EXPECT_FALSE(stream.update(createMessage(0, 40), path));
+    EXPECT_EQ(path.x, previous.x);
+    EXPECT_EQ(path.s, previous.s);
+}
+
+TEST_F(ReferencePathStreamTest, Reset)
+{
+    ReferencePathStream stream(2);
+    ReferencePath path;
+
+    ASSERT_TRUE(stream.update(createMessage(0, 40), path));
+    ASSERT_TRUE(stream.update(createMessage(3, 45), path));
+    EXPECT_TRUE(path.is_continuation);
+
+    // After a reset, the same message is a new path that is downsampled from its start
+    stream.reset();
+    ASSERT_TRUE(stream.update(createMessage(3, 45), path));
+    EXPECT_FALSE(path.is_continuation);
+    EXPECT_DOUBLE_EQ(path.s.front(), 0.);
+    EXPECT_EQ(path.x.front(), route_x[3]);
+
+    // And the stream continues from there
+    ASSERT_TRUE(stream.update(createMessage(5, 47), path));
+    EXPECT_TRUE(path.is_continuation);
+    EXPECT_EQ(path.x.front(), route_x[5]);
+}
+
+TEST_F(ReferencePathStreamTest, Heading)
+{
+    ReferencePathStream stream(1);
+    ReferencePath path;
+
+    PathMsg msg = createMessage(0, 10);
+    for (size_t i = 0; i < msg.poses.size(); i++)
+    {
+        double psi = 0.3 * i - 1.;
+        msg.poses[i].pose.orientation.z = std::sin(psi / 2.);
+        msg.poses[i].pose.orientation.w = std::cos(psi / 2.);
+    }
+
+    ASSERT_TRUE(stream.update(msg, path));
+    for (size_t i = 0; i < path.psi.size(); i++)
+        EXPECT_NEAR(path.psi[i], 0.3 * i - 1., 1e-9);
+}
@@ -4,6 +4,7 @@
 #include <mpc_planner_dingo/dingo_reconfigure.h>
 
 #include <mpc_planner/planner.h>
+#include <mpc_planner/reference_path_stream.h>
 
 #include <mpc_planner_solver/solver_interface.h>
 
@@ -56,6 +57,7 @@ public:
 
 private:
     std::unique_ptr<Planner> _planner;
+    std::unique_ptr<ReferencePathStream> _path_stream;
     std::unique_ptr<DingoReconfigure> _reconfigure;
 
     RealTimeData _data;
@@ -92,7 +94,6 @@ private:
     void parseObstacle(const derived_object_msgs::Object &object, double object_angle,
                        std::vector<Eigen::Vector2d> &positions_out, std::vector<double> &radii_out);
 
-    bool isPathTheSame(const nav_msgs::Path::ConstPtr &path);
 
     void visualize();
 };
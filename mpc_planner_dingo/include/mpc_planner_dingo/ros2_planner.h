@@ -2,6 +2,7 @@
 #define dingo_PLANNER_H
 
 #include <mpc_planner/planner.h>
+#include <mpc_planner/reference_path_stream.h>
 
 #include <mpc_planner_solver/solver_interface.h>
 
@@ -34,6 +35,7 @@ public:
 
 private:
     std::unique_ptr<Planner> _planner;
+    std::unique_ptr<ReferencePathStream> _path_stream;
 
     RealTimeData _data;
     State _state;
@@ -49,7 +51,6 @@ private:
 
     rclcpp::Publisher<geometry_msgs::msg::Twist>::SharedPtr _cmd_pub;
 
-    bool isPathTheSame(nav_msgs::msg::Path::SharedPtr path);
 
     void visualize();
 };
@@ -4,6 +4,7 @@
 
 #include <ros_tools/visuals.h>
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 #include <ros_tools/logging.h>
 #include <mpc_planner_util/load_yaml.hpp>
 
@@ -27,6 +28,7 @@ DingoPlanner::DingoPlanner(ros::NodeHandle &nh)
 
     // Initialize the planner
     _planner = std::make_unique<Planner>();
+    _path_stream = std::make_unique<ReferencePathStream>();
 
     // Initialize the ROS interface
     initializeSubscribersAndPublishers(nh);
@@ -137,7 +139,6 @@ void DingoPlanner::loop(const ros::TimerEvent &event)
         _state.set("vy", v(1));
         LOG_VALUE_DEBUG("Commanded vx", cmd.linear.x);
         LOG_VALUE_DEBUG("Commanded vy", cmd.linear.y);
-        CONFIG["enable_output"] = true;
     }
     else if (!_enable_output)
     {
@@ -205,37 +206,13 @@ void DingoPlanner::goalCallback(const geometry_msgs::PoseStamped::ConstPtr &msg)
     _planner->onDataReceived(_data, "goal");
 }
 
-bool DingoPlanner::isPathTheSame(const nav_msgs::Path::ConstPtr &msg)
-{
-    // Check if the path is the same
-    if (_data.reference_path.x.size() != msg->poses.size())
-        return false;
-
-    // Check up to the first two points
-    int num_points = std::min(2, (int)_data.reference_path.x.size());
-    for (int i = 0; i < num_points; i++)
-    {
-        if (!_data.reference_path.pointInPath(i, msg->poses[i].pose.position.x, msg->poses[i].pose.position.y))
-            return false;
-    }
-    return true;
-}
-
 void DingoPlanner::pathCallback(const nav_msgs::Path::ConstPtr &msg)
 {
     LOG_DEBUG("Path callback");
 
-    if (isPathTheSame(msg))
+    if (!_path_stream->update(*msg, _data.reference_path)) // Same path (compares all points)
         return;
 
-    _data.reference_path.clear();
-
-    for (auto &pose : msg->poses)
-    {
-        _data.reference_path.x.push_back(pose.pose.position.x);
-        _data.reference_path.y.push_back(pose.pose.position.y);
-    }
-    _data.reference_path.psi.push_back(0.0);
     _planner->onDataReceived(_data, "reference_path");
 }
 
@@ -354,7 +331,8 @@ void DingoPlanner::bluetoothCallback(const sensor_msgs::Joy::ConstPtr &msg)
         LOG_INFO("Deadmanswitch enabled (deadman switch released)");
 
     _enable_output = msg->axes[2] < -0.9;
-    CONFIG["enable_output"] = _enable_output;
+    if (CONFIG["enable_output"].as<bool>() != _enable_output) // Writes increment the configuration version
+        MUTABLE_CONFIG["enable_output"] = _enable_output;
 }
 
 void DingoPlanner::visualize()
@@ -391,6 +369,7 @@ void DingoPlanner::reset()
     _reverse_roadmap_pub.publish(empty_msg);
 
     _planner->reset(_state, _data);
+    _path_stream->reset(); // The planner reset clears the reference path
 }
 
 int main(int argc, char **argv)
@@ -400,6 +379,7 @@ int main(int argc, char **argv)
     ros::NodeHandle nh;
     auto dingo_planner = std::make_shared<DingoPlanner>(nh);
     VISUALS.init(&nh);
+    startSubscriberMonitorROS1();
 
     ros::spin();
 
@@ -2,6 +2,7 @@
 
 #include <ros_tools/visuals.h>
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 #include <ros_tools/logging.h>
 #include <mpc_planner_util/load_yaml.hpp>
 
@@ -19,6 +20,7 @@ dingoPlanner::dingoPlanner() : Node("dingo_planner")
 
     // Initialize the planner
     _planner = std::make_unique<Planner>();
+    _path_stream = std::make_unique<ReferencePathStream>();
 
     // Initialize the ROS interface
     initializeSubscribersAndPublishers();
@@ -108,37 +110,13 @@ void dingoPlanner::goalCallback(geometry_msgs::msg::PoseStamped::SharedPtr msg)
     _data.goal_received = true;
 }
 
-bool dingoPlanner::isPathTheSame(nav_msgs::msg::Path::SharedPtr msg)
-{
-    // Check if the path is the same
-    if (_data.reference_path.x.size() != msg->poses.size())
-        return false;
-
-    // Check up to the first two points
-    int num_points = std::min(2, (int)_data.reference_path.x.size());
-    for (int i = 0; i < num_points; i++)
-    {
-        if (!_data.reference_path.pointInPath(i, msg->poses[i].pose.position.x, msg->poses[i].pose.position.y))
-            return false;
-    }
-    return true;
-}
-
 void dingoPlanner::pathCallback(nav_msgs::msg::Path::SharedPtr msg)
 {
     LOG_DEBUG("Path callback");
 
-    if (isPathTheSame(msg))
+    if (!_path_stream->update(*msg, _data.reference_path)) // Same path (compares all points)
         return;
 
-    _data.reference_path.clear();
-
-    for (auto &pose : msg->poses)
-    {
-        _data.reference_path.x.push_back(pose.pose.position.x);
-        _data.reference_path.y.push_back(pose.pose.position.y);
-    }
-    _data.reference_path.psi.push_back(0.0);
     _planner->onDataReceived(_data, "reference_path");
 }
 
@@ -158,6 +136,8 @@ int main(int argc, char **argv)
 
     auto dingo_planner = std::make_shared<dingoPlanner>();
     VISUALS.init(dingo_planner.get());
+    setVisualizationSubscriberCheck([node = dingo_planner.get()](const std::string &topic_name)
+                                    { return node->count_subscribers("~/" + topic_name) > 0; });
 
     rclcpp::spin(dingo_planner);
 
@@ -4,6 +4,7 @@
 #include <mpc_planner_jackal/jackal_reconfigure.h>
 
 #include <mpc_planner/planner.h>
+#include <mpc_planner/reference_path_stream.h>
 
 #include <mpc_planner_solver/solver_interface.h>
 
@@ -57,6 +58,7 @@ public:
 
 private:
     std::unique_ptr<Planner> _planner;
+    std::unique_ptr<ReferencePathStream> _path_stream;
     std::unique_ptr<JackalReconfigure> _reconfigure;
 
     RealTimeData _data;
@@ -91,7 +93,6 @@ private:
     void parseObstacle(const derived_object_msgs::Object &object, double object_angle,
                        std::vector<Eigen::Vector2d> &positions_out, std::vector<double> &radii_out);
 
-    bool isPathTheSame(const nav_msgs::Path::ConstPtr &path);
 
     void visualize();
 };
@@ -34,6 +34,8 @@ using namespace MPCPlanner;
 namespace MPCPlanner
 {
     class Planner;
+    class ObstacleIngestion;
+    class ReferencePathStream;
 }
 class JackalPlanner
 {
@@ -63,6 +65,8 @@ public:
 
 private:
     std::unique_ptr<Planner> _planner; // MPC
+    std::unique_ptr<ObstacleIngestion> _obstacle_ingestion;
+    std::unique_ptr<ReferencePathStream> _path_stream;
 
     std::unique_ptr<JackalsimulatorReconfigure> _reconfigure;
 
@@ -100,7 +104,6 @@ private:
     double _x_buffer[CAMERA_BUFFER];
     double _y_buffer[CAMERA_BUFFER];
 
-    bool isPathTheSame(const nav_msgs::Path::ConstPtr &path);
 
     void visualize();
 };
@@ -2,6 +2,8 @@
 #define JACKAL_PLANNER_H
 
 #include <mpc_planner/planner.h>
+#include <mpc_planner/obstacle_ingestion.h>
+#include <mpc_planner/reference_path_stream.h>
 
 #include <mpc_planner_solver/state.h>
 #include <mpc_planner_types/realtime_data.h>
@@ -40,6 +42,8 @@ public:
 
 private:
     std::unique_ptr<Planner> _planner;
+    std::unique_ptr<ObstacleIngestion> _obstacle_ingestion;
+    std::unique_ptr<ReferencePathStream> _path_stream;
 
     RealTimeData _data;
     State _state;
@@ -64,7 +68,6 @@ private:
 
     rclcpp::Client<std_srvs::srv::Empty>::SharedPtr _ped_start_client;
 
-    bool isPathTheSame(nav_msgs::msg::Path::SharedPtr path);
 
     void visualize();
 };
@@ -3,8 +3,11 @@
 #include <mpc_planner/planner.h>
 
 #include <mpc_planner/data_preparation.h>
+#include <mpc_planner/obstacle_ingestion.h>
+#include <mpc_planner/reference_path_stream.h>
 
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 #include <mpc_planner_util/load_yaml.hpp>
 
 #include <ros_tools/visuals.h>
@@ -30,6 +33,8 @@ JackalPlanner::JackalPlanner(ros::NodeHandle &nh)
                                        CONFIG["n_discs"].as<int>());
 
     _planner = std::make_unique<Planner>(); // Initialize the planner
+    _obstacle_ingestion = std::make_unique<ObstacleIngestion>();
+    _path_stream = std::make_unique<ReferencePathStream>();
 
     initializeSubscribersAndPublishers(nh); // Initialize the ROS interface
 
@@ -261,84 +266,20 @@ void JackalPlanner::goalCallback(const geometry_msgs::PoseStamped::ConstPtr &msg
     _data.goal_received = true;
 }
 
-bool JackalPlanner::isPathTheSame(const nav_msgs::Path::ConstPtr &msg)
-{
-    // Check if the path is the same
-    if (_data.reference_path.x.size() != msg->poses.size())
-        return false;
-
-    // Check up to the first two points
-    int num_points = std::min(2, (int)_data.reference_path.x.size());
-    for (int i = 0; i < num_points; i++)
-    {
-        if (!_data.reference_path.pointInPath(i, msg->poses[i].pose.position.x, msg->poses[i].pose.position.y))
-            return false;
-    }
-    return true;
-}
-
 void JackalPlanner::pathCallback(const nav_msgs::Path::ConstPtr &msg)
 {
     LOG_DEBUG("Path callback");
 
-    if (isPathTheSame(msg))
+    if (!_path_stream->update(*msg, _data.reference_path)) // Same path (compares all points)
         return;
 
-    _data.reference_path.clear();
-
-    for (auto &pose : msg->poses)
-    {
-        _data.reference_path.x.push_back(pose.pose.position.x);
-        _data.reference_path.y.push_back(pose.pose.position.y);
-    }
-    _data.reference_path.psi.push_back(0.0);
     _planner->onDataReceived(_data, "reference_path");
 }
 
 void JackalPlanner::obstacleCallback(const mpc_planner_msgs::ObstacleArray::ConstPtr &msg)
 {
-    _data.dynamic_obstacles.clear();
-
-    for (auto &obstacle : msg->obstacles)
-    {
-        // Save the obstacle (ID, position, orientation, radius)
-        _data.dynamic_obstacles.emplace_back(
-            obstacle.id,
-            Eigen::Vector2d(obstacle.pose.position.x, obstacle.pose.position.y),
-            RosTools::quaternionToAngle(obstacle.pose),
-            CONFIG["obstacle_radius"].as<double>());
-        auto &dynamic_obstacle = _data.dynamic_obstacles.back();
-
-        if (obstacle.probabilities.size() == 0) // No Predictions!
-            continue;
-
-        // Save the prediction
-        if (obstacle.probabilities.size() == 1) // One mode
-        {
-            dynamic_obstacle.prediction = Prediction(PredictionType::GAUSSIAN);
-
-            const auto &mode = obstacle.gaussians[0];
-            for (size_t k = 0; k < mode.mean.poses.size(); k++)
-            {
-                // Add prediction at time step k (position, orientation, major/minor bivariate Gaussian size)
-                dynamic_obstacle.prediction.modes[0].emplace_back(
-                    Eigen::Vector2d(mode.mean.poses[k].pose.position.x, mode.mean.poses[k].pose.position.y),
-                    RosTools::quaternionToAngle(mode.mean.poses[k].pose.orientation),
-                    mode.major_semiaxis[k],
-                    mode.minor_semiaxis[k]);
-            }
-
-            if (mode.major_semiaxis.back() == 0. || !CONFIG["probabilistic"]["enable"].as<bool>()) // If uncertainty is zero
-                dynamic_obstacle.prediction.type = PredictionType::DETERMINISTIC;
-            else
-                dynamic_obstacle.prediction.type = PredictionType::GAUSSIAN;
-        }
-        else
-        {
-            ROSTOOLS_ASSERT(false, "Multiple modes not yet supported");
-        }
-    }
-    ensureObstacleSize(_data.dynamic_obstacles, _state); // Ensure that there are `max_obstacles` obstacles (possibly adding dummies)
+    // Convert the obstacles (reusing their storage), keeping `max_obstacles` obstacles (possibly adding dummies)
+    _obstacle_ingestion->ingest(*msg, _state, _data.dynamic_obstacles);
 
     if (CONFIG["probabilistic"]["propagate_uncertainty"].as<bool>())
         propagatePredictionUncertainty(_data.dynamic_obstacles);
@@ -373,6 +314,8 @@ void JackalPlanner::reset(bool success)
     ros::Duration(1.0 / CONFIG["control_frequency"].as<double>()).sleep();
 
     _planner->reset(_state, _data, success); // Reset planner
+    _obstacle_ingestion->reset();
+    _path_stream->reset(); // The planner reset clears the reference path
 
     _timeout_timer.start();
 }
@@ -443,6 +386,7 @@ int main(int argc, char **argv)
     ros::NodeHandle nh;
     auto jackal_planner = std::make_shared<JackalPlanner>(nh);
     VISUALS.init(&nh);
+    startSubscriberMonitorROS1();
 
     ros::spin();
 
@@ -4,6 +4,7 @@
 #include <mpc_planner/data_preparation.h>
 
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 #include <mpc_planner_util/load_yaml.hpp>
 
 #include <ros_tools/visuals.h>
@@ -29,6 +30,8 @@ JackalPlanner::JackalPlanner() : Node("jackal_planner")
 
     // Initialize the planner
     _planner = std::make_unique<Planner>();
+    _obstacle_ingestion = std::make_unique<ObstacleIngestion>();
+    _path_stream = std::make_unique<ReferencePathStream>();
 
     // Initialize the ROS interface
     initializeSubscribersAndPublishers();
@@ -163,65 +166,10 @@ void JackalPlanner::goalCallback(geometry_msgs::msg::PoseStamped::SharedPtr msg)
     _data.goal_received = true;
 }
 
-bool JackalPlanner::isPathTheSame(nav_msgs::msg::Path::SharedPtr msg)
-{
-    // Check if the path is the same
-    if (_data.reference_path.x.size() != msg->poses.size())
-        return false;
-
-    // Check up to the first two points
-    int num_points = std::min(2, (int)_data.reference_path.x.size());
-    for (int i = 0; i < num_points; i++)
-    {
-        if (!_data.reference_path.pointInPath(i, msg->poses[i].pose.position.x, msg->poses[i].pose.position.y))
-            return false;
-    }
-    return true;
-}
-
 void JackalPlanner::obstacleCallback(mpc_planner_msgs::msg::ObstacleArray::SharedPtr msg)
 {
-    _data.dynamic_obstacles.clear();
+    _obstacle_ingestion->ingest(*msg, _state, _data.dynamic_obstacles);
 
-    for (auto &obstacle : msg->obstacles)
-    {
-        // Save the obstacle
-        _data.dynamic_obstacles.emplace_back(
-            obstacle.id,
-            Eigen::Vector2d(obstacle.pose.position.x, obstacle.pose.position.y),
-            RosTools::quaternionToAngle(obstacle.pose),
-            CONFIG["obstacle_radius"].as<double>());
-        auto &dynamic_obstacle = _data.dynamic_obstacles.back();
-
-        if (obstacle.probabilities.size() == 0) // No Predictions!
-            continue;
-
-        // Save the prediction
-        if (obstacle.probabilities.size() == 1) // One mode
-        {
-            dynamic_obstacle.prediction = Prediction(PredictionType::GAUSSIAN);
-
-            const auto &mode = obstacle.gaussians[0];
-            for (size_t k = 0; k < mode.mean.poses.size(); k++)
-            {
-                dynamic_obstacle.prediction.modes[0].emplace_back(
-                    Eigen::Vector2d(mode.mean.poses[k].pose.position.x, mode.mean.poses[k].pose.position.y),
-                    RosTools::quaternionToAngle(mode.mean.poses[k].pose.orientation),
-                    mode.major_semiaxis[k],
-                    mode.minor_semiaxis[k]);
-            }
-
-            if (mode.major_semiaxis.back() == 0. || !CONFIG["probabilistic"]["enable"].as<bool>())
-                dynamic_obstacle.prediction.type = PredictionType::DETERMINISTIC;
-            else
-                dynamic_obstacle.prediction.type = PredictionType::GAUSSIAN;
-        }
-        else
-        {
-            ROSTOOLS_ASSERT(false, "Multiple modes not yet supported");
-        }
-    }
-    ensureObstacleSize(_data.dynamic_obstacles, _state);
     _planner->onDataReceived(_data, "dynamic obstacles");
 }
 
@@ -229,17 +177,9 @@ void JackalPlanner::pathCallback(nav_msgs::msg::Path::SharedPtr msg)
 {
     LOG_DEBUG("Path callback");
 
-    if (isPathTheSame(msg))
+    if (!_path_stream->update(*msg, _data.reference_path)) // Same path (compares all points)
         return;
 
-    _data.reference_path.clear();
-
-    for (auto &pose : msg->poses)
-    {
-        _data.reference_path.x.push_back(pose.pose.position.x);
-        _data.reference_path.y.push_back(pose.pose.position.y);
-    }
-    _data.reference_path.psi.push_back(0.0);
     _planner->onDataReceived(_data, "reference_path");
 }
 
@@ -259,6 +199,8 @@ int main(int argc, char **argv)
 
     auto jackal_planner = std::make_shared<JackalPlanner>();
     VISUALS.init(jackal_planner.get());
+    setVisualizationSubscriberCheck([node = jackal_planner.get()](const std::string &topic_name)
+                                    { return node->count_subscribers("~/" + topic_name) > 0; });
 
     rclcpp::spin(jackal_planner);
 
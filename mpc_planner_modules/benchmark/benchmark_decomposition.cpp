@@ -0,0 +1,95 @@
+#include <decomp_util/ellipsoid_decomp.h>
+
+#include <mpc_planner_util/obstacle_downsampling.h>
+#include <mpc_planner_util/occupancy_tracker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// 10 x 10 m with rows of 0.6 m deep shelves, walls and a few small obstacles
+void createMap(double resolution, std::vector<unsigned char> &map, int &size)
+{
+    size = std::round(10. / resolution);
+    map.assign(size * size, 0);
+
+    auto fill = [&](double min_x, double min_y, double max_x, double max_y)
+    {
+        for (int y = std::max((int)(min_y / resolution), 0); y < std::min((int)(max_y / resolution), size); y++)
+        {
+            for (int x = std::max((int)(min_x / resolution), 0); x < std::min((int)(max_x / resolution), size); x++)
+                map[y * size + x] = 254;
+        }
+    };
+
+    fill(0., 0., 10., 0.2);
+    fill(0., 9.8, 10., 10.);
+    for (double y = 1.5; y < 9.; y += 2.)
+        fill(1., y, 9., y + 0.6);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> position(0., 10.);
+    for (int i = 0; i < 20; i++)
+    {
+        double x = position(generator), y = position(generator);
+        fill(x, y, x + 0.15, y + 0.15);
+    }
+}
+
+// Times EllipsoidDecomp2D::dilate on the obstacle points of DecompConstraints (see benchmark_obstacle_downsampling)
+int main()
+{
+    const int repetitions = 10;
+
+    // Through the aisle between the first two rows of shelves
+    vec_Vec2f path;
+    for (double x = 0.5; x <= 9.5; x += 1.)
+        path.push_back(Vec2f(x, 3.1 + 0.1 * std::sin(x)));
+
+    std::vector<unsigned char> map;
+    int size;
+
+    for (double resolution : {0.025, 0.05, 0.1})
+    {
+        createMap(resolution, map, size);
+
+        OccupancyTracker tracker;
+        tracker.update(map.data(), size, size, 0., 0., resolution);
+
+        for (auto setting : std::vector<std::pair<double, bool>>{{0., false}, {0., true}, {0.1, true}, {0.2, true}})
+        {
+            ObstacleDownsampling downsampling(setting.first, setting.second);
+            downsampling.apply(tracker.getOccupied(), map.data(), size, size, 0., 0., resolution);
+
+            const auto &points = downsampling.getPoints();
+            vec_Vec2f obstacles(points.begin(), points.end());
+
+            EllipsoidDecomp2D decomp;
+            decomp.set_local_bbox(Vec2f(3., 3.));
+            decomp.set_obs(obstacles);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < repetitions; i++)
+            {
+#ifdef DECOMP_OLD
+                decomp.dilate(path, 0, false);
+#else
+                decomp.dilate(path, 0);
+#endif
+            }
+            double time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repetitions;
+
+            std::cout << "Resolution " << 100. * resolution << " cm, "
+                      << (setting.second ? "boundary only" : "all cells") << ", tolerance " << setting.first << " m: "
+                      << obstacles.size() << " points, " << decomp.get_polyhedrons().size() << " polyhedra, dilate in "
+                      << 1e3 * time << " ms" << std::endl;
+        }
+    }
+
+    return 0;
+}
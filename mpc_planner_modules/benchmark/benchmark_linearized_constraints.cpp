@@ -0,0 +1,98 @@
+#include <mpc_planner_modules/linearized_constraints.h>
+
+#include <mpc_planner_solver/solver_interface.h>
+#include <mpc_planner_solver/state.h>
+
+#include <mpc_planner_types/module_data.h>
+#include <mpc_planner_types/realtime_data.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Obstacles moving at a constant velocity in a 30 x 30 m area
+std::vector<DynamicObstacle> createObstacles(int num_obstacles, int N, double dt)
+{
+    std::mt19937 generator(num_obstacles);
+    std::uniform_real_distribution<double> position(-15., 15.);
+    std::uniform_real_distribution<double> velocity(-1., 1.);
+
+    std::vector<DynamicObstacle> obstacles;
+    for (int i = 0; i < num_obstacles; i++)
+    {
+        Eigen::Vector2d start(position(generator), position(generator));
+        Eigen::Vector2d direction(velocity(generator), velocity(generator));
+
+        obstacles.emplace_back(i, start, 0., 0.4);
+        obstacles.back().prediction = Prediction(PredictionType::DETERMINISTIC);
+        obstacles.back().prediction.modes.emplace_back();
+        for (int k = 0; k < N; k++)
+            obstacles.back().prediction.modes[0].emplace_back(start + direction * (k + 1) * dt, 0., 0., 0.);
+    }
+
+    return obstacles;
+}
+
+// Times LinearizedConstraints::update: screening, safety projection and halfspaces for all stages
+int main()
+{
+    std::string path = std::filesystem::path(__FILE__).parent_path().string() + "/../../mpc_planner_jackal/src/src";
+    path = SYSTEM_CONFIG_PATH(path, "settings");
+    Configuration::getInstance().initialize(path);
+    MUTABLE_CONFIG["debug_output"] = false;
+
+    const int cycles = 100;
+
+    for (int num_obstacles : {12, 50})
+    {
+        for (bool reuse : {false, true})
+        {
+            MUTABLE_CONFIG["max_obstacles"] = num_obstacles;
+            MUTABLE_CONFIG["linearized_constraints"]["reuse_halfspaces"] = reuse;
+
+            auto solver = std::make_shared<Solver>();
+            LinearizedConstraints module(solver);
+
+            // The robot drives through the middle
+            for (int k = 0; k < solver->N; k++)
+            {
+                solver->setEgoPrediction(k, "x", -15. + 30. * k / (double)solver->N);
+                solver->setEgoPrediction(k, "y", 0.5 * std::sin(0.3 * k));
+            }
+
+            RealTimeData data;
+            data.robot_area = {Disc(0., CONFIG["robot_radius"].as<double>())};
+            data.dynamic_obstacles = createObstacles(num_obstacles, solver->N, solver->dt);
+
+            State state;
+            ModuleData module_data;
+
+            double time = 0.;
+            for (int cycle = 0; cycle < cycles; cycle++)
+            {
+                // Small changes between cycles, as with a new prediction
+                for (auto &obstacle : data.dynamic_obstacles)
+                {
+                    for (auto &step : obstacle.prediction.modes[0])
+                        step.position(0) += 0.01;
+                }
+
+                auto start = std::chrono::high_resolution_clock::now();
+                module.update(state, data, module_data);
+                time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            }
+
+            std::cout << "LinearizedConstraints::update with " << num_obstacles << " obstacles (N = " << solver->N
+                      << (reuse ? ", reusing halfspaces" : "") << "): " << 1e6 * time / cycles << " us" << std::endl;
+        }
+    }
+
+    return 0;
+}
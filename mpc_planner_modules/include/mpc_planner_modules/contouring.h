@@ -3,6 +3,9 @@
 
 #include <mpc_planner_modules/controller_module.h>
 
+#include <mpc_planner_util/closest_point_search.h>
+#include <mpc_planner_util/path_lookup_table.h>
+
 #include <ros_tools/spline.h>
 
 namespace MPCPlanner
@@ -29,6 +32,12 @@ namespace MPCPlanner
     std::shared_ptr<RosTools::Spline2D> _spline{nullptr};
     std::unique_ptr<RosTools::Spline2D> _bound_left{nullptr}, _bound_right{nullptr};
 
+    // Sampled versions of the splines above, used when constructing constraints
+    std::shared_ptr<PathLookupTable> _path_table{nullptr};
+    std::unique_ptr<PathLookupTable> _bound_left_table{nullptr}, _bound_right_table{nullptr};
+    double _path_table_resolution;
+
+    ClosestPointSearch _closest_point_search;
     int _closest_segment{0};
     int _n_segments;
 
@@ -38,6 +47,16 @@ namespace MPCPlanner
     void constructRoadConstraintsFromCenterline(const RealTimeData &data, ModuleData &module_data);
     void constructRoadConstraintsFromBounds(const RealTimeData &data, ModuleData &module_data);
 
+    /** @brief Spline coefficients of the tracked segments, identical for all stages */
+    struct SegmentParameters
+    {
+      double ax, bx, cx, dx;
+      double ay, by, cy, dy;
+      double start;
+    };
+    std::vector<SegmentParameters> _segment_parameters;
+
+    void computeSplineParameters();
     void setSplineParameters(int k);
 
     void visualizeReferencePath(const RealTimeData &data, const ModuleData &module_data);
@@ -28,6 +28,16 @@ namespace MPCPlanner
   private:
     int _num_segments;
 
+    /** @brief Width spline coefficients of the tracked segments, identical for all stages */
+    struct SegmentParameters
+    {
+      double ra, rb, rc, rd;
+      double la, lb, lc, ld;
+    };
+    std::vector<SegmentParameters> _segment_parameters;
+
+    void computeWidthParameters(const ModuleData &module_data);
+
     std::shared_ptr<tk::spline> _width_left{nullptr}, _width_right{nullptr};
   };
 }
@@ -2,11 +2,14 @@
 #define __DECOMP_CONSTRAINTS_H_
 
 #include <mpc_planner_modules/controller_module.h>
+#include <mpc_planner_modules/polyhedron_cache.h>
 
 #include <decomp_util/ellipsoid_decomp.h>
 #include <decomp_util/decomp_geometry/geometric_utils.h>
 
-#include <ros_tools/projection.h>
+#include <mpc_planner_util/obstacle_downsampling.h>
+#include <mpc_planner_util/occupancy_tracker.h>
+#include <mpc_planner_util/safety_projection.h>
 
 namespace MPCPlanner
 {
@@ -26,23 +29,35 @@ namespace MPCPlanner
   private:
     std::vector<std::vector<Eigen::ArrayXd>> _a1, _a2, _b; // Constraints [disc x step]
 
-    std::unique_ptr<EllipsoidDecomp2D> _decomp_util;
+    Vec2f _local_bbox;
     vec_Vec2f _occ_pos;
+    OccupancyTracker _occupancy; // Occupied cells of the costmap, updated incrementally
+    std::vector<int> _row_begin, _row_end; // Cells around the path per costmap row
+    ObstacleDownsampling _downsampling;
     std::vector<LinearConstraint<2>> _constraints; // Static 2D halfspace constraints set in DecompUtil
     vec_E<Polyhedron<2>> _polyhedrons;
+
+    PolyhedronCache _polyhedron_cache; // Polyhedra of the previous cycle, reused when they still contain the segment
+    std::vector<bool> _segment_reused;
+    int _num_reused{0};
+
     std::vector<std::unique_ptr<vec_Vec2f>> occ_pos_vec_stages_;
 
     double _dummy_a1{1.}, _dummy_a2{0.}, _dummy_b;
 
     int _n_discs;
 
-    DouglasRachford dr_projection_;
+    SafetyProjection _projection{1};
 
     int _max_constraints;
+    double _range;
+    int _num_threads; // Of the decomposition
 
-    bool getOccupiedGridCells(const RealTimeData &data);
+    bool getOccupiedGridCells(const RealTimeData &data, const vec_Vec2f &path);
+    void decompose(const vec_Vec2f &path);
+    void setScanRegion(const costmap_2d::Costmap2D &costmap, const vec_Vec2f &path);
 
-    void projectToSafety(Eigen::Vector2d &pos);
+    void projectToSafety(const costmap_2d::Costmap2D &costmap, Eigen::Vector2d &pos);
   };
 } // namespace MPCPlanner
 #endif // __DECOMP_CONSTRAINTS_H_
@@ -0,0 +1,39 @@
+#ifndef __DISTANCE_FIELD_CONSTRAINTS_H_
+#define __DISTANCE_FIELD_CONSTRAINTS_H_
+
+#include <mpc_planner_modules/controller_module.h>
+
+#include <mpc_planner_util/distance_field.h>
+
+namespace MPCPlanner
+{
+  /**
+   * @brief Static obstacle constraints from the distance field of the costmap (alternative to DecompConstraints)
+   *
+   * Per stage and disc, the distance field is linearized at the warm start: the halfspace is tangent to the closest
+   * obstacle, with its normal along the gradient of the distance.
+   */
+  class DistanceFieldConstraints : public ControllerModule
+  {
+  public:
+    DistanceFieldConstraints(std::shared_ptr<Solver> solver);
+
+  public:
+    void update(State &state, const RealTimeData &data, ModuleData &module_data) override;
+    void setParameters(const RealTimeData &data, const ModuleData &module_data, int k) override;
+
+    bool isDataReady(const RealTimeData &data, std::string &missing_data) override;
+
+    void visualize(const RealTimeData &data, const ModuleData &module_data) override;
+
+  private:
+    DistanceField _field;
+
+    std::vector<std::vector<double>> _a1, _a2, _b; // Constraints [disc x step]
+
+    double _dummy_a1{1.}, _dummy_a2{0.}, _dummy_b;
+
+    int _n_discs;
+  };
+} // namespace MPCPlanner
+#endif // __DISTANCE_FIELD_CONSTRAINTS_H_
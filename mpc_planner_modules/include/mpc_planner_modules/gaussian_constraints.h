@@ -3,6 +3,9 @@
 
 #include <mpc_planner_modules/controller_module.h>
 
+#include <mpc_planner_util/chance_constraint_block.h>
+#include <mpc_planner_util/obstacle_screening.h>
+
 namespace MPCPlanner
 {
   class GaussianConstraints : public ControllerModule
@@ -19,6 +22,17 @@ namespace MPCPlanner
     void visualize(const RealTimeData &data, const ModuleData &module_data) override;
 
   private:
+    double _robot_radius, _obstacle_radius, _risk;
+    int _n_discs;
+
+    double _dummy_x{50.}, _dummy_y{50.};
+
+    ObstacleScreening _screening;
+    std::vector<Eigen::Vector2d> _ego_positions;
+
+    ChanceConstraintBlock _block; // Parameters of this cycle [stage x slot]
+
+    void setDummy(int k, int slot);
   };
 }
 #endif // __GAUSSIAN_CONSTRAINTS_H_
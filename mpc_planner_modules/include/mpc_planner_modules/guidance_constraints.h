@@ -19,11 +19,22 @@
 #include <mpc_planner_modules/controller_module.h>
 #include <mpc_planner_solver/solver_interface.h>
 
+#include <mpc_planner_util/planner_scoreboard.h>
+#include <mpc_planner_util/thread_pool.h>
+
+#include <ros_tools/spline.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace GuidancePlanner
 {
     class GlobalGuidance;
+    class Obstacle;
 }
 
 namespace MPCPlanner
@@ -49,6 +60,25 @@ namespace MPCPlanner
         }
     };
 
+    /** @brief Guidance trajectories found by one guidance search */
+    struct GuidanceSnapshot
+    {
+        struct Trajectory
+        {
+            int topology_class;
+            int color;
+            bool previously_selected;
+            RosTools::Spline2D spline; // Over time, starting at the stamp
+        };
+
+        int version{0};
+        std::chrono::system_clock::time_point stamp; // Planning start time of the cycle that set the start of the search
+        bool succeeded{false};
+        double runtime{0.};
+
+        std::vector<Trajectory> trajectories;
+    };
+
     /**
      * @brief Homotopy Guidance controller module extends from the reference path ControlModule to implement MPCC over the
      * trajectory but starting from the robot
@@ -57,6 +87,7 @@ namespace MPCPlanner
     {
     public:
         GuidanceConstraints(std::shared_ptr<Solver> solver);
+        ~GuidanceConstraints();
 
     public:
         void update(State &state, const RealTimeData &data, ModuleData &module_data) override;
@@ -97,15 +128,31 @@ namespace MPCPlanner
             bool taken = false;
             bool existing_guidance = false;
 
+            double solve_time = 0.; // Time of this planner in the last cycle [s]
+
             LocalPlanner(int _id, bool _is_original_planner = false);
         };
 
         void setGoals(State &state, const ModuleData &module_data);
         void mapGuidanceTrajectoriesToPlanners();
-        void initializeSolverWithGuidance(LocalPlanner &planner);
+
+        /** @brief Draw the guidance trajectories of a snapshot (when the search runs on the guidance thread) */
+        void visualizeGuidanceSnapshot(const GuidanceSnapshot &snapshot);
+
+        /** @brief Pass an input to the guidance planner, directly or before the next search of the guidance thread.
+         * Only the latest input with each name is kept. */
+        void setGuidanceInput(const std::string &name, std::function<void()> &&input);
+        void searchGuidance(); // Runs the guidance search and publishes a snapshot
+        void runGuidanceThread();
+        int numGuidanceTrajectories() const { return _guidance == nullptr ? 0 : _guidance->trajectories.size(); }
+        void initializeSolverWithGuidance(LocalPlanner &planner, double time_offset); // Offset [s] of this cycle to the guidance
 
         int FindBestPlanner();
 
+        /** @brief Number of guided planners that fit in the remaining planning time */
+        int numGuidedPlanners(const RealTimeData &data) const;
+        void logCycleTime(double cycle_time);
+
     private: // Member variables
         std::vector<LocalPlanner> planners_;
 
@@ -113,12 +160,45 @@ namespace MPCPlanner
 
         std::unordered_map<int, int> _map_homotopy_class_to_planner;
 
+        // Multi-rate guidance: the search runs on its own thread and publishes snapshots
+        double _guidance_rate{0.}; // [Hz] (0 = search in every control cycle)
+        bool _highlight_selected{true};
+        std::shared_ptr<GuidanceSnapshot> _guidance;        // Used in this control cycle
+        std::shared_ptr<GuidanceSnapshot> _latest_guidance; // Latest published snapshot
+        int _guidance_version{0};
+        std::chrono::system_clock::time_point _start_stamp;
+        bool _has_start{false};
+
+        std::thread _guidance_thread;
+        std::mutex _guidance_mutex; // Guards the published snapshot and the pending inputs
+        std::mutex _search_mutex;   // Guards the guidance planner
+        std::condition_variable _guidance_cv;
+        bool _stop_guidance{false};
+        std::vector<std::pair<std::string, std::function<void()>>> _pending_inputs;
+
         // Configuration parameters
         bool _use_tmpcpp{true}, _enable_constraints{true};
         double _control_frequency{20.};
         double _planning_time;
 
-        RealTimeData empty_data_;
+        const std::vector<DynamicObstacle> _no_obstacles; // For the planners without guidance
+
+        // Double buffer of the obstacles passed to the guidance planner, overwritten in place
+        std::vector<GuidancePlanner::Obstacle> _obstacle_buffers[2];
+        int _obstacles_ready{-1};   // Buffer with obstacles that were not loaded yet (guarded by _guidance_mutex)
+        int _obstacles_loading{-1}; // Buffer that the guidance planner is loading (guarded by _guidance_mutex)
+
+        std::unique_ptr<ThreadPool> _pool; // Runs the planners in parallel
+        std::vector<int> _active_planners;
+
+        bool _adaptive_planner_count{false};
+        double _solve_time_estimate{0.}; // Moving average of the time per planner [s]
+
+        bool _racing{false};
+        std::unique_ptr<PlannerScoreboard> _scoreboard; // Cancels planners that exceed their time share
+
+        std::vector<double> _cycle_times; // Of the last cycles [s]
+        size_t _cycle_index{0};
 
         int best_planner_index_ = -1;
     };
@@ -3,7 +3,9 @@
 
 #include <mpc_planner_modules/controller_module.h>
 
-#include <ros_tools/projection.h>
+#include <mpc_planner_util/halfspace_tensor.h>
+#include <mpc_planner_util/obstacle_screening.h>
+#include <mpc_planner_util/safety_projection.h>
 
 namespace MPCPlanner
 {
@@ -22,20 +24,53 @@ namespace MPCPlanner
 
     void setTopologyConstraints();
 
+    /** @brief Constrain these obstacles instead of the obstacles in the real-time data (not copied, nullptr = real-time data) */
+    void setObstacles(const std::vector<DynamicObstacle> *obstacles) { _obstacles = obstacles; }
+
   private:
-    std::vector<std::vector<Eigen::ArrayXd>> _a1, _a2, _b; // Constraints [disc x step]
+    HalfspaceTensor _halfspaces; // Constraints [disc x step x constraint]
+
+    std::vector<double> _obstacle_x, _obstacle_y, _obstacle_offset; // Obstacles at the current stage
 
     double _dummy_a1{1.}, _dummy_a2{0.}, _dummy_b;
 
     bool _use_guidance{false};
+    const std::vector<DynamicObstacle> *_obstacles{nullptr};
     int _n_discs;
     int _n_other_halfspaces;
 
-    DouglasRachford dr_projection_;
+    SafetyProjection _projection;
+
+    ObstacleScreening _screening;
+    std::vector<Eigen::Vector2d> _ego_positions;
 
     int _num_obstacles, _max_obstacles;
 
-    void projectToSafety(const std::vector<DynamicObstacle> &copied_obstacles, int k, Eigen::Vector2d &pos);
+    // Reuse of the halfspaces of the previous cycle, per obstacle ID (linearized_constraints/reuse_halfspaces)
+    struct CachedHalfspace
+    {
+      Eigen::Vector2d ego_pos, obstacle_pos; // Where the normal was computed
+      double a1, a2;
+      bool valid{false};
+    };
+
+    bool _reuse_halfspaces;
+    double _reuse_tolerance;
+
+    std::vector<CachedHalfspace> _cache, _prev_cache; // [disc x step x obstacle]
+    std::vector<int> _ids, _prev_ids;                  // Obstacle ID per slot
+    std::vector<int> _prev_slot;                       // Slot of each obstacle in the previous cycle (-1 if new)
+
+    std::vector<int> _recompute; // Obstacles of the current stage without a reusable halfspace
+    std::vector<double> _recompute_x, _recompute_y, _recompute_offset, _recompute_a1, _recompute_a2, _recompute_b;
+
+    int _num_reused{0}, _num_computed{0};
+
+    void computeHalfspaces(int d, int k, const Eigen::Vector2d &pos);
+    void reuseHalfspaces(int d, int k, const Eigen::Vector2d &pos);
+
+    const CachedHalfspace *findCachedHalfspace(int d, int k, int obs_id, const Eigen::Vector2d &pos) const;
+    int cacheIndex(int d, int k, int obs_id) const { return (d * _solver->N + k) * _max_obstacles + obs_id; }
   };
 } // namespace MPCPlanner
 #endif // __LINEARIZED_CONSTRAINTS_H_
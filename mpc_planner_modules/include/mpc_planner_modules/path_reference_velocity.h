@@ -14,6 +14,8 @@
 
 #include <mpc_planner_modules/controller_module.h>
 
+#include <mpc_planner_util/velocity_profile.h>
+
 namespace tk
 {
   class spline;
@@ -38,6 +40,19 @@ namespace MPCPlanner
   private:
     std::shared_ptr<tk::spline> _velocity_spline;
     int _n_segments;
+
+    /** @brief Computes the reference for paths without velocities (velocity_profile/enable) */
+    std::unique_ptr<VelocityProfile> _velocity_profile;
+    std::vector<double> _path_s; // Distances along paths without s-coordinates
+
+    /** @brief Velocity spline coefficients of the tracked segments (v = d for a constant reference) */
+    struct SegmentParameters
+    {
+      double a, b, c, d;
+    };
+    std::vector<SegmentParameters> _segment_parameters;
+
+    void computeVelocityParameters(const RealTimeData &data, const ModuleData &module_data, double reference_velocity);
   };
 }
 
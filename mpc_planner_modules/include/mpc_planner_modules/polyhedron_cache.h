@@ -0,0 +1,58 @@
+#ifndef __POLYHEDRON_CACHE_H_
+#define __POLYHEDRON_CACHE_H_
+
+#include <decomp_util/decomp_geometry/polyhedron.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace MPCPlanner
+{
+  /**
+   * @brief Polyhedra of the previous cycle, reused for the segments of a path that shifted forward
+   *
+   * A polyhedron is reused for a segment if it contains both ends of the segment and no obstacle point was added
+   * within the local bounding box of the segment it was computed for. The added points are bucketed in a grid with
+   * cells of the size of that box, such that the check only visits the points around the segment.
+   */
+  class PolyhedronCache
+  {
+  public:
+    /** @param margin Covers the local bounding box of a segment in any direction [m] */
+    PolyhedronCache(double margin);
+
+  public:
+    /** @brief Copy the reusable polyhedra of the previous cycle to the segments of @p path, marks them in @p reused */
+    void findReusable(const vec_Vec2f &path, const std::vector<Eigen::Vector2d> &added,
+                      vec_E<Polyhedron<2>> &polyhedrons, std::vector<bool> &reused);
+
+    /** @brief Store the polyhedra of this cycle */
+    void store(const vec_Vec2f &path, const vec_E<Polyhedron<2>> &polyhedrons);
+
+    void clear(); // Nothing is reused in the next cycle (e.g., after the obstacles were rebuilt)
+
+  private:
+    struct Cell
+    {
+      int x, y;
+      int point;
+
+      bool operator<(const Cell &other) const { return x < other.x || (x == other.x && y < other.y); }
+    };
+
+    double _margin, _inv_cell_size;
+
+    vec_E<Polyhedron<2>> _polyhedrons;
+    vec_Vec2f _path;
+
+    std::vector<Cell> _cells; // Of the added points, sorted
+    std::vector<Eigen::Vector2d> _points;
+
+    void bucket(const std::vector<Eigen::Vector2d> &added);
+    bool pointsAdded(const Vec2f &start, const Vec2f &end) const; // Around the segment
+
+    int cellIndex(double coordinate) const;
+  };
+} // namespace MPCPlanner
+#endif // __POLYHEDRON_CACHE_H_
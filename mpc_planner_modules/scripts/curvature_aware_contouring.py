@@ -31,17 +31,17 @@ class CurvatureAwareContouringObjective:
         params.add("terminal_contouring", add_to_rqt_reconfigure=True)
 
         for i in range(self.num_segments):
-            params.add(f"spline_x{i}_a", bundle_name="spline_x_a")
-            params.add(f"spline_x{i}_b", bundle_name="spline_x_b")
-            params.add(f"spline_x{i}_c", bundle_name="spline_x_c")
-            params.add(f"spline_x{i}_d", bundle_name="spline_x_d")
+            params.add(f"spline_x{i}_a", bundle_name="spline_x_a", stage_invariant=True)
+            params.add(f"spline_x{i}_b", bundle_name="spline_x_b", stage_invariant=True)
+            params.add(f"spline_x{i}_c", bundle_name="spline_x_c", stage_invariant=True)
+            params.add(f"spline_x{i}_d", bundle_name="spline_x_d", stage_invariant=True)
 
-            params.add(f"spline_y{i}_a", bundle_name="spline_y_a")
-            params.add(f"spline_y{i}_b", bundle_name="spline_y_b")
-            params.add(f"spline_y{i}_c", bundle_name="spline_y_c")
-            params.add(f"spline_y{i}_d", bundle_name="spline_y_d")
+            params.add(f"spline_y{i}_a", bundle_name="spline_y_a", stage_invariant=True)
+            params.add(f"spline_y{i}_b", bundle_name="spline_y_b", stage_invariant=True)
+            params.add(f"spline_y{i}_c", bundle_name="spline_y_c", stage_invariant=True)
+            params.add(f"spline_y{i}_d", bundle_name="spline_y_d", stage_invariant=True)
 
-            params.add(f"spline{i}_start", bundle_name="spline_start")
+            params.add(f"spline{i}_start", bundle_name="spline_start", stage_invariant=True)
 
         return params
 
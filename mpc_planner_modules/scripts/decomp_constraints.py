@@ -23,6 +23,7 @@ class DecompConstraintModule(ConstraintModule):
         self.import_name = "decomp_constraints.h"
 
         self.dependencies.append("decomp_util")
+        self.sources.append("polyhedron_cache.h")
 
         self.constraints.append(
             LinearConstraints(n_discs=settings["n_discs"], max_constraints=settings["decomp"]["max_constraints"], use_slack=True)
@@ -43,7 +44,7 @@ class LinearConstraints:
     def define_parameters(self, params):
 
         for disc_id in range(self.n_discs):
-            params.add(f"ego_disc_{disc_id}_offset", bundle_name="ego_disc_offset")
+            params.add(f"ego_disc_{disc_id}_offset", bundle_name="ego_disc_offset", stage_invariant=True)
 
             for index in range(self.max_constraints):
                 params.add(self.constraint_name(index, disc_id) + "_a1", bundle_name="decomp_a1")
@@ -34,10 +34,10 @@ class EllipsoidConstraint:
         self.nh = max_obstacles * n_discs
 
     def define_parameters(self, params):
-        params.add("ego_disc_radius")
+        params.add("ego_disc_radius", stage_invariant=True)
 
         for disc_id in range(self.n_discs):
-            params.add(f"ego_disc_{disc_id}_offset", bundle_name="ego_disc_offset")
+            params.add(f"ego_disc_{disc_id}_offset", bundle_name="ego_disc_offset", stage_invariant=True)
 
         for obs_id in range(self.max_obstacles):
             params.add(f"ellipsoid_obst_{obs_id}_x", bundle_name="ellipsoid_obst_x")
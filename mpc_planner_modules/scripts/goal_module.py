@@ -16,8 +16,8 @@ class GoalObjective(Objective):
 
     def define_parameters(self, params):
         params.add("goal_weight", add_to_rqt_reconfigure=True, rqt_config_name=lambda p: f'["weights"]["goal"]')
-        params.add("goal_x")
-        params.add("goal_y")
+        params.add("goal_x", stage_invariant=True)
+        params.add("goal_y", stage_invariant=True)
 
     def get_value(self, model, params, settings, stage_idx):
         cost = 0
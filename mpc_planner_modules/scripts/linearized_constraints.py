@@ -40,7 +40,7 @@ class LinearConstraints:
     def define_parameters(self, params):
 
         for disc_id in range(self.n_discs):
-            params.add(f"ego_disc_{disc_id}_offset", bundle_name="ego_disc_offset")
+            params.add(f"ego_disc_{disc_id}_offset", bundle_name="ego_disc_offset", stage_invariant=True)
 
             for index in range(self.max_obstacles):
                 params.add(self.constraint_name(index, disc_id) + "_a1", bundle_name="lin_constraint_a1")
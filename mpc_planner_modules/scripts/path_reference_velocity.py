@@ -19,10 +19,10 @@ class PathReferenceVelocityObjective:
     def define_parameters(self, params):
 
         for i in range(self.num_segments):
-            params.add(f"spline_v{i}_a", bundle_name="spline_v_a")
-            params.add(f"spline_v{i}_b", bundle_name="spline_v_b")
-            params.add(f"spline_v{i}_c", bundle_name="spline_v_c")
-            params.add(f"spline_v{i}_d", bundle_name="spline_v_d")
+            params.add(f"spline_v{i}_a", bundle_name="spline_v_a", stage_invariant=True)
+            params.add(f"spline_v{i}_b", bundle_name="spline_v_b", stage_invariant=True)
+            params.add(f"spline_v{i}_c", bundle_name="spline_v_c", stage_invariant=True)
+            params.add(f"spline_v{i}_d", bundle_name="spline_v_d", stage_invariant=True)
 
         return params
 
@@ -39,7 +39,7 @@ class LinearConstraints:
     def define_parameters(self, params):
 
         for disc_id in range(self.n_discs):
-            params.add(f"ego_disc_{disc_id}_offset")
+            params.add(f"ego_disc_{disc_id}_offset", stage_invariant=True)
 
             for index in range(self.n_constraints):
                 params.add(self.constraint_name(index, disc_id) + "_a1")
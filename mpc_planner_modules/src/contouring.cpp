@@ -21,6 +21,12 @@ namespace MPCPlanner
     _add_road_constraints = CONFIG["contouring"]["add_road_constraints"].as<bool>();
     _two_way_road = CONFIG["road"]["two_way"].as<bool>();
     _dynamic_velocity_reference = CONFIG["contouring"]["dynamic_velocity_reference"].as<bool>();
+    _path_table_resolution = CONFIG["contouring"]["path_table_resolution"].as<double>();
+
+    _closest_point_search = ClosestPointSearch(CONFIG["contouring"]["closest_point"]["window_behind"].as<int>(),
+                                               CONFIG["contouring"]["closest_point"]["window_ahead"].as<int>(),
+                                               CONFIG["contouring"]["closest_point"]["newton_iterations"].as<int>(),
+                                               CONFIG["contouring"]["closest_point"]["jump_distance"].as<double>());
 
     LOG_INITIALIZED();
   }
@@ -32,17 +38,23 @@ namespace MPCPlanner
 
     LOG_DEBUG("contouring::update()");
 
-    // Update the closest point
+    // Update the closest point (searches near the previous closest point)
     double closest_s;
-    _spline->findClosestPoint(state.getPos(), _closest_segment, closest_s);
+    _closest_point_search.findClosestPoint(state.getPos(), _closest_segment, closest_s);
 
-    if (module_data.path.get() == nullptr && _spline.get() != nullptr)
+    // Share the (latest) path and its lookup table with other modules
+    if (module_data.path != _spline)
+    {
       module_data.path = _spline;
+      module_data.path_table = _path_table;
+    }
 
     state.set("spline", closest_s); // We need to initialize the spline state here
 
     module_data.current_path_segment = _closest_segment;
 
+    computeSplineParameters(); // Once per cycle, these are the same for all stages
+
     if (_add_road_constraints)
       constructRoadConstraints(data, module_data);
   }
@@ -52,74 +64,61 @@ namespace MPCPlanner
     (void)data;
     (void)module_data;
 
-    // Retrieve weights once
-    static double contouring_weight, lag_weight, reference_velocity, velocity_weight;
-    static double terminal_angle_weight, terminal_contouring_weight;
-    if (k == 0)
-    {
-      contouring_weight = CONFIG["weights"]["contour"].as<double>();
-      lag_weight = CONFIG["weights"]["lag"].as<double>();
+    // The weights and the spline window are stage invariant, set once in the stage template
+    if (k != 0)
+      return;
 
-      terminal_angle_weight = CONFIG["weights"]["terminal_angle"].as<double>();
-      terminal_contouring_weight = CONFIG["weights"]["terminal_contouring"].as<double>();
+    setSolverParameterContour(k, _solver->_params, CONFIG["weights"]["contour"].as<double>());
+    setSolverParameterLag(k, _solver->_params, CONFIG["weights"]["lag"].as<double>());
 
-      if (_dynamic_velocity_reference)
-      {
-        reference_velocity = CONFIG["weights"]["reference_velocity"].as<double>();
-        velocity_weight = CONFIG["weights"]["velocity"].as<double>();
-      }
-      else
-      {
-        (void)velocity_weight;
-      }
-    }
+    setSolverParameterTerminalAngle(k, _solver->_params, CONFIG["weights"]["terminal_angle"].as<double>());
+    setSolverParameterTerminalContouring(k, _solver->_params, CONFIG["weights"]["terminal_contouring"].as<double>());
 
+    if (_dynamic_velocity_reference)
     {
-      setSolverParameterContour(k, _solver->_params, contouring_weight);
-      setSolverParameterLag(k, _solver->_params, lag_weight);
-
-      setSolverParameterTerminalAngle(k, _solver->_params, terminal_angle_weight);
-      setSolverParameterTerminalContouring(k, _solver->_params, terminal_contouring_weight);
-
-      if (_dynamic_velocity_reference)
-      {
-        setSolverParameterVelocity(k, _solver->_params, velocity_weight);
-        setSolverParameterReferenceVelocity(k, _solver->_params, reference_velocity);
-      }
+      setSolverParameterVelocity(k, _solver->_params, CONFIG["weights"]["velocity"].as<double>());
+      setSolverParameterReferenceVelocity(k, _solver->_params, CONFIG["weights"]["reference_velocity"].as<double>());
     }
 
     setSplineParameters(k);
   }
 
-  void Contouring::setSplineParameters(int k)
+  void Contouring::computeSplineParameters()
   {
-    double ax, bx, cx, dx;
-    double ay, by, cy, dy;
-    double start;
+    _segment_parameters.resize(_n_segments);
 
     for (int i = 0; i < _n_segments; i++)
     {
       int index = _closest_segment + i;
+      auto &segment = _segment_parameters[i];
 
       _spline->getParameters(index,
-                             ax, bx, cx, dx,
-                             ay, by, cy, dy);
+                             segment.ax, segment.bx, segment.cx, segment.dx,
+                             segment.ay, segment.by, segment.cy, segment.dy);
 
-      start = _spline->getSegmentStart(index);
+      segment.start = _spline->getSegmentStart(index); // Distance where this spline starts
+    }
+  }
+
+  void Contouring::setSplineParameters(int k)
+  {
+    // The spline window of this cycle (stage invariant, k = 0 is the stage template)
+    for (int i = 0; i < _n_segments; i++)
+    {
+      const auto &segment = _segment_parameters[i];
 
       /** @note: We use the fast loading interface here as we need to load many parameters */
-      setSolverParameterSplineXA(k, _solver->_params, ax, i);
-      setSolverParameterSplineXB(k, _solver->_params, bx, i);
-      setSolverParameterSplineXC(k, _solver->_params, cx, i);
-      setSolverParameterSplineXD(k, _solver->_params, dx, i);
-
-      setSolverParameterSplineYA(k, _solver->_params, ay, i);
-      setSolverParameterSplineYB(k, _solver->_params, by, i);
-      setSolverParameterSplineYC(k, _solver->_params, cy, i);
-      setSolverParameterSplineYD(k, _solver->_params, dy, i);
-
-      // Distance where this spline starts
-      setSolverParameterSplineStart(k, _solver->_params, start, i);
+      setSolverParameterSplineXA(k, _solver->_params, segment.ax, i);
+      setSolverParameterSplineXB(k, _solver->_params, segment.bx, i);
+      setSolverParameterSplineXC(k, _solver->_params, segment.cx, i);
+      setSolverParameterSplineXD(k, _solver->_params, segment.dx, i);
+
+      setSolverParameterSplineYA(k, _solver->_params, segment.ay, i);
+      setSolverParameterSplineYB(k, _solver->_params, segment.by, i);
+      setSolverParameterSplineYC(k, _solver->_params, segment.cy, i);
+      setSolverParameterSplineYD(k, _solver->_params, segment.dy, i);
+
+      setSolverParameterSplineStart(k, _solver->_params, segment.start, i);
     }
   }
 
@@ -135,6 +134,11 @@ namespace MPCPlanner
       else
         _spline = std::make_shared<RosTools::Spline2D>(data.reference_path.x, data.reference_path.y, data.reference_path.s);
 
+      // A continued path keeps its s-coordinates, so the search can continue from the previous closest point
+      bool keep_progress = data.reference_path.is_continuation && _closest_segment >= 0;
+      _closest_point_search.setPath(*_spline, keep_progress);
+      _path_table = std::make_shared<PathLookupTable>(*_spline, _path_table_resolution);
+
       if (_add_road_constraints && (!data.left_bound.empty() && !data.right_bound.empty()))
       {
 
@@ -148,11 +152,15 @@ namespace MPCPlanner
             data.right_bound.y,
             _spline->getTVector());
 
+        _bound_left_table = std::make_unique<PathLookupTable>(*_bound_left, _path_table_resolution);
+        _bound_right_table = std::make_unique<PathLookupTable>(*_bound_right, _path_table_resolution);
+
         // Update the road width
-        CONFIG["road"]["width"] = RosTools::distance(_bound_left->getPoint(0), _bound_right->getPoint(0));
+        MUTABLE_CONFIG["road"]["width"] = RosTools::distance(_bound_left->getPoint(0), _bound_right->getPoint(0));
       }
 
-      _closest_segment = -1;
+      if (!keep_progress)
+        _closest_segment = -1;
     }
   }
 
@@ -208,11 +216,11 @@ namespace MPCPlanner
       double cur_s = _solver->getEgoPrediction(k, "spline");
 
       // This is the final point and the normal vector of the path
-      Eigen::Vector2d path_point = _spline->getPoint(cur_s);
-      Eigen::Vector2d dpath = _spline->getOrthogonal(cur_s);
+      Eigen::Vector2d path_point = _path_table->getPoint(cur_s);
+      Eigen::Vector2d dpath = _path_table->getOrthogonal(cur_s);
 
       // LEFT HALFSPACE
-      Eigen::Vector2d A = _spline->getOrthogonal(cur_s);
+      Eigen::Vector2d A = dpath;
       double width_times = two_way ? 3.0 : 1.0; // 3w for double lane
 
       // line is parallel to the spline
@@ -224,7 +232,7 @@ namespace MPCPlanner
       module_data.static_obstacles[k].emplace_back(A, b);
 
       // RIGHT HALFSPACE
-      A = _spline->getOrthogonal(cur_s); // Eigen::Vector2d(-path_dy, path_dx); // line is parallel to the spline
+      A = dpath; // Eigen::Vector2d(-path_dy, path_dx); // line is parallel to the spline
 
       Eigen::Vector2d boundary_right =
           path_point - dpath * (road_width_half - data.robot_area[0].radius);
@@ -250,13 +258,13 @@ namespace MPCPlanner
       double cur_s = _solver->getEgoPrediction(k, "spline");
 
       // Left
-      Eigen::Vector2d Al = _bound_left->getOrthogonal(cur_s);
-      double bl = Al.transpose() * (_bound_left->getPoint(cur_s) + Al * data.robot_area[0].radius);
+      Eigen::Vector2d Al = _bound_left_table->getOrthogonal(cur_s);
+      double bl = Al.transpose() * (_bound_left_table->getPoint(cur_s) + Al * data.robot_area[0].radius);
       module_data.static_obstacles[k].emplace_back(-Al, -bl);
 
       // RIGHT HALFSPACE
-      Eigen::Vector2d Ar = _bound_right->getOrthogonal(cur_s);
-      double br = Ar.transpose() * (_bound_right->getPoint(cur_s) - Ar * data.robot_area[0].radius);
+      Eigen::Vector2d Ar = _bound_right_table->getOrthogonal(cur_s);
+      double br = Ar.transpose() * (_bound_right_table->getPoint(cur_s) - Ar * data.robot_area[0].radius);
       module_data.static_obstacles[k].emplace_back(Ar, br);
     }
   }
@@ -290,6 +298,9 @@ namespace MPCPlanner
     (void)data;
     (void)module_data;
 
+    if (!shouldVisualize(_name + "/current"))
+      return;
+
     // Visualize the current points
     auto &publisher_current = VISUALS.getPublisher(_name + "/current");
     auto &cur_point = publisher_current.getNewPointMarker("CUBE");
@@ -304,6 +315,9 @@ namespace MPCPlanner
     (void)data;
     (void)module_data;
 
+    if (!shouldVisualize(_name + "/tracked_path"))
+      return;
+
     // Visualize the current points
     auto &publisher = VISUALS.getPublisher(_name + "/tracked_path");
     auto &line = publisher.getNewLine();
@@ -330,6 +344,9 @@ namespace MPCPlanner
   {
     (void)module_data;
 
+    if (!shouldVisualize(_name + "/path"))
+      return;
+
     visualizePathPoints(data.reference_path, _name + "/path", false);
     visualizeSpline(*_spline, _name + "/path", true);
   }
@@ -340,6 +357,9 @@ namespace MPCPlanner
     if (module_data.static_obstacles.empty() || (!_add_road_constraints))
       return;
 
+    if (!shouldVisualize(_name + "/road_boundary_constraints"))
+      return;
+
     for (int k = 1; k < _solver->N; k++)
     {
       for (size_t h = 0; h < module_data.static_obstacles[k].size(); h++)
@@ -355,6 +375,9 @@ namespace MPCPlanner
 
   void Contouring::visualizeDebugRoadBoundary(const RealTimeData &data, const ModuleData &module_data)
   {
+    if (!shouldVisualize(_name + "/road_boundary_points"))
+      return;
+
     (void)module_data;
     auto &publisher = VISUALS.getPublisher(_name + "/road_boundary_points");
     auto &points = publisher.getNewPointMarker("CUBE");
@@ -395,6 +418,9 @@ namespace MPCPlanner
     (void)data;
     (void)module_data;
 
+    if (!shouldVisualize(_name + "/glued_spline_points"))
+      return;
+
     // Plot how the optimization joins the splines together to debug its internal contouring error computation
     auto &publisher = VISUALS.getPublisher(_name + "/glued_spline_points");
     auto &points = publisher.getNewPointMarker("CUBE");
@@ -471,6 +497,9 @@ namespace MPCPlanner
     (void)data;
     (void)module_data;
 
+    if (!shouldVisualize(_name + "/spline_variables"))
+      return;
+
     // Plot how the optimization joins the splines together to debug its internal contouring error computation
     auto &publisher = VISUALS.getPublisher(_name + "/spline_variables");
     auto &points = publisher.getNewPointMarker("CUBE");
@@ -489,7 +518,9 @@ namespace MPCPlanner
   void Contouring::reset()
   {
     _spline.reset();
+    _path_table.reset();
     _closest_segment = 0;
+    _closest_point_search.reset();
   }
 
 } // namespace MPCPlanner
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <mpc_planner_solver/mpc_planner_parameters.h>
 
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 
 #include <ros_tools/visuals.h>
 #include <ros_tools/spline.h>
@@ -29,6 +30,10 @@ namespace MPCPlanner
 
     if (module_data.path_width_right == nullptr && _width_right != nullptr)
       module_data.path_width_right = _width_right;
+
+    // The width coefficients are the same for all stages, compute them once
+    if (_width_left != nullptr && _width_right != nullptr)
+      computeWidthParameters(module_data);
   }
 
   void ContouringConstraints::onDataReceived(RealTimeData &data, std::string &&data_name)
@@ -71,6 +76,7 @@ namespace MPCPlanner
 
   void ContouringConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
   {
+    (void)data;
     (void)module_data;
 
     if (k == 1)
@@ -78,45 +84,51 @@ namespace MPCPlanner
 
     for (int i = 0; i < _num_segments; i++)
     {
-      int index = module_data.current_path_segment + i;
+      const auto &segment = _segment_parameters[i];
 
-      // Boundaries
-      double ra, rb, rc, rd;
-      double la, lb, lc, ld;
+      // Boundary
+      setSolverParameterWidthRightA(k, _solver->_params, segment.ra, i);
+      setSolverParameterWidthRightB(k, _solver->_params, segment.rb, i);
+      setSolverParameterWidthRightC(k, _solver->_params, segment.rc, i);
+      setSolverParameterWidthRightD(k, _solver->_params, segment.rd, i);
+
+      setSolverParameterWidthLeftA(k, _solver->_params, segment.la, i);
+      setSolverParameterWidthLeftB(k, _solver->_params, segment.lb, i);
+      setSolverParameterWidthLeftC(k, _solver->_params, segment.lc, i);
+      setSolverParameterWidthLeftD(k, _solver->_params, segment.ld, i);
+    }
 
-      if (index < _width_right->m_x_.size() - 1)
-      {
+    if (k == 1)
+      LOG_MARK("ContouringConstraints::setParameters Done");
+  }
 
-        _width_right->getParameters(index, ra, rb, rc, rd);
-        _width_left->getParameters(index, la, lb, lc, ld);
+  void ContouringConstraints::computeWidthParameters(const ModuleData &module_data)
+  {
+    _segment_parameters.resize(_num_segments);
+
+    for (int i = 0; i < _num_segments; i++)
+    {
+      int index = module_data.current_path_segment + i;
+      auto &segment = _segment_parameters[i];
+
+      if (index < (int)_width_right->m_x_.size() - 1)
+      {
+        _width_right->getParameters(index, segment.ra, segment.rb, segment.rc, segment.rd);
+        _width_left->getParameters(index, segment.la, segment.lb, segment.lc, segment.ld);
       }
       else
       {
-        _width_right->getParameters(_width_right->m_x_.size() - 1, ra, rb, rc, rd);
-        _width_left->getParameters(_width_left->m_x_.size() - 1, la, lb, lc, ld);
-
-        ra = 0.;
-        rb = 0.;
-        rc = 0.;
-        la = 0.;
-        lb = 0.;
-        lc = 0.;
+        _width_right->getParameters(_width_right->m_x_.size() - 1, segment.ra, segment.rb, segment.rc, segment.rd);
+        _width_left->getParameters(_width_left->m_x_.size() - 1, segment.la, segment.lb, segment.lc, segment.ld);
+
+        segment.ra = 0.;
+        segment.rb = 0.;
+        segment.rc = 0.;
+        segment.la = 0.;
+        segment.lb = 0.;
+        segment.lc = 0.;
       }
-
-      // Boundary
-      setSolverParameterWidthRightA(k, _solver->_params, ra, i);
-      setSolverParameterWidthRightB(k, _solver->_params, rb, i);
-      setSolverParameterWidthRightC(k, _solver->_params, rc, i);
-      setSolverParameterWidthRightD(k, _solver->_params, rd, i);
-
-      setSolverParameterWidthLeftA(k, _solver->_params, la, i);
-      setSolverParameterWidthLeftB(k, _solver->_params, lb, i);
-      setSolverParameterWidthLeftC(k, _solver->_params, lc, i);
-      setSolverParameterWidthLeftD(k, _solver->_params, ld, i);
     }
-
-    if (k == 1)
-      LOG_MARK("ContouringConstraints::setParameters Done");
   }
 
   bool ContouringConstraints::isDataReady(const RealTimeData &data, std::string &missing_data)
@@ -143,35 +155,41 @@ namespace MPCPlanner
     if (_width_right == nullptr || _width_left == nullptr || module_data.path == nullptr)
       return;
 
-    auto &line_publisher = VISUALS.getPublisher(_name + "/road_boundary");
-    auto &line = line_publisher.getNewLine();
-    line.setScale(0.1);
-    line.setColorInt(0);
-
-    Eigen::Vector2d prev_right, prev_left;
-
-    for (double cur_s = 0.; cur_s < _width_right->m_x_.back(); cur_s += 0.5)
+    if (shouldVisualize(_name + "/road_boundary"))
     {
-      double right = _width_right->operator()(cur_s);
-      double left = _width_left->operator()(cur_s);
+      auto &line_publisher = VISUALS.getPublisher(_name + "/road_boundary");
+      auto &line = line_publisher.getNewLine();
+      line.setScale(0.1);
+      line.setColorInt(0);
 
-      Eigen::Vector2d path_point = module_data.path->getPoint(cur_s);
-      Eigen::Vector2d dpath = module_data.path->getOrthogonal(cur_s);
+      Eigen::Vector2d prev_right, prev_left;
 
-      if (cur_s > 0)
+      for (double cur_s = 0.; cur_s < _width_right->m_x_.back(); cur_s += 0.5)
       {
-        line.addLine(prev_left, path_point - dpath * left);
-        line.addLine(prev_right, path_point + dpath * right);
-      }
+        double right = _width_right->operator()(cur_s);
+        double left = _width_left->operator()(cur_s);
+
+        Eigen::Vector2d path_point = module_data.path->getPoint(cur_s);
+        Eigen::Vector2d dpath = module_data.path->getOrthogonal(cur_s);
+
+        if (cur_s > 0)
+        {
+          line.addLine(prev_left, path_point - dpath * left);
+          line.addLine(prev_right, path_point + dpath * right);
+        }
 
-      prev_left = path_point - dpath * left;
-      prev_right = path_point + dpath * right;
+        prev_left = path_point - dpath * left;
+        prev_right = path_point + dpath * right;
+      }
+      line_publisher.publish();
     }
-    line_publisher.publish();
 
     // if (!CONFIG["debug_visuals"].as<bool>())
     // return;
 
+    if (!shouldVisualize(_name + "/road_boundary_points"))
+      return;
+
     auto &publisher = VISUALS.getPublisher(_name + "/road_boundary_points");
     auto &points = publisher.getNewPointMarker("CUBE");
     auto &contour_line = publisher.getNewLine();
@@ -17,34 +17,19 @@ namespace MPCPlanner
         (void)data;
         (void)module_data;
 
-        // Retrieve weights once
-        static double contouring_weight, reference_velocity, velocity_weight;
-        static double terminal_angle_weight, terminal_contouring_weight;
-        if (k == 0)
-        {
-            contouring_weight = CONFIG["weights"]["contour"].as<double>();
+        // The weights and the spline window are stage invariant, set once in the stage template
+        if (k != 0)
+            return;
 
-            terminal_angle_weight = CONFIG["weights"]["terminal_angle"].as<double>();
-            terminal_contouring_weight = CONFIG["weights"]["terminal_contouring"].as<double>();
+        setSolverParameterContour(k, _solver->_params, CONFIG["weights"]["contour"].as<double>());
 
-            if (_dynamic_velocity_reference)
-            {
-                velocity_weight = CONFIG["weights"]["velocity"].as<double>();
-                reference_velocity = CONFIG["weights"]["reference_velocity"].as<double>();
-            }
-        }
+        setSolverParameterTerminalAngle(k, _solver->_params, CONFIG["weights"]["terminal_angle"].as<double>());
+        setSolverParameterTerminalContouring(k, _solver->_params, CONFIG["weights"]["terminal_contouring"].as<double>());
 
+        if (_dynamic_velocity_reference)
         {
-            setSolverParameterContour(k, _solver->_params, contouring_weight);
-
-            setSolverParameterTerminalAngle(k, _solver->_params, terminal_angle_weight);
-            setSolverParameterTerminalContouring(k, _solver->_params, terminal_contouring_weight);
-
-            if (_dynamic_velocity_reference)
-            {
-                setSolverParameterVelocity(k, _solver->_params, velocity_weight);
-                setSolverParameterReferenceVelocity(k, _solver->_params, reference_velocity);
-            }
+            setSolverParameterVelocity(k, _solver->_params, CONFIG["weights"]["velocity"].as<double>());
+            setSolverParameterReferenceVelocity(k, _solver->_params, CONFIG["weights"]["reference_velocity"].as<double>());
         }
 
         setSplineParameters(k);
@@ -6,24 +6,38 @@
 
 #include <mpc_planner_util/parameters.h>
 #include <mpc_planner_util/data_visualization.h>
+#include <mpc_planner_util/path_lookup_table.h>
 
 #include <ros_tools/profiling.h>
 #include <ros_tools/visuals.h>
 #include <ros_tools/spline.h>
 
 #include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace MPCPlanner
 {
   DecompConstraints::DecompConstraints(std::shared_ptr<Solver> solver)
-      : ControllerModule(ModuleType::CONSTRAINT, solver, "decomp_constraints")
+      : ControllerModule(ModuleType::CONSTRAINT, solver, "decomp_constraints"),
+        _occupancy(costmap_2d::FREE_SPACE),
+        _downsampling(CONFIG["decomp"]["tolerance"].as<double>(), CONFIG["decomp"]["boundary_only"].as<bool>(), costmap_2d::FREE_SPACE),
+        _polyhedron_cache(std::sqrt(2.) * CONFIG["decomp"]["range"].as<double>() + _downsampling.getOffset()) // See setScanRegion
   {
     LOG_INITIALIZE("Decomp Constraints");
-    _decomp_util = std::make_unique<EllipsoidDecomp2D>();
 
     // Only look around for obstacles using a box with sides of width 2*range
-    double range = CONFIG["decomp"]["range"].as<double>();
-    _decomp_util->set_local_bbox(Vec2f(range, range));
+    _range = CONFIG["decomp"]["range"].as<double>();
+    _local_bbox = Vec2f(_range, _range);
+
+    _num_threads = CONFIG["decomp"]["num_threads"].as<int>();
+#ifdef _OPENMP
+    if (_num_threads <= 0)
+      _num_threads = omp_get_max_threads();
+#endif
 
     _occ_pos.reserve(1000); // Reserve some space for the occupied positions
 
@@ -59,10 +73,6 @@ namespace MPCPlanner
 
     _dummy_b = state.get("x") + 100.;
 
-    getOccupiedGridCells(data); // Retrieve occupied points from the costmap
-
-    _decomp_util->set_obs(_occ_pos); // Set them
-
     // getPath(path);
 
     vec_Vec2f path;
@@ -73,17 +83,18 @@ namespace MPCPlanner
       // path.emplace_back(_solver->getEgoPrediction(k, "x"), _solver->getEgoPrediction(k, "y")); // k = 0 is initial state
 
       // Global (reference) path //
-      auto path_pos = module_data.path->getPoint(s);
+      Eigen::Vector2d path_pos = module_data.path_table->getPoint(s);
+      projectToSafety(*data.costmap, path_pos); // Ensure that the seed is collision-free
       path.emplace_back(path_pos(0), path_pos(1));
 
       double v = _solver->getEgoPrediction(k, "v"); // Use the predicted velocity
 
       s += v * _solver->dt;
     }
-    _decomp_util->dilate(path, 0, false);
 
-    _decomp_util->set_constraints(_constraints, 0.); // Map is already inflated
-    _polyhedrons = _decomp_util->get_polyhedrons();
+    getOccupiedGridCells(data, path); // Retrieve occupied points around the path from the costmap
+
+    decompose(path);
 
     int max_decomp_constraints = 0;
 
@@ -119,32 +130,106 @@ namespace MPCPlanner
     LOG_MARK("DecompConstraints::update done");
   }
 
-  bool DecompConstraints::getOccupiedGridCells(const RealTimeData &data)
+  void DecompConstraints::decompose(const vec_Vec2f &path)
+  {
+    PROFILE_FUNCTION();
+
+    int num_segments = (int)path.size() - 1;
+    _constraints.resize(num_segments);
+
+    // Reuse the polyhedron of the previous cycle (the path shifts forward) if it contains the segment and no obstacles were added around it
+    if (_occupancy.lastUpdateRebuilt())
+      _polyhedron_cache.clear();
+    _polyhedron_cache.findReusable(path, _occupancy.getAdded(), _polyhedrons, _segment_reused);
+
+    // Decompose the other segments in parallel (as EllipsoidDecomp2D::dilate, per segment)
+#pragma omp parallel for num_threads(_num_threads)
+    for (int i = 0; i < num_segments; i++)
+    {
+      if (_segment_reused[i])
+        continue;
+
+      LineSegment2D segment(path[i], path[i + 1]);
+      segment.set_local_bbox(_local_bbox);
+      segment.set_obs(_occ_pos);
+      segment.dilate(0.);
+      _polyhedrons[i] = segment.get_polyhedron();
+    }
+
+    // Map is already inflated, only compensate the downsampling
+    double offset = _downsampling.getOffset();
+    _num_reused = 0;
+    for (int i = 0; i < num_segments; i++)
+    {
+      const Vec2f inside = (path[i] + path[i + 1]) / 2.;
+      _constraints[i] = LinearConstraint<2>(inside, _polyhedrons[i].hyperplanes());
+      for (int j = 0; j < _constraints[i].A_.rows(); j++)
+        _constraints[i].b_(j) -= offset * _constraints[i].A_.row(j).norm();
+
+      _num_reused += _segment_reused[i] ? 1 : 0;
+    }
+
+    LOG_MARK("Polyhedra reused: " << _num_reused << ", recomputed: " << num_segments - _num_reused);
+
+    _polyhedron_cache.store(path, _polyhedrons);
+  }
+
+  bool DecompConstraints::getOccupiedGridCells(const RealTimeData &data, const vec_Vec2f &path)
   {
     PROFILE_FUNCTION();
     LOG_MARK("GetOccupiedGridCells");
 
     const auto &costmap = *data.costmap;
 
-    // Store all occupied cells in the grid map
-    _occ_pos.clear();
-    double x, y;
-    for (unsigned int i = 0; i < costmap.getSizeInCellsX(); i++)
+    setScanRegion(costmap, path);
+
+    // Update the occupied cells from the cells that changed since the previous cycle
+    _occupancy.update(costmap.getCharMap(), costmap.getSizeInCellsX(), costmap.getSizeInCellsY(),
+                      costmap.getOriginX(), costmap.getOriginY(), costmap.getResolution());
+
+    // Fewer points for the decomposition (the occupied cells themselves if downsampling is disabled)
+    _downsampling.apply(_occupancy.getOccupied(), costmap.getCharMap(), costmap.getSizeInCellsX(), costmap.getSizeInCellsY(),
+                        costmap.getOriginX(), costmap.getOriginY(), costmap.getResolution());
+
+    const auto &points = _downsampling.getPoints();
+    _occ_pos.assign(points.begin(), points.end());
+
+    LOG_MARK("Occupied cells: " << _occupancy.getOccupied().size() << " (" << _occupancy.numChangedCells() << " changed), "
+                                << _occ_pos.size() << " obstacle points after downsampling");
+
+    return true;
+  }
+
+  void DecompConstraints::setScanRegion(const costmap_2d::Costmap2D &costmap, const vec_Vec2f &path)
+  {
+    // The local bounding box of decomp util is aligned with each path segment, sqrt(2) * range covers it in any direction
+    double margin = std::sqrt(2.) * _range;
+
+    int size_x = costmap.getSizeInCellsX(), size_y = costmap.getSizeInCellsY();
+    double origin_x = costmap.getOriginX(), origin_y = costmap.getOriginY();
+    double inv_resolution = 1. / costmap.getResolution();
+
+    // Union of the boxes around the segments, as one interval of cells per row
+    _row_begin.assign(size_y, size_x);
+    _row_end.assign(size_y, 0);
+    for (size_t i = 0; i < path.size(); i++)
     {
-      for (unsigned int j = 0; j < costmap.getSizeInCellsY(); j++)
-      {
-        if (costmap.getCost(i, j) == costmap_2d::FREE_SPACE)
-          continue;
+      const auto &start = path[i];
+      const auto &end = path[std::min(i + 1, path.size() - 1)];
 
-        costmap.mapToWorld(i, j, x, y);
-        // LOG_INFO("Obstacle at x = " << x << ", y = " << y);
+      int min_x = std::max((int)std::floor((std::min(start(0), end(0)) - margin - origin_x) * inv_resolution), 0);
+      int max_x = std::min((int)std::floor((std::max(start(0), end(0)) + margin - origin_x) * inv_resolution), size_x - 1);
+      int min_y = std::max((int)std::floor((std::min(start(1), end(1)) - margin - origin_y) * inv_resolution), 0);
+      int max_y = std::min((int)std::floor((std::max(start(1), end(1)) + margin - origin_y) * inv_resolution), size_y - 1);
 
-        _occ_pos.emplace_back(x, y);
+      for (int y = min_y; y <= max_y; y++)
+      {
+        _row_begin[y] = std::min(_row_begin[y], min_x);
+        _row_end[y] = std::max(_row_end[y], max_x + 1);
       }
     }
-    // LOG_VALUE("Occupied cells", _occ_pos.size());
 
-    return true;
+    _occupancy.setRegion(_row_begin, _row_end);
   }
 
   void DecompConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
@@ -154,7 +239,7 @@ namespace MPCPlanner
     {
       for (int d = 0; d < _n_discs; d++)
       {
-        setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
+        setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d); // Stage invariant
 
         int constraint_counter = 0;
         for (int i = 0; i < _max_constraints; i++)
@@ -176,8 +261,6 @@ namespace MPCPlanner
     int constraint_counter = 0; // Necessary for now to map the disc and obstacle index to a single index
     for (int d = 0; d < _n_discs; d++)
     {
-      setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
-
       for (int i = 0; i < _max_constraints; i++)
       {
         setSolverParameterDecompA1(k, _solver->_params, _a1[d][k](i), constraint_counter); // These are filled from k = 1 - N
@@ -199,22 +282,43 @@ namespace MPCPlanner
     return true;
   }
 
-  void DecompConstraints::projectToSafety(Eigen::Vector2d &pos)
+  void DecompConstraints::projectToSafety(const costmap_2d::Costmap2D &costmap, Eigen::Vector2d &pos)
   {
-    // Too slow
-    if (_occ_pos.empty()) // There is no anchor
-      return;
-
-    // Project to a collision free position if necessary, considering all the obstacles
-    for (int iterate = 0; iterate < 1; iterate++) // At most 3 iterations
+    // Closest occupied cell within range, searching only the cells around the position
+    auto closest_occupied = [&](const Eigen::Vector2d &point, double range, Eigen::Vector2d &closest)
     {
-      for (auto &obs : _occ_pos)
+      unsigned int center_x, center_y;
+      if (!costmap.worldToMap(point(0), point(1), center_x, center_y))
+        return false;
+
+      int cells = (int)std::ceil(range / costmap.getResolution());
+      int min_x = std::max((int)center_x - cells, 0), max_x = std::min((int)center_x + cells, (int)costmap.getSizeInCellsX() - 1);
+      int min_y = std::max((int)center_y - cells, 0), max_y = std::min((int)center_y + cells, (int)costmap.getSizeInCellsY() - 1);
+
+      double best_distance = range;
+      bool found = false;
+      double x, y;
+      for (int i = min_x; i <= max_x; i++)
       {
-        double radius = CONFIG["robot_radius"].as<double>() + 0.1;
-
-        dr_projection_.douglasRachfordProjection(pos, obs, _occ_pos[0], radius, pos);
+        for (int j = min_y; j <= max_y; j++)
+        {
+          if (costmap.getCost(i, j) == costmap_2d::FREE_SPACE)
+            continue;
+
+          costmap.mapToWorld(i, j, x, y);
+          double distance = std::hypot(x - point(0), y - point(1));
+          if (distance < best_distance)
+          {
+            best_distance = distance;
+            closest = Eigen::Vector2d(x, y);
+            found = true;
+          }
+        }
       }
-    }
+      return found;
+    };
+
+    _projection.project(pos, CONFIG["robot_radius"].as<double>() + 0.1, closest_occupied);
   }
 
   void DecompConstraints::visualize(const RealTimeData &data, const ModuleData &module_data)
@@ -225,41 +329,44 @@ namespace MPCPlanner
 
     bool visualize_points = false;
 
-    auto &publisher = VISUALS.getPublisher("free_space");
-    auto &polypoint = publisher.getNewPointMarker("CUBE");
-    polypoint.setScale(0.1, 0.1, 0.1);
-    polypoint.setColor(1, 0, 0, 1);
-
-    auto &polyline = publisher.getNewLine();
-    polyline.setScale(0.1, 0.1);
-    for (int k = 0; k < _solver->N; k += CONFIG["visualization"]["draw_every"].as<int>())
+    if (shouldVisualize("free_space"))
     {
-      const auto &poly = _polyhedrons[k];
-      polyline.setColorInt(k, _solver->N);
-
-      const auto vertices = cal_vertices(poly);
-      if (vertices.size() < 2)
-        continue;
-
-      for (size_t i = 0; i < vertices.size(); i++)
+      auto &publisher = VISUALS.getPublisher("free_space");
+      auto &polypoint = publisher.getNewPointMarker("CUBE");
+      polypoint.setScale(0.1, 0.1, 0.1);
+      polypoint.setColor(1, 0, 0, 1);
+
+      auto &polyline = publisher.getNewLine();
+      polyline.setScale(0.1, 0.1);
+      for (int k = 0; k < _solver->N; k += CONFIG["visualization"]["draw_every"].as<int>())
       {
-        if (visualize_points)
-          polypoint.addPointMarker(Eigen::Vector3d(vertices[i](0), vertices[i](1), 0));
+        const auto &poly = _polyhedrons[k];
+        polyline.setColorInt(k, _solver->N);
+
+        const auto vertices = cal_vertices(poly);
+        if (vertices.size() < 2)
+          continue;
 
-        if (i > 0)
+        for (size_t i = 0; i < vertices.size(); i++)
         {
-          polyline.addLine(
-              Eigen::Vector3d(vertices[i - 1](0), vertices[i - 1](1), 0),
-              Eigen::Vector3d(vertices[i](0), vertices[i](1), 0));
+          if (visualize_points)
+            polypoint.addPointMarker(Eigen::Vector3d(vertices[i](0), vertices[i](1), 0));
+
+          if (i > 0)
+          {
+            polyline.addLine(
+                Eigen::Vector3d(vertices[i - 1](0), vertices[i - 1](1), 0),
+                Eigen::Vector3d(vertices[i](0), vertices[i](1), 0));
+          }
         }
+        polyline.addLine(Eigen::Vector3d(vertices.back()(0), vertices.back()(1), 0),
+                         Eigen::Vector3d(vertices[0](0), vertices[0](1), 0));
       }
-      polyline.addLine(Eigen::Vector3d(vertices.back()(0), vertices.back()(1), 0),
-                       Eigen::Vector3d(vertices[0](0), vertices[0](1), 0));
-    }
 
-    publisher.publish();
+      publisher.publish();
+    }
 
-    if (!CONFIG["debug_visuals"].as<bool>())
+    if (!CONFIG["debug_visuals"].as<bool>() || !shouldVisualize("map"))
       return;
 
     LOG_MARK("DecompConstraints::Visualize");
@@ -0,0 +1,134 @@
+#include "mpc_planner_modules/distance_field_constraints.h"
+
+#include <costmap_2d/costmap_2d_ros.h>
+
+#include <mpc_planner_solver/mpc_planner_parameters.h>
+
+#include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
+
+#include <ros_tools/profiling.h>
+
+namespace MPCPlanner
+{
+  DistanceFieldConstraints::DistanceFieldConstraints(std::shared_ptr<Solver> solver)
+      : ControllerModule(ModuleType::CONSTRAINT, solver, "distance_field_constraints"),
+        _field(CONFIG["distance_field"]["max_distance"].as<double>(), costmap_2d::FREE_SPACE)
+  {
+    LOG_INITIALIZE("Distance Field Constraints");
+
+    _n_discs = CONFIG["n_discs"].as<int>();
+
+    _a1.resize(_n_discs, std::vector<double>(CONFIG["N"].as<int>(), _dummy_a1));
+    _a2.resize(_n_discs, std::vector<double>(CONFIG["N"].as<int>(), _dummy_a2));
+    _b.resize(_n_discs, std::vector<double>(CONFIG["N"].as<int>(), 0.));
+
+    LOG_INITIALIZED();
+  }
+
+  void DistanceFieldConstraints::update(State &state, const RealTimeData &data, ModuleData &module_data)
+  {
+    (void)module_data;
+
+    PROFILE_SCOPE("DistanceFieldConstraints::Update");
+    LOG_MARK("DistanceFieldConstraints::update");
+
+    _dummy_b = state.get("x") + 100.;
+
+    const auto &costmap = *data.costmap;
+    _field.update(costmap.getCharMap(), costmap.getSizeInCellsX(), costmap.getSizeInCellsY(),
+                  costmap.getOriginX(), costmap.getOriginY(), costmap.getResolution());
+
+    LOG_MARK("Distance field: updated " << _field.numUpdatedRows() << " rows, " << _field.numUpdatedColumns() << " columns");
+
+    double cell_radius = 0.5 * costmap.getResolution(); // Distances are to occupied cell centers, the map is already inflated
+
+    Eigen::Vector2d gradient;
+    for (int k = 1; k < _solver->N; k++)
+    {
+      Eigen::Vector2d pos = _solver->getEgoPredictionPosition(k); // Linearize at the warm start
+      double psi = _solver->getEgoPrediction(k, "psi");
+
+      for (int d = 0; d < _n_discs; d++)
+      {
+        Eigen::Vector2d disc_pos = data.robot_area[d].getPosition(pos, psi);
+        double distance = _field.getDistance(disc_pos, gradient);
+
+        if (distance >= _field.getMaxDistance()) // No obstacles nearby
+        {
+          _a1[d][k] = _dummy_a1;
+          _a2[d][k] = _dummy_a2;
+          _b[d][k] = _dummy_b;
+          continue;
+        }
+
+        if (gradient.norm() < 1e-3) // Inside an obstacle or on a ridge of the field, keep the halfspace of the previous stage
+        {
+          _a1[d][k] = k > 1 ? _a1[d][k - 1] : _dummy_a1;
+          _a2[d][k] = k > 1 ? _a2[d][k - 1] : _dummy_a2;
+          _b[d][k] = k > 1 ? _b[d][k - 1] : _dummy_b;
+          continue;
+        }
+
+        // Tangent to the closest obstacle: n^T x >= n^T obstacle_pos + cell_radius
+        Eigen::Vector2d normal = gradient.normalized();
+        Eigen::Vector2d obstacle_pos = disc_pos - distance * normal;
+
+        _a1[d][k] = -normal(0);
+        _a2[d][k] = -normal(1);
+        _b[d][k] = -normal.dot(obstacle_pos) - cell_radius;
+      }
+    }
+
+    LOG_MARK("DistanceFieldConstraints::update done");
+  }
+
+  void DistanceFieldConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
+  {
+    (void)module_data;
+
+    for (int d = 0; d < _n_discs; d++)
+    {
+      if (k == 0) // Dummies
+      {
+        setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d); // Stage invariant
+
+        setSolverParameterDistanceFieldA1(k, _solver->_params, _dummy_a1, d);
+        setSolverParameterDistanceFieldA2(k, _solver->_params, _dummy_a2, d);
+        setSolverParameterDistanceFieldB(k, _solver->_params, _dummy_b, d);
+        continue;
+      }
+
+      setSolverParameterDistanceFieldA1(k, _solver->_params, _a1[d][k], d);
+      setSolverParameterDistanceFieldA2(k, _solver->_params, _a2[d][k], d);
+      setSolverParameterDistanceFieldB(k, _solver->_params, _b[d][k], d);
+    }
+  }
+
+  bool DistanceFieldConstraints::isDataReady(const RealTimeData &data, std::string &missing_data)
+  {
+    if (data.costmap == nullptr)
+    {
+      missing_data += "Costmap ";
+      return false;
+    }
+
+    return true;
+  }
+
+  void DistanceFieldConstraints::visualize(const RealTimeData &data, const ModuleData &module_data)
+  {
+    (void)data;
+    (void)module_data;
+    if (!shouldVisualize(_name))
+      return;
+
+    PROFILE_FUNCTION();
+
+    for (int k = 1; k < _solver->N; k++)
+    {
+      visualizeLinearConstraint(_a1[0][k], _a2[0][k], _b[0][k], k, _solver->N, _name, k == _solver->N - 1); // Publish at the end
+    }
+  }
+
+} // namespace MPCPlanner
@@ -11,7 +11,8 @@
 namespace MPCPlanner
 {
   EllipsoidConstraints::EllipsoidConstraints(std::shared_ptr<Solver> solver)
-      : ControllerModule(ModuleType::CONSTRAINT, solver, "ellipsoid_constraints")
+      : ControllerModule(ModuleType::CONSTRAINT, solver, "ellipsoid_constraints"),
+        _screening(CONFIG["max_obstacles"].as<int>(), solver->_model_map)
   {
     LOG_INITIALIZE("Ellipsoid Constraints");
     LOG_INITIALIZED();
@@ -19,74 +20,102 @@ namespace MPCPlanner
     _n_discs = CONFIG["n_discs"].as<int>();
     _robot_radius = CONFIG["robot_radius"].as<double>();
     _risk = CONFIG["probabilistic"]["risk"].as<double>();
+
+    _block.resize(_solver->N, _screening.numSlots());
   }
 
   void EllipsoidConstraints::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
-    (void)state;
-    (void)data;
     (void)module_data;
 
     _dummy_x = state.get("x") + 50;
     _dummy_y = state.get("y") + 50;
+
+    // Only obstacles that can be reached get a constraint
+    _ego_positions.resize(_solver->N);
+    for (int k = 0; k < _solver->N; k++)
+      _ego_positions[k] = _solver->getEgoPredictionPosition(k);
+
+    double chi = _block.getChi(_risk);
+    _screening.update(_ego_positions, data.dynamic_obstacles, data.robot_area, _robot_radius, _solver->dt, chi);
+    LOG_MARK("EllipsoidConstraints: " << _screening.numScreened() << " obstacle constraints screened");
+
+    // Compute the parameters of all stages once
+    for (int k = 0; k < _solver->N; k++)
+    {
+      for (int i = 0; i < _screening.numSlots(); i++)
+      {
+        int obstacle_id = _screening.getObstacle(k, i); // Always a dummy for k = 0
+        if (obstacle_id < 0)                            // Out of reach (inactive)
+        {
+          setDummy(k, i);
+          continue;
+        }
+
+        const auto &obstacle = data.dynamic_obstacles[obstacle_id];
+        const auto &mode = obstacle.prediction.modes[0];
+
+        /** @note The first prediction step is index 1 of the optimization problem, i.e., k-1 maps to the predictions for this stage */
+        auto &parameters = _block.at(k, i);
+        parameters.x = mode[k - 1].position(0);
+        parameters.y = mode[k - 1].position(1);
+        parameters.psi = mode[k - 1].angle;
+        parameters.r = obstacle.radius;
+
+        if (obstacle.prediction.type == PredictionType::GAUSSIAN)
+        {
+          parameters.major = mode[k - 1].major_radius;
+          parameters.minor = mode[k - 1].minor_radius;
+          parameters.chi = chi;
+        }
+        else // Deterministic
+        {
+          parameters.major = 0.;
+          parameters.minor = 0.;
+          parameters.chi = 1.;
+        }
+      }
+    }
+  }
+
+  void EllipsoidConstraints::setDummy(int k, int slot)
+  {
+    auto &parameters = _block.at(k, slot);
+    parameters.x = _dummy_x;
+    parameters.y = _dummy_y;
+    parameters.psi = 0.;
+    parameters.r = 0.1;
+    parameters.major = 0.;
+    parameters.minor = 0.;
+    parameters.chi = 1.;
   }
 
   void EllipsoidConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
   {
     (void)module_data;
 
-    setSolverParameterEgoDiscRadius(k, _solver->_params, _robot_radius);
-    for (int d = 0; d < _n_discs; d++)
-      setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
-
-    if (k == 0) // Dummies
+    if (k == 0) // Stage invariant, set once in the stage template
     {
-      // LOG_INFO("Setting parameters for k = 0");
-      for (size_t i = 0; i < data.dynamic_obstacles.size(); i++)
-      {
-        setSolverParameterEllipsoidObstX(0, _solver->_params, _dummy_x, i);
-        setSolverParameterEllipsoidObstY(0, _solver->_params, _dummy_y, i);
-        setSolverParameterEllipsoidObstPsi(0, _solver->_params, 0., i);
-        setSolverParameterEllipsoidObstR(0, _solver->_params, 0.1, i);
-        setSolverParameterEllipsoidObstMajor(0, _solver->_params, 0., i);
-        setSolverParameterEllipsoidObstMinor(0, _solver->_params, 0., i);
-        setSolverParameterEllipsoidObstChi(0, _solver->_params, 1., i);
-      }
-      return;
+      setSolverParameterEgoDiscRadius(k, _solver->_params, _robot_radius);
+      for (int d = 0; d < _n_discs; d++)
+        setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
     }
 
     if (k == 1)
       LOG_MARK("EllipsoidConstraints::setParameters");
 
-    for (size_t i = 0; i < data.dynamic_obstacles.size(); i++)
+    // Stream the parameters computed in update (dummies for k = 0)
+    for (int i = 0; i < _block.numSlots(); i++)
     {
-      const auto &obstacle = data.dynamic_obstacles[i];
-      const auto &mode = obstacle.prediction.modes[0];
-
-      /** @note The first prediction step is index 1 of the optimization problem, i.e., k-1 maps to the predictions for this stage */
-      setSolverParameterEllipsoidObstX(k, _solver->_params, mode[k - 1].position(0), i);
-      setSolverParameterEllipsoidObstY(k, _solver->_params, mode[k - 1].position(1), i);
-      setSolverParameterEllipsoidObstPsi(k, _solver->_params, mode[k - 1].angle, i);
-      setSolverParameterEllipsoidObstR(k, _solver->_params, obstacle.radius, i);
-
-      if (obstacle.prediction.type == PredictionType::DETERMINISTIC)
-      {
-        setSolverParameterEllipsoidObstMajor(k, _solver->_params, 0., i);
-        setSolverParameterEllipsoidObstMinor(k, _solver->_params, 0., i);
-        setSolverParameterEllipsoidObstChi(k, _solver->_params, 1., i);
-      }
-      else if (obstacle.prediction.type == PredictionType::GAUSSIAN)
-      {
-        double chi = RosTools::ExponentialQuantile(0.5, 1.0 - _risk);
-
-        setSolverParameterEllipsoidObstMajor(k, _solver->_params, mode[k - 1].major_radius, i);
-        setSolverParameterEllipsoidObstMinor(k, _solver->_params, mode[k - 1].minor_radius, i);
-        setSolverParameterEllipsoidObstChi(k, _solver->_params, chi, i);
-      }
+      const auto &parameters = _block.at(k, i);
+      setSolverParameterEllipsoidObstX(k, _solver->_params, parameters.x, i);
+      setSolverParameterEllipsoidObstY(k, _solver->_params, parameters.y, i);
+      setSolverParameterEllipsoidObstPsi(k, _solver->_params, parameters.psi, i);
+      setSolverParameterEllipsoidObstR(k, _solver->_params, parameters.r, i);
+      setSolverParameterEllipsoidObstMajor(k, _solver->_params, parameters.major, i);
+      setSolverParameterEllipsoidObstMinor(k, _solver->_params, parameters.minor, i);
+      setSolverParameterEllipsoidObstChi(k, _solver->_params, parameters.chi, i);
     }
-
-    if (k == 1)
-      LOG_MARK("EllipsoidConstraints::setParameters Done");
   }
 
   bool EllipsoidConstraints::isDataReady(const RealTimeData &data, std::string &missing_data)
@@ -3,6 +3,7 @@
 #include <mpc_planner_solver/mpc_planner_parameters.h>
 
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 
 #include <ros_tools/visuals.h>
 #include <ros_tools/math.h>
@@ -13,54 +14,104 @@
 namespace MPCPlanner
 {
   GaussianConstraints::GaussianConstraints(std::shared_ptr<Solver> solver)
-      : ControllerModule(ModuleType::CONSTRAINT, solver, "gaussian_constraints")
+      : ControllerModule(ModuleType::CONSTRAINT, solver, "gaussian_constraints"),
+        _screening(CONFIG["max_obstacles"].as<int>(), solver->_model_map)
   {
     LOG_INITIALIZE("Gaussian Constraints");
+
+    _n_discs = CONFIG["n_discs"].as<int>();
+    _robot_radius = CONFIG["robot_radius"].as<double>();
+    _obstacle_radius = CONFIG["obstacle_radius"].as<double>();
+    _risk = CONFIG["probabilistic"]["risk"].as<double>();
+
+    _block.resize(_solver->N, _screening.numSlots());
     LOG_INITIALIZED();
   }
 
   void GaussianConstraints::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
-    (void)state;
-    (void)data;
     (void)module_data;
-  }
 
-  void GaussianConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
-  {
-    (void)module_data;
+    _dummy_x = state.get("x") + 50.;
+    _dummy_y = state.get("y") + 50.;
 
-    setSolverParameterEgoDiscRadius(k, _solver->_params, CONFIG["robot_radius"].as<double>());
-    for (int d = 0; d < CONFIG["n_discs"].as<int>(); d++)
-      setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
+    // Only obstacles that can be reached get a constraint
+    _ego_positions.resize(_solver->N);
+    for (int k = 0; k < _solver->N; k++)
+      _ego_positions[k] = _solver->getEgoPredictionPosition(k);
 
-    std::vector<DynamicObstacle> copied_obstacles = data.dynamic_obstacles;
+    _screening.update(_ego_positions, data.dynamic_obstacles, data.robot_area, _robot_radius, _solver->dt, _block.getChi(_risk));
+    LOG_MARK("GaussianConstraints: " << _screening.numScreened() << " obstacle constraints screened");
 
-    for (size_t i = 0; i < copied_obstacles.size(); i++)
+    // Compute the parameters of all stages once
+    for (int k = 0; k < _solver->N; k++)
     {
-      const auto &obstacle = copied_obstacles[i];
-
-      if (obstacle.prediction.type == PredictionType::GAUSSIAN)
+      for (int i = 0; i < _screening.numSlots(); i++)
       {
-        setSolverParameterGaussianObstX(k, _solver->_params, obstacle.prediction.modes[0][k - 1].position(0), i);
-        setSolverParameterGaussianObstY(k, _solver->_params, obstacle.prediction.modes[0][k - 1].position(1), i);
+        int obstacle_id = _screening.getObstacle(k, i); // Always a dummy for k = 0
+        const DynamicObstacle *obstacle = obstacle_id < 0 ? nullptr : &data.dynamic_obstacles[obstacle_id];
+        if (obstacle == nullptr || obstacle->prediction.type != PredictionType::GAUSSIAN) // Out of reach (inactive)
+        {
+          setDummy(k, i);
+          continue;
+        }
+
+        const auto &prediction = obstacle->prediction.modes[0][k - 1];
+        auto &parameters = _block.at(k, i);
+        parameters.x = prediction.position(0);
+        parameters.y = prediction.position(1);
 
-        if (obstacle.type == ObstacleType::DYNAMIC)
+        if (obstacle->type == ObstacleType::DYNAMIC)
         {
-          setSolverParameterGaussianObstMajor(k, _solver->_params, obstacle.prediction.modes[0][k - 1].major_radius, i);
-          setSolverParameterGaussianObstMinor(k, _solver->_params, obstacle.prediction.modes[0][k - 1].minor_radius, i);
+          parameters.major = prediction.major_radius;
+          parameters.minor = prediction.minor_radius;
         }
         else // Static obstacles have no uncertainty
         {
-          setSolverParameterGaussianObstMajor(k, _solver->_params, 0.001, i);
-          setSolverParameterGaussianObstMinor(k, _solver->_params, 0.001, i);
+          parameters.major = 0.001;
+          parameters.minor = 0.001;
         }
-        setSolverParameterGaussianObstRisk(k, _solver->_params, CONFIG["probabilistic"]["risk"].as<double>(), i);
-        setSolverParameterGaussianObstR(k, _solver->_params, CONFIG["obstacle_radius"].as<double>(), i);
+        parameters.risk = _risk;
+        parameters.r = _obstacle_radius;
       }
     }
   }
 
+  void GaussianConstraints::setDummy(int k, int slot)
+  {
+    auto &parameters = _block.at(k, slot);
+    parameters.x = _dummy_x;
+    parameters.y = _dummy_y;
+    parameters.major = 0.001;
+    parameters.minor = 0.001;
+    parameters.risk = _risk;
+    parameters.r = 0.1;
+  }
+
+  void GaussianConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
+  {
+    (void)module_data;
+
+    if (k == 0) // Stage invariant, set once in the stage template
+    {
+      setSolverParameterEgoDiscRadius(k, _solver->_params, _robot_radius);
+      for (int d = 0; d < _n_discs; d++)
+        setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
+    }
+
+    // Stream the parameters computed in update
+    for (int i = 0; i < _block.numSlots(); i++)
+    {
+      const auto &parameters = _block.at(k, i);
+      setSolverParameterGaussianObstX(k, _solver->_params, parameters.x, i);
+      setSolverParameterGaussianObstY(k, _solver->_params, parameters.y, i);
+      setSolverParameterGaussianObstMajor(k, _solver->_params, parameters.major, i);
+      setSolverParameterGaussianObstMinor(k, _solver->_params, parameters.minor, i);
+      setSolverParameterGaussianObstRisk(k, _solver->_params, parameters.risk, i);
+      setSolverParameterGaussianObstR(k, _solver->_params, parameters.r, i);
+    }
+  }
+
   bool GaussianConstraints::isDataReady(const RealTimeData &data, std::string &missing_data)
   {
     if (data.dynamic_obstacles.size() != CONFIG["max_obstacles"].as<unsigned int>())
@@ -90,6 +141,9 @@ namespace MPCPlanner
   void GaussianConstraints::visualize(const RealTimeData &data, const ModuleData &module_data)
   {
     (void)module_data;
+    if (!shouldVisualize(_name))
+      return;
+
     PROFILE_SCOPE("GuidanceConstraints::Visualize");
     LOG_MARK("GaussianConstraints::visualize");
     auto &publisher = VISUALS.getPublisher(_name);
@@ -103,9 +157,7 @@ namespace MPCPlanner
       {
         ellipsoid.setColorInt(k, _solver->N, 0.5);
 
-        double chi = obstacle.type == ObstacleType::DYNAMIC
-                         ? RosTools::ExponentialQuantile(0.5, 1.0 - CONFIG["probabilistic"]["risk"].as<double>())
-                         : 0.;
+        double chi = obstacle.type == ObstacleType::DYNAMIC ? _block.getChi(_risk) : 0.;
         ellipsoid.setScale(2 * (obstacle.prediction.modes[0][k - 1].major_radius * std::sqrt(chi) + obstacle.radius),
                            2 * (obstacle.prediction.modes[0][k - 1].major_radius * std::sqrt(chi) + obstacle.radius), 0.005);
 
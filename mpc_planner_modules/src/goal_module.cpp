@@ -2,6 +2,7 @@
 #include <mpc_planner_modules/goal_module.h>
 
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 
 #include <mpc_planner_solver/mpc_planner_parameters.h>
 
@@ -28,8 +29,10 @@ namespace MPCPlanner
     void GoalModule::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
     {
         (void)module_data;
-        if (k == 0)
-            LOG_MARK("Goal Module::setParameters()");
+        if (k != 0) // Stage invariant, set once in the stage template
+            return;
+
+        LOG_MARK("Goal Module::setParameters()");
 
         setSolverParameterGoalX(k, _solver->_params, data.goal(0));
         setSolverParameterGoalY(k, _solver->_params, data.goal(1));
@@ -58,7 +61,7 @@ namespace MPCPlanner
     void GoalModule::visualize(const RealTimeData &data, const ModuleData &module_data)
     {
         (void)module_data;
-        if (!data.goal_received)
+        if (!data.goal_received || !shouldVisualize(_name))
             return;
 
         auto &publisher = VISUALS.getPublisher(_name);
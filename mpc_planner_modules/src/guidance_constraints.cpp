@@ -2,6 +2,7 @@
 
 #include <mpc_planner_util/parameters.h>
 #include <mpc_planner_util/data_visualization.h>
+#include <mpc_planner_util/path_lookup_table.h>
 
 #include <guidance_planner/global_guidance.h>
 
@@ -12,6 +13,8 @@
 
 #include <omp.h>
 
+#include <algorithm>
+
 namespace MPCPlanner
 {
     GuidanceConstraints::LocalPlanner::LocalPlanner(int _id, bool _is_original_planner)
@@ -32,7 +35,10 @@ namespace MPCPlanner
         global_guidance_ = std::make_shared<GuidancePlanner::GlobalGuidance>();
         GuidancePlanner::Config::debug_visuals_ = CONFIG["debug_visuals"].as<bool>();
 
-        global_guidance_->SetPlanningFrequency(CONFIG["control_frequency"].as<double>());
+        // A lower guidance rate gives the search a longer time budget
+        _guidance_rate = CONFIG["t-mpc"]["guidance_rate"].as<double>();
+        _highlight_selected = CONFIG["t-mpc"]["highlight_selected"].as<bool>();
+        global_guidance_->SetPlanningFrequency(_guidance_rate > 0. ? _guidance_rate : CONFIG["control_frequency"].as<double>());
 
         _use_tmpcpp = CONFIG["t-mpc"]["use_t-mpc++"].as<bool>();
         _enable_constraints = CONFIG["t-mpc"]["enable_constraints"].as<bool>();
@@ -56,9 +62,58 @@ namespace MPCPlanner
             planners_.emplace_back(n_solvers, true);
         }
 
+        // Planners without guidance constraints do not consider the obstacles in these constraints (no copy of the data)
+        for (auto &planner : planners_)
+        {
+            if (planner.is_original_planner || !_enable_constraints)
+                planner.guidance_constraints->setObstacles(&_no_obstacles);
+        }
+
+        // Persistent workers, at most one per planner
+        int n_threads = CONFIG["t-mpc"]["num_threads"].as<int>();
+        if (n_threads <= 0)
+            n_threads = ThreadPool::numAvailableCores();
+        n_threads = std::min(n_threads, (int)planners_.size());
+
+        _pool = std::make_unique<ThreadPool>(n_threads, true, [](int)
+                                             {
+                                                 // Required for parallel calls to the solvers when using Forces
+                                                 omp_set_max_active_levels(2);
+                                                 omp_set_dynamic(0); });
+        LOG_VALUE("Planner threads", _pool->numThreads());
+
+        _adaptive_planner_count = CONFIG["t-mpc"]["adaptive_planner_count"].as<bool>();
+
+        _racing = CONFIG["t-mpc"]["racing"]["enable"].as<bool>();
+        if (_racing && !_solver->canTerminateEarly() && !_solver->hasTimeout())
+        {
+            LOG_WARN("T-MPC racing needs a solver that stops between iterations (acados SQP_RTI) or a solver timeout "
+                     "(Forces with enable_timeout). Racing is disabled.");
+            _racing = false;
+        }
+        _scoreboard = std::make_unique<PlannerScoreboard>(CONFIG["t-mpc"]["racing"]["time_share"].as<double>() * _planning_time);
+
+        if (_guidance_rate > 0. && !(_use_tmpcpp && global_guidance_->GetConfig()->n_paths_ == 0))
+        {
+            LOG_VALUE("Guidance rate [Hz]", _guidance_rate);
+            _guidance_thread = std::thread(&GuidanceConstraints::runGuidanceThread, this);
+        }
+
         LOG_INITIALIZED();
     }
 
+    GuidanceConstraints::~GuidanceConstraints()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_guidance_mutex);
+            _stop_guidance = true;
+        }
+        _guidance_cv.notify_all();
+
+        if (_guidance_thread.joinable())
+            _guidance_thread.join();
+    }
+
     void GuidanceConstraints::update(State &state, const RealTimeData &data, ModuleData &module_data)
     {
         (void)data;
@@ -79,37 +134,53 @@ namespace MPCPlanner
             {
                 halfspaces.emplace_back(module_data.static_obstacles[0][i].A, module_data.static_obstacles[0][i].b);
             }
-            global_guidance_->LoadStaticObstacles(halfspaces); // Load static obstacles represented by halfspaces
+            setGuidanceInput("static obstacles", [this, halfspaces]()
+                             { global_guidance_->LoadStaticObstacles(halfspaces); }); // Load static obstacles represented by halfspaces
         }
 
         if (_use_tmpcpp && global_guidance_->GetConfig()->n_paths_ == 0) // No global guidance
             return;
 
         // Set the goals of the global guidance planner
-        global_guidance_->SetStart(state.getPos(), state.get("psi"), state.get("v"));
-
-        if (module_data.path_velocity != nullptr)
-            global_guidance_->SetReferenceVelocity(module_data.path_velocity->operator()(state.get("spline")));
-        else
-            global_guidance_->SetReferenceVelocity(CONFIG["weights"]["reference_velocity"].as<double>());
+        Eigen::Vector2d start = state.getPos();
+        double start_psi = state.get("psi"), start_v = state.get("v");
+        auto stamp = data.planning_start_time;
+        setGuidanceInput("start", [this, start, start_psi, start_v, stamp]()
+                         {
+            global_guidance_->SetStart(start, start_psi, start_v);
+            _start_stamp = stamp;
+            _has_start = true; });
+
+        double reference_velocity = module_data.path_velocity != nullptr ? module_data.path_velocity->operator()(state.get("spline"))
+                                                                         : CONFIG["weights"]["reference_velocity"].as<double>();
+        setGuidanceInput("reference velocity", [this, reference_velocity]()
+                         { global_guidance_->SetReferenceVelocity(reference_velocity); });
 
         if (!CONFIG["enable_output"].as<bool>())
         {
             LOG_INFO_THROTTLE(15000, "Not propagating nodes (output is disabled)");
-            global_guidance_->DoNotPropagateNodes();
+            setGuidanceInput("do not propagate", [this]()
+                             { global_guidance_->DoNotPropagateNodes(); });
         }
 
         // Set the goals for the guidance planner
         setGoals(state, module_data);
 
-        LOG_MARK("Running Guidance Search");
-        global_guidance_->Update(); /** @note The main update */
+        if (_guidance_rate <= 0.)
+        {
+            LOG_MARK("Running Guidance Search");
+            searchGuidance(); /** @note The main update */
+        }
+
+        // Use the latest guidance trajectories in this cycle
+        {
+            std::lock_guard<std::mutex> lock(_guidance_mutex);
+            _guidance = _latest_guidance;
+        }
 
         mapGuidanceTrajectoriesToPlanners();
 
         // LOG_VALUE("Number of Guidance Trajectories", global_guidance_->NumberOfGuidanceTrajectories());
-        empty_data_ = data;
-        empty_data_.dynamic_obstacles.clear();
     }
 
     void GuidanceConstraints::setGoals(State &state, const ModuleData &module_data)
@@ -121,9 +192,11 @@ namespace MPCPlanner
 
         if (module_data.path_velocity == nullptr || module_data.path_width_left == nullptr || module_data.path_width_right == nullptr)
         {
-            global_guidance_->LoadReferencePath(std::max(0., state.get("spline")), module_data.path,
-                                                CONFIG["road"]["width"].as<double>() / 2. - robot_radius - 0.1,
-                                                CONFIG["road"]["width"].as<double>() / 2. - robot_radius - 0.1);
+            double s = std::max(0., state.get("spline"));
+            double width = CONFIG["road"]["width"].as<double>() / 2. - robot_radius - 0.1;
+            auto path = module_data.path;
+            setGuidanceInput("goals", [this, s, path, width]()
+                             { global_guidance_->LoadReferencePath(s, path, width, width); });
             return;
         }
 
@@ -154,9 +227,9 @@ namespace MPCPlanner
             double long_cost = std::abs(s - long_best);
 
             // Compute the normal vector to the reference path
-            Eigen::Vector2d line_point = module_data.path->getPoint(s);
-            Eigen::Vector2d normal = module_data.path->getOrthogonal(s);
-            double angle = module_data.path->getPathAngle(s);
+            Eigen::Vector2d line_point = module_data.path_table->getPoint(s);
+            Eigen::Vector2d normal = module_data.path_table->getOrthogonal(s);
+            double angle = module_data.path_table->getPathAngle(s);
 
             // Place goals orthogonally to the path
             std::vector<double> dist_lat = RosTools::linspace(-module_data.path_width_left->operator()(s) + robot_radius,
@@ -186,7 +259,101 @@ namespace MPCPlanner
             }
         }
 
-        global_guidance_->SetGoals(goals);
+        setGuidanceInput("goals", [this, goals]()
+                         { global_guidance_->SetGoals(goals); });
+    }
+
+    void GuidanceConstraints::setGuidanceInput(const std::string &name, std::function<void()> &&input)
+    {
+        if (_guidance_rate <= 0.) // The search runs in this thread
+        {
+            input();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_guidance_mutex);
+        for (auto &pending_input : _pending_inputs)
+        {
+            if (pending_input.first == name)
+            {
+                pending_input.second = std::move(input);
+                return;
+            }
+        }
+        _pending_inputs.emplace_back(name, std::move(input));
+    }
+
+    void GuidanceConstraints::searchGuidance()
+    {
+        PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> search_lock(_search_mutex);
+
+        std::vector<std::pair<std::string, std::function<void()>>> inputs;
+        {
+            std::lock_guard<std::mutex> lock(_guidance_mutex);
+            inputs.swap(_pending_inputs);
+        }
+        for (auto &input : inputs)
+            input.second();
+
+        // Load the latest obstacles, the control thread writes into the other buffer meanwhile
+        int buffer;
+        {
+            std::lock_guard<std::mutex> lock(_guidance_mutex);
+            buffer = _obstacles_ready;
+            _obstacles_ready = -1;
+            _obstacles_loading = buffer;
+        }
+        if (buffer >= 0)
+        {
+            global_guidance_->LoadObstacles(_obstacle_buffers[buffer], {});
+
+            std::lock_guard<std::mutex> lock(_guidance_mutex);
+            _obstacles_loading = -1;
+        }
+
+        if (!_has_start) // No state received yet
+            return;
+
+        global_guidance_->Update();
+
+        // Copy the guidance trajectories, such that the planners do not access the guidance planner
+        auto snapshot = std::make_shared<GuidanceSnapshot>();
+        snapshot->version = ++_guidance_version;
+        snapshot->stamp = _start_stamp;
+        snapshot->succeeded = global_guidance_->Succeeded();
+        snapshot->runtime = global_guidance_->GetLastRuntime();
+        for (int i = 0; i < global_guidance_->NumberOfGuidanceTrajectories(); i++)
+        {
+            auto &guidance_trajectory = global_guidance_->GetGuidanceTrajectory(i);
+            snapshot->trajectories.push_back({guidance_trajectory.topology_class, guidance_trajectory.color_,
+                                              guidance_trajectory.previously_selected_,
+                                              guidance_trajectory.spline.GetTrajectory()});
+        }
+
+        std::lock_guard<std::mutex> lock(_guidance_mutex);
+        _latest_guidance = snapshot;
+    }
+
+    void GuidanceConstraints::runGuidanceThread()
+    {
+        auto period = std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(1. / _guidance_rate));
+        auto next_search = std::chrono::system_clock::now();
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_guidance_mutex);
+                if (_guidance_cv.wait_until(lock, next_search, [this]()
+                                            { return _stop_guidance; }))
+                    return;
+            }
+
+            next_search += period;
+            searchGuidance();
+
+            if (next_search < std::chrono::system_clock::now()) // Do not catch up on missed searches
+                next_search = std::chrono::system_clock::now();
+        }
     }
 
     void GuidanceConstraints::mapGuidanceTrajectoriesToPlanners()
@@ -202,9 +369,9 @@ namespace MPCPlanner
         }
         _map_homotopy_class_to_planner.clear();
 
-        for (int i = 0; i < global_guidance_->NumberOfGuidanceTrajectories(); i++)
+        for (int i = 0; i < numGuidanceTrajectories(); i++)
         {
-            int homotopy_class = global_guidance_->GetGuidanceTrajectory(i).topology_class;
+            int homotopy_class = _guidance->trajectories[i].topology_class;
             // LOG_VALUE("Homotopy Class", homotopy_class);
 
             // Does it match any of the planners?
@@ -264,33 +431,57 @@ namespace MPCPlanner
     int GuidanceConstraints::optimize(State &state, const RealTimeData &data, ModuleData &module_data)
     {
         PROFILE_FUNCTION();
-        // Required for parallel call to the solvers when using Forces
-        omp_set_nested(1);
-        omp_set_max_active_levels(2);
-        omp_set_dynamic(0);
         LOG_MARK("Guidance Constraints: optimize");
 
-        if (!_use_tmpcpp && !global_guidance_->Succeeded())
+        if (!_use_tmpcpp && (_guidance == nullptr || !_guidance->succeeded))
             return 0;
 
+        auto cycle_start = std::chrono::system_clock::now();
+
         bool shift_forward = CONFIG["shift_previous_solution_forward"].as<bool>() &&
                              CONFIG["enable_output"].as<bool>();
 
-#pragma omp parallel for num_threads(8)
-        for (auto &planner : planners_)
+        // Only enable the solvers that are needed (and fit in the planning time), the original planner always runs
+        int n_guided = numGuidedPlanners(data);
+        _active_planners.clear();
+        for (size_t p = 0; p < planners_.size(); p++)
         {
-            PROFILE_SCOPE("Guidance Constraints: Parallel Optimization");
+            auto &planner = planners_[p];
             planner.result.Reset();
-            planner.disabled = false;
+            planner.disabled = !planner.is_original_planner && planner.id >= n_guided;
 
-            if (planner.id >= global_guidance_->NumberOfGuidanceTrajectories()) // Only enable the solvers that are needed
-            {
-                if (!planner.is_original_planner) // We still want to add the original planner!
-                {
-                    planner.disabled = true;
-                    continue;
-                }
-            }
+            if (!planner.disabled)
+                _active_planners.push_back(p);
+        }
+
+        LOG_MARK("Running " << n_guided << " of " << numGuidanceTrajectories() << " guided planners"
+                            << (_use_tmpcpp ? " and the non-guided planner" : ""));
+
+        _scoreboard->reset();
+
+        // Racing without early termination caps the solve time of all planners but one, which keeps the full time to fall
+        // back on: the non-guided planner, otherwise the planner that follows the previously selected guidance
+        int fallback_planner = -1;
+        for (int p : _active_planners)
+        {
+            if (planners_[p].is_original_planner)
+                fallback_planner = p;
+            else if (fallback_planner == -1 && _guidance != nullptr && _guidance->trajectories[planners_[p].id].previously_selected)
+                fallback_planner = p;
+        }
+        if (fallback_planner == -1 && !_active_planners.empty())
+            fallback_planner = _active_planners.front();
+
+        // The guidance trajectories start at the planning start time of the cycle that started their search
+        double guidance_time_offset = 0.;
+        if (_guidance != nullptr)
+            guidance_time_offset = std::max(std::chrono::duration<double>(data.planning_start_time - _guidance->stamp).count(), 0.);
+
+        _pool->parallelFor(_active_planners.size(), [&](int i)
+                           {
+            PROFILE_SCOPE("Guidance Constraints: Parallel Optimization");
+            auto &planner = planners_[_active_planners[i]];
+            auto planner_start = std::chrono::system_clock::now();
 
             // Copy the data from the main solver
             auto &solver = planner.local_solver;
@@ -300,8 +491,8 @@ namespace MPCPlanner
             // CONSTRUCT CONSTRAINTS
             if (planner.is_original_planner || (!_enable_constraints))
             {
-                planner.guidance_constraints->update(state, empty_data_, module_data);
-                planner.safety_constraints->update(state, data, module_data); // Updates collision avoidance constraints
+                planner.guidance_constraints->update(state, data, module_data); // Without obstacles
+                planner.safety_constraints->update(state, data, module_data);   // Updates collision avoidance constraints
             }
             else
             {
@@ -310,7 +501,7 @@ namespace MPCPlanner
                 if (CONFIG["t-mpc"]["warmstart_with_mpc_solution"].as<bool>() && planner.existing_guidance)
                     planner.local_solver->initializeWarmstart(state, shift_forward);
                 else
-                    initializeSolverWithGuidance(planner);
+                    initializeSolverWithGuidance(planner, guidance_time_offset);
 
                 planner.guidance_constraints->update(state, data, module_data); // Updates linearization of constraints
                 planner.safety_constraints->update(state, data, module_data);   // Updates collision avoidance constraints
@@ -320,11 +511,7 @@ namespace MPCPlanner
             LOG_MARK("Planner [" << planner.id << "]: Loading updated parameters into the solver");
             for (int k = 0; k < _solver->N; k++)
             {
-                if (planner.is_original_planner)
-                    planner.guidance_constraints->setParameters(empty_data_, module_data, k); // Set this solver's parameters
-                else
-                    planner.guidance_constraints->setParameters(data, module_data, k); // Set this solver's parameters
-
+                planner.guidance_constraints->setParameters(data, module_data, k); // Set this solver's parameters
                 planner.safety_constraints->setParameters(data, module_data, k);
             }
 
@@ -332,6 +519,26 @@ namespace MPCPlanner
             std::chrono::duration<double> used_time = std::chrono::system_clock::now() - data.planning_start_time;
             planner.local_solver->_params.solver_timeout = _planning_time - used_time.count() - 0.006;
 
+            // Racing: stop after the time share once another planner found a feasible solution
+            bool capped = false;
+#ifdef ACADOS_SOLVER
+            if (_racing && solver->canTerminateEarly())
+            {
+                solver->setEarlyTermination([this, planner_start](int iteration)
+                                            {
+                    (void)iteration;
+                    std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - planner_start;
+                    return _scoreboard->shouldCancel(elapsed.count()); });
+            }
+            else
+#endif
+            if (_racing && _active_planners[i] != fallback_planner) // Cannot be stopped: limit the solve time to the time share
+            {
+                capped = _scoreboard->getTimeShare() < planner.local_solver->_params.solver_timeout;
+                planner.local_solver->_params.solver_timeout = std::min(planner.local_solver->_params.solver_timeout,
+                                                                        _scoreboard->getTimeShare());
+            }
+
             // SOLVE OPTIMIZATION
             // if (enable_guidance_warmstart_)
             planner.local_solver->loadWarmstart();
@@ -351,16 +558,34 @@ namespace MPCPlanner
             }
             else
             {
-                auto &guidance_trajectory = global_guidance_->GetGuidanceTrajectory(planner.id); // planner.local_solver->_solver_id);
-                planner.result.guidance_ID = guidance_trajectory.topology_class;                 // We were using this guidance
-                planner.result.color = guidance_trajectory.color_;                               // A color index to visualize with
+                auto &guidance_trajectory = _guidance->trajectories[planner.id]; // planner.local_solver->_solver_id);
+                planner.result.guidance_ID = guidance_trajectory.topology_class; // We were using this guidance
+                planner.result.color = guidance_trajectory.color;                // A color index to visualize with
 
-                if (guidance_trajectory.previously_selected_) // Prefer the selected trajectory
+                if (guidance_trajectory.previously_selected) // Prefer the selected trajectory
                     planner.result.objective *= global_guidance_->GetConfig()->selection_weight_consistency_;
             }
-        }
 
-        omp_set_dynamic(1);
+            bool cancelled = capped && planner.result.exit_code == 2; // Timed out at the time share
+#ifdef ACADOS_SOLVER
+            cancelled = cancelled || planner.result.exit_code == EXIT_CODE_CANCELLED;
+#endif
+            if (planner.result.success)
+                _scoreboard->reportSolution();
+            else if (cancelled)
+                _scoreboard->reportCancelled();
+
+            planner.solve_time = std::chrono::duration<double>(std::chrono::system_clock::now() - planner_start).count(); });
+
+        // Moving estimate of the time per planner
+        double cycle_solve_time = 0.;
+        for (int p : _active_planners)
+            cycle_solve_time = std::max(cycle_solve_time, planners_[p].solve_time);
+        _solve_time_estimate = _solve_time_estimate == 0. ? cycle_solve_time : 0.8 * _solve_time_estimate + 0.2 * cycle_solve_time;
+
+        logCycleTime(std::chrono::duration<double>(std::chrono::system_clock::now() - cycle_start).count());
+        if (_racing)
+            LOG_MARK("Cancelled " << _scoreboard->numCancelled() << " of " << _active_planners.size() << " planners");
 
         {
             PROFILE_SCOPE("Decision");
@@ -377,7 +602,10 @@ namespace MPCPlanner
             // LOG_INFO("Best Planner ID: " << best_planner.id);
 
             // Communicate to the guidance which topology class we follow (none if it was the original planner)
-            global_guidance_->OverrideSelectedTrajectory(best_planner.result.guidance_ID, best_planner.is_original_planner);
+            int guidance_ID = best_planner.result.guidance_ID;
+            bool is_original_planner = best_planner.is_original_planner;
+            setGuidanceInput("selected trajectory", [this, guidance_ID, is_original_planner]()
+                             { global_guidance_->OverrideSelectedTrajectory(guidance_ID, is_original_planner); });
 
             _solver->_output = best_solver->_output; // Load the solution into the main lmpcc solver
             _solver->_info = best_solver->_info;
@@ -387,13 +615,52 @@ namespace MPCPlanner
         }
     }
 
-    void GuidanceConstraints::initializeSolverWithGuidance(LocalPlanner &planner)
+    int GuidanceConstraints::numGuidedPlanners(const RealTimeData &data) const
+    {
+        int n_guided = std::min(numGuidanceTrajectories(), global_guidance_->GetConfig()->n_paths_);
+        if (!_adaptive_planner_count || _solve_time_estimate <= 0.)
+            return n_guided;
+
+        // Planners run in rounds of one planner per thread, count the rounds that fit in the remaining time
+        std::chrono::duration<double> used_time = std::chrono::system_clock::now() - data.planning_start_time;
+        double remaining_time = _planning_time - used_time.count() - 0.006;
+        int n_rounds = std::max((int)(remaining_time / _solve_time_estimate), 1);
+
+        int n_fit = n_rounds * _pool->numThreads() - (_use_tmpcpp ? 1 : 0); // The non-guided planner always runs
+        if (!_use_tmpcpp)
+            n_fit = std::max(n_fit, 1); // At least one planner
+
+        return std::max(std::min(n_guided, n_fit), 0);
+    }
+
+    void GuidanceConstraints::logCycleTime(double cycle_time)
+    {
+        const size_t window = 100;
+        if (_cycle_times.size() < window)
+            _cycle_times.push_back(cycle_time);
+        else
+            _cycle_times[_cycle_index] = cycle_time;
+        _cycle_index = (_cycle_index + 1) % window;
+
+        std::vector<double> sorted_times = _cycle_times;
+        std::sort(sorted_times.begin(), sorted_times.end());
+        auto percentile = [&](double p)
+        { return 1e3 * sorted_times[std::min((size_t)(p * sorted_times.size()), sorted_times.size() - 1)]; };
+
+        LOG_INFO_THROTTLE(5000, "Guidance cycle time [ms] over the last " << sorted_times.size() << " cycles: p50 = " << percentile(0.5)
+                                                                         << ", p90 = " << percentile(0.9) << ", p99 = " << percentile(0.99)
+                                                                         << " (" << _active_planners.size() << " planners, "
+                                                                         << 1e3 * _solve_time_estimate << " ms per planner)");
+    }
+
+    void GuidanceConstraints::initializeSolverWithGuidance(LocalPlanner &planner, double time_offset)
     {
         auto &solver = planner.local_solver;
 
         // // Initialize the solver with the guidance trajectory
         // RosTools::CubicSpline2D<tk::spline> &trajectory_spline = global_guidance_->GetGuidanceTrajectory(solver->_solver_id).spline.GetTrajectory();
-        RosTools::Spline2D &trajectory_spline = global_guidance_->GetGuidanceTrajectory(planner.id).spline.GetTrajectory();
+        RosTools::Spline2D &trajectory_spline = _guidance->trajectories[planner.id].spline;
+        double end_time = (global_guidance_->GetConfig()->N - 1) * solver->dt;
 
         // Initialize the solver in the selected local optimum
         // I.e., set for each k, x(k), y(k) ...
@@ -402,12 +669,13 @@ namespace MPCPlanner
         {
             // int index = k + 1;
             int index = k;
-            Eigen::Vector2d cur_position = trajectory_spline.getPoint((double)(index)*solver->dt); // The plan is one ahead
+            double t = std::min(time_offset + (double)(index)*solver->dt, end_time); // Re-timed to this cycle
+            Eigen::Vector2d cur_position = trajectory_spline.getPoint(t);              // The plan is one ahead
             // global_guidance_->ProjectToFreeSpace(cur_position, k + 1);
             solver->setEgoPrediction(k, "x", cur_position(0));
             solver->setEgoPrediction(k, "y", cur_position(1));
 
-            Eigen::Vector2d cur_velocity = trajectory_spline.getVelocity((double)(index)*solver->dt); // The plan is one ahead
+            Eigen::Vector2d cur_velocity = trajectory_spline.getVelocity(t); // The plan is one ahead
             solver->setEgoPrediction(k, "psi", std::atan2(cur_velocity(1), cur_velocity(0)));
             solver->setEgoPrediction(k, "v", cur_velocity.norm());
         }
@@ -442,8 +710,18 @@ namespace MPCPlanner
         LOG_MARK("Guidance Constraints: Visualize()");
 
         // global_guidance_->Visualize(highlight_selected_guidance_, visualized_guidance_trajectory_nr_);
-        if (!(_use_tmpcpp && global_guidance_->GetConfig()->n_paths_ == 0)) // If global guidance
-            global_guidance_->Visualize(CONFIG["t-mpc"]["highlight_selected"].as<bool>(), -1);
+        // If global guidance (in this thread). Its markers are published together, gated on the main guidance topic
+        if (!(_use_tmpcpp && global_guidance_->GetConfig()->n_paths_ == 0) && _guidance_rate <= 0.)
+        {
+            if (shouldVisualize("guidance_planner/trajectories"))
+                global_guidance_->Visualize(CONFIG["t-mpc"]["highlight_selected"].as<bool>(), -1);
+        }
+        else if (_guidance_rate > 0. && _guidance != nullptr && shouldVisualize(_name + "/guidance_trajectories"))
+            visualizeGuidanceSnapshot(*_guidance); // The guidance planner itself is in use by the guidance thread
+
+        double robot_radius = CONFIG["robot_radius"].as<double>();
+        bool visualize_warmstart = CONFIG["debug_visuals"].as<bool>() && shouldVisualize(_name + "/warmstart_trajectories");
+        bool visualize_optimized = shouldVisualize(_name + "/optimized_trajectories");
         for (size_t i = 0; i < planners_.size(); i++)
         {
             auto &planner = planners_[i];
@@ -457,39 +735,59 @@ namespace MPCPlanner
             }
 
             // Visualize the warmstart
-            if (CONFIG["debug_visuals"].as<bool>())
+            if (visualize_warmstart)
             {
                 Trajectory initial_trajectory;
                 for (int k = 1; k < planner.local_solver->N; k++)
                     initial_trajectory.add(planner.local_solver->getEgoPrediction(k, "x"), planner.local_solver->getEgoPrediction(k, "y"));
-                visualizeTrajectory(initial_trajectory, _name + "/warmstart_trajectories", false, 0.2, 20, 20);
+                visualizeTrajectory(initial_trajectory, _name + "/warmstart_trajectories", robot_radius, false, 0.2, 20, 20);
             }
 
             // Visualize the optimized trajectory
-            if (planner.result.success)
+            if (visualize_optimized && planner.result.success)
             {
                 Trajectory trajectory;
                 for (int k = 1; k < _solver->N; k++)
                     trajectory.add(planner.local_solver->getOutput(k, "x"), planner.local_solver->getOutput(k, "y"));
 
                 if ((int)i == best_planner_index_)
-                    visualizeTrajectory(trajectory, _name + "/optimized_trajectories", false, 1.0, -1, 12, true, false);
+                    visualizeTrajectory(trajectory, _name + "/optimized_trajectories", robot_radius, false, 1.0, -1, 12, true, false);
                 else if (planner.is_original_planner)
-                    visualizeTrajectory(trajectory, _name + "/optimized_trajectories", false, 1.0, 11, 12, true, false);
+                    visualizeTrajectory(trajectory, _name + "/optimized_trajectories", robot_radius, false, 1.0, 11, 12, true, false);
                 else
-                    visualizeTrajectory(trajectory, _name + "/optimized_trajectories", false, 1.0, planner.result.color, global_guidance_->GetConfig()->n_paths_, true, false);
+                    visualizeTrajectory(trajectory, _name + "/optimized_trajectories", robot_radius, false, 1.0, planner.result.color, global_guidance_->GetConfig()->n_paths_, true, false);
                 // else if (!planner.existing_guidance) // Visualizes new homotopy classes
-                // visualizeTrajectory(trajectory, _name + "/optimized_trajectories", false, 0.2, 11, 12, true, false);
+                // visualizeTrajectory(trajectory, _name + "/optimized_trajectories", robot_radius, false, 0.2, 11, 12, true, false);
             }
         }
 
         {
-            VISUALS.getPublisher(_name + "/optimized_trajectories").publish();
-            if (CONFIG["debug_visuals"].as<bool>())
+            if (visualize_optimized)
+                VISUALS.getPublisher(_name + "/optimized_trajectories").publish();
+            if (visualize_warmstart)
                 VISUALS.getPublisher(_name + "/warmstart_trajectories").publish();
         }
     }
 
+    void GuidanceConstraints::visualizeGuidanceSnapshot(const GuidanceSnapshot &snapshot)
+    {
+        auto &publisher = VISUALS.getPublisher(_name + "/guidance_trajectories");
+        double robot_radius = CONFIG["robot_radius"].as<double>();
+        for (auto &guidance_trajectory : snapshot.trajectories)
+        {
+            Trajectory trajectory;
+            for (double t = 0.; t <= guidance_trajectory.spline.parameterLength(); t += _solver->dt)
+                trajectory.add(guidance_trajectory.spline.getPoint(t));
+
+            if (_highlight_selected && guidance_trajectory.previously_selected)
+                visualizeTrajectory(trajectory, _name + "/guidance_trajectories", robot_radius, false, 1.0, -1, 12, true, false);
+            else
+                visualizeTrajectory(trajectory, _name + "/guidance_trajectories", robot_radius, false, 0.6, guidance_trajectory.color,
+                                    global_guidance_->GetConfig()->n_paths_, true, false);
+        }
+        publisher.publish();
+    }
+
     bool GuidanceConstraints::isDataReady(const RealTimeData &data, std::string &missing_data)
     {
         (void)data;
@@ -533,27 +831,62 @@ namespace MPCPlanner
                 planner.safety_constraints->onDataReceived(data, std::forward<std::string>(data_name));
             }
 
-            std::vector<GuidancePlanner::Obstacle> obstacles;
-            for (auto &obstacle : data.dynamic_obstacles)
+            // Write into the buffer that the guidance planner is not loading
+            int buffer;
+            {
+                std::lock_guard<std::mutex> lock(_guidance_mutex);
+                buffer = _obstacles_loading == 0 ? 1 : 0;
+                if (_obstacles_ready == buffer) // Replaced before it was loaded
+                    _obstacles_ready = -1;
+            }
+
+            auto &obstacles = _obstacle_buffers[buffer];
+            size_t num_obstacles = data.dynamic_obstacles.size();
+            if (obstacles.size() > num_obstacles)
+                obstacles.erase(obstacles.begin() + num_obstacles, obstacles.end());
+            while (obstacles.size() < num_obstacles)
+                obstacles.emplace_back(0, std::vector<Eigen::Vector2d>(), 0.);
+
+            for (size_t i = 0; i < num_obstacles; i++)
             {
+                auto &obstacle = data.dynamic_obstacles[i];
+                auto &guidance_obstacle = obstacles[i];
+
+                guidance_obstacle.id_ = obstacle.index;
+                guidance_obstacle.radius_ = obstacle.radius + data.robot_area[0].radius;
 
-                std::vector<Eigen::Vector2d> positions;
+                auto &positions = guidance_obstacle.positions_; // Keeps its capacity
+                positions.clear();
                 positions.push_back(obstacle.position); /** @note Strange that we need k = 0 here */
 
                 for (size_t k = 0; k < obstacle.prediction.modes[0].size(); k++) // std::max(obstacle.prediction.modes[0].size(), (size_t)GuidancePlanner::Config::N); k++)
                 {
                     positions.push_back(obstacle.prediction.modes[0][k].position);
                 }
-                obstacles.emplace_back(obstacle.index, positions, obstacle.radius + data.robot_area[0].radius);
             }
-            global_guidance_->LoadObstacles(obstacles, {});
+
+            {
+                std::lock_guard<std::mutex> lock(_guidance_mutex);
+                _obstacles_ready = buffer; // Loaded before the next search
+            }
         }
     }
 
     void GuidanceConstraints::reset()
     {
         // _spline.reset(nullptr);
-        global_guidance_->Reset();
+        {
+            std::lock_guard<std::mutex> lock(_guidance_mutex);
+            _pending_inputs.clear(); // Inputs before the reset are outdated
+            _obstacles_ready = -1;
+            _latest_guidance = nullptr;
+        }
+        _guidance = nullptr;
+
+        setGuidanceInput("reset", [this]()
+                         {
+            global_guidance_->Reset();
+            _has_start = false; });
 
         for (auto &planner : planners_)
             planner.local_solver->reset();
@@ -561,7 +894,7 @@ namespace MPCPlanner
 
     void GuidanceConstraints::saveData(RosTools::DataSaver &data_saver)
     {
-        data_saver.AddData("runtime_guidance", global_guidance_->GetLastRuntime());
+        data_saver.AddData("runtime_guidance", _guidance != nullptr ? _guidance->runtime : 0.);
         for (size_t i = 0; i < planners_.size(); i++) // auto &solver : solvers_)
         {
             auto &planner = planners_[i];
@@ -591,6 +924,7 @@ namespace MPCPlanner
 
         data_saver.AddData("gmpcc_objective", best_objective);
 
-        global_guidance_->saveData(data_saver); // Save data from the guidance planner
+        std::lock_guard<std::mutex> lock(_search_mutex); // Waits for a running guidance search
+        global_guidance_->saveData(data_saver);          // Save data from the guidance planner
     }
 } // namespace MPCPlanner
\ No newline at end of file
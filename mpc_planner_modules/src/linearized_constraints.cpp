@@ -12,7 +12,8 @@
 namespace MPCPlanner
 {
   LinearizedConstraints::LinearizedConstraints(std::shared_ptr<Solver> solver)
-      : ControllerModule(ModuleType::CONSTRAINT, solver, "linearized_constraints")
+      : ControllerModule(ModuleType::CONSTRAINT, solver, "linearized_constraints"),
+        _screening(CONFIG["max_obstacles"].as<int>(), solver->_model_map)
   {
     LOG_INITIALIZE("Linearized Constraints");
     _n_discs = CONFIG["n_discs"].as<int>(); // Is overwritten to 1 for topology constraints
@@ -20,20 +21,22 @@ namespace MPCPlanner
     _n_other_halfspaces = CONFIG["linearized_constraints"]["add_halfspaces"].as<int>();
     _max_obstacles = CONFIG["max_obstacles"].as<int>();
     int n_constraints = _max_obstacles + _n_other_halfspaces;
-    _a1.resize(CONFIG["n_discs"].as<int>());
-    _a2.resize(CONFIG["n_discs"].as<int>());
-    _b.resize(CONFIG["n_discs"].as<int>());
-    for (int d = 0; d < CONFIG["n_discs"].as<int>(); d++)
+    _halfspaces.resize(CONFIG["n_discs"].as<int>(), CONFIG["N"].as<int>(), n_constraints);
+
+    _obstacle_x.resize(_max_obstacles);
+    _obstacle_y.resize(_max_obstacles);
+    _obstacle_offset.resize(_max_obstacles);
+
+    _reuse_halfspaces = CONFIG["linearized_constraints"]["reuse_halfspaces"].as<bool>();
+    _reuse_tolerance = CONFIG["linearized_constraints"]["reuse_tolerance"].as<double>();
+    if (_reuse_halfspaces)
     {
-      _a1[d].resize(CONFIG["N"].as<int>());
-      _a2[d].resize(CONFIG["N"].as<int>());
-      _b[d].resize(CONFIG["N"].as<int>());
-      for (int k = 0; k < CONFIG["N"].as<int>(); k++)
-      {
-        _a1[d][k] = Eigen::ArrayXd(n_constraints);
-        _a2[d][k] = Eigen::ArrayXd(n_constraints);
-        _b[d][k] = Eigen::ArrayXd(n_constraints);
-      }
+      _cache.resize(CONFIG["n_discs"].as<int>() * CONFIG["N"].as<int>() * _max_obstacles);
+      _prev_cache.resize(_cache.size());
+
+      for (auto *buffer : {&_recompute_x, &_recompute_y, &_recompute_offset, &_recompute_a1, &_recompute_a2, &_recompute_b})
+        buffer->resize(_max_obstacles);
+      _recompute.reserve(_max_obstacles);
     }
 
     _num_obstacles = 0;
@@ -49,17 +52,59 @@ namespace MPCPlanner
   void LinearizedConstraints::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
     (void)state;
+    PROFILE_SCOPE("LinearizedConstraints::update");
     LOG_MARK("LinearizedConstraints::update");
 
     _dummy_b = state.get("x") + 100.;
 
-    // Thread safe
-    std::vector<DynamicObstacle> copied_obstacles = data.dynamic_obstacles;
-    _num_obstacles = copied_obstacles.size();
+    // Read-only, such that parallel planners can share the obstacles
+    const std::vector<DynamicObstacle> &copied_obstacles = _obstacles != nullptr ? *_obstacles : data.dynamic_obstacles;
+    _num_obstacles = std::min((int)copied_obstacles.size(), _max_obstacles);
+    double robot_radius = CONFIG["robot_radius"].as<double>();
+
+    // Only obstacles that can be reached get a constraint
+    _ego_positions.resize(_solver->N);
+    for (int k = 0; k < _solver->N; k++)
+      _ego_positions[k] = _solver->getEgoPredictionPosition(k);
+
+    _screening.update(_ego_positions, copied_obstacles, data.robot_area, robot_radius, _solver->dt);
+
+    if (_reuse_halfspaces)
+    {
+      // Match the obstacles to the previous cycle by ID
+      _cache.swap(_prev_cache);
+      _ids.swap(_prev_ids);
+
+      _ids.resize(_num_obstacles);
+      _prev_slot.resize(_num_obstacles);
+      for (int obs_id = 0; obs_id < _num_obstacles; obs_id++)
+      {
+        _ids[obs_id] = copied_obstacles[obs_id].index;
+
+        auto it = std::find(_prev_ids.begin(), _prev_ids.end(), _ids[obs_id]);
+        bool found = _ids[obs_id] >= 0 && it != _prev_ids.end(); // Dummies (ID -1) are not matched
+        _prev_slot[obs_id] = found ? (int)(it - _prev_ids.begin()) : -1;
+      }
+
+      _num_reused = 0;
+      _num_computed = 0;
+    }
 
     // For all stages
     for (int k = 1; k < _solver->N; k++)
     {
+      // Gather the obstacles of this stage for the halfspace kernel
+      for (int obs_id = 0; obs_id < _num_obstacles; obs_id++)
+      {
+        const auto &copied_obstacle = copied_obstacles[obs_id];
+        const Eigen::Vector2d &obstacle_pos = copied_obstacle.prediction.modes[0][k - 1].position;
+
+        _obstacle_x[obs_id] = obstacle_pos(0);
+        _obstacle_y[obs_id] = obstacle_pos(1);
+        _obstacle_offset[obs_id] = (_use_guidance ? 1e-3 : copied_obstacle.radius) + robot_radius;
+      }
+      _projection.setObstacles(_obstacle_x.data(), _obstacle_y.data(), _obstacle_offset.data(), _num_obstacles);
+
       for (int d = 0; d < _n_discs; d++)
       {
         Eigen::Vector2d pos(_solver->getEgoPrediction(k, "x"), _solver->getEgoPrediction(k, "y")); // k = 0 is initial state
@@ -69,7 +114,7 @@ namespace MPCPlanner
           auto &disc = data.robot_area[d];
 
           Eigen::Vector2d disc_pos = disc.getPosition(pos, _solver->getEgoPrediction(k, "psi"));
-          projectToSafety(copied_obstacles, k, disc_pos); // Ensure that the vehicle position is collision-free
+          _projection.project(disc_pos); // Ensure that the vehicle position is collision-free
 
           /** @todo Set projected disc position */
 
@@ -77,32 +122,18 @@ namespace MPCPlanner
         }
         else // Use the robot position
         {
-          projectToSafety(copied_obstacles, k, pos); // Ensure that the vehicle position is collision-free
+          _projection.project(pos); // Ensure that the vehicle position is collision-free
           /** @todo Set projected disc position */
         }
 
-        // For all obstacles
-        for (size_t obs_id = 0; obs_id < copied_obstacles.size(); obs_id++)
-        {
-          const auto &copied_obstacle = copied_obstacles[obs_id];
-          const Eigen::Vector2d &obstacle_pos = copied_obstacle.prediction.modes[0][k - 1].position;
-
-          double diff_x = obstacle_pos(0) - pos(0);
-          double diff_y = obstacle_pos(1) - pos(1);
-
-          double dist = (obstacle_pos - pos).norm();
-
-          // Compute the components of A for this obstacle (normalized normal vector)
-          _a1[d][k](obs_id) = diff_x / dist;
-          _a2[d][k](obs_id) = diff_y / dist;
+        if (_reuse_halfspaces)
+          reuseHalfspaces(d, k, pos);
+        else
+          computeHalfspaces(d, k, pos);
 
-          // Compute b (evaluate point on the collision circle)
-          double radius = _use_guidance ? 1e-3 : copied_obstacle.radius;
-
-          _b[d][k](obs_id) = _a1[d][k](obs_id) * obstacle_pos(0) +
-                             _a2[d][k](obs_id) * obstacle_pos(1) -
-                             (radius + CONFIG["robot_radius"].as<double>());
-        }
+        double *a1 = _halfspaces.a1(d, k);
+        double *a2 = _halfspaces.a2(d, k);
+        double *b = _halfspaces.b(d, k);
 
         if (!module_data.static_obstacles.empty() && (int)module_data.static_obstacles[k].size() < _n_other_halfspaces)
         {
@@ -116,35 +147,103 @@ namespace MPCPlanner
           int num_halfspaces = std::min((int)module_data.static_obstacles[k].size(), _n_other_halfspaces);
           for (int h = 0; h < num_halfspaces; h++)
           {
-            int obs_id = copied_obstacles.size() + h;
-            _a1[d][k](obs_id) = module_data.static_obstacles[k][h].A(0);
-            _a2[d][k](obs_id) = module_data.static_obstacles[k][h].A(1);
-            _b[d][k](obs_id) = module_data.static_obstacles[k][h].b;
+            int obs_id = _num_obstacles + h;
+            a1[obs_id] = module_data.static_obstacles[k][h].A(0);
+            a2[obs_id] = module_data.static_obstacles[k][h].A(1);
+            b[obs_id] = module_data.static_obstacles[k][h].b;
           }
         }
       }
     }
+
+    if (_reuse_halfspaces)
+    {
+      LOG_MARK("LinearizedConstraints: reused " << _num_reused << " of " << _num_reused + _num_computed << " halfspaces");
+    }
     LOG_MARK("LinearizedConstraints::update done");
   }
 
-  void LinearizedConstraints::projectToSafety(const std::vector<DynamicObstacle> &copied_obstacles, int k, Eigen::Vector2d &pos)
+  void LinearizedConstraints::computeHalfspaces(int d, int k, const Eigen::Vector2d &pos)
   {
-    if (copied_obstacles.empty()) // There is no anchor
-      return;
+    // Normals and offsets for all obstacles at once
+    computeObstacleHalfspaces(_obstacle_x.data(), _obstacle_y.data(), _obstacle_offset.data(), _num_obstacles, pos,
+                              _halfspaces.a1(d, k), _halfspaces.a2(d, k), _halfspaces.b(d, k));
+  }
 
-    // Project to a collision free position if necessary, considering all the obstacles
-    for (int iterate = 0; iterate < 3; iterate++) // At most 3 iterations
+  void LinearizedConstraints::reuseHalfspaces(int d, int k, const Eigen::Vector2d &pos)
+  {
+    double *a1 = _halfspaces.a1(d, k);
+    double *a2 = _halfspaces.a2(d, k);
+    double *b = _halfspaces.b(d, k);
+
+    _recompute.clear();
+    for (int obs_id = 0; obs_id < _num_obstacles; obs_id++)
     {
-      for (auto &obstacle : copied_obstacles)
+      const CachedHalfspace *cached = findCachedHalfspace(d, k, obs_id, pos);
+      if (cached == nullptr)
       {
-        double radius = _use_guidance ? 1e-3 : obstacle.radius;
-
-        dr_projection_.douglasRachfordProjection(pos, obstacle.prediction.modes[0][k - 1].position,
-                                                 copied_obstacles[0].prediction.modes[0][k - 1].position,
-                                                 radius + CONFIG["robot_radius"].as<double>(),
-                                                 pos);
+        int r = _recompute.size();
+        _recompute_x[r] = _obstacle_x[obs_id];
+        _recompute_y[r] = _obstacle_y[obs_id];
+        _recompute_offset[r] = _obstacle_offset[obs_id];
+        _recompute.push_back(obs_id);
+        continue;
       }
+
+      // Reuse the normal, the offset is recomputed such that the halfspace touches the obstacle at its current position
+      a1[obs_id] = cached->a1;
+      a2[obs_id] = cached->a2;
+      b[obs_id] = cached->a1 * _obstacle_x[obs_id] + cached->a2 * _obstacle_y[obs_id] - _obstacle_offset[obs_id];
+
+      _cache[cacheIndex(d, k, obs_id)] = *cached; // Keep the original positions, to not accumulate changes
+    }
+
+    int num_recompute = _recompute.size();
+    computeObstacleHalfspaces(_recompute_x.data(), _recompute_y.data(), _recompute_offset.data(), num_recompute, pos,
+                              _recompute_a1.data(), _recompute_a2.data(), _recompute_b.data());
+
+    for (int r = 0; r < num_recompute; r++)
+    {
+      int obs_id = _recompute[r];
+      a1[obs_id] = _recompute_a1[r];
+      a2[obs_id] = _recompute_a2[r];
+      b[obs_id] = _recompute_b[r];
+
+      auto &entry = _cache[cacheIndex(d, k, obs_id)];
+      entry.ego_pos = pos;
+      entry.obstacle_pos = Eigen::Vector2d(_obstacle_x[obs_id], _obstacle_y[obs_id]);
+      entry.a1 = a1[obs_id];
+      entry.a2 = a2[obs_id];
+      entry.valid = _ids[obs_id] >= 0;
+    }
+
+    _num_reused += _num_obstacles - num_recompute;
+    _num_computed += num_recompute;
+  }
+
+  const LinearizedConstraints::CachedHalfspace *LinearizedConstraints::findCachedHalfspace(int d, int k, int obs_id,
+                                                                                          const Eigen::Vector2d &pos) const
+  {
+    int prev_slot = _prev_slot[obs_id];
+    if (prev_slot < 0)
+      return nullptr;
+
+    Eigen::Vector2d obstacle_pos(_obstacle_x[obs_id], _obstacle_y[obs_id]);
+
+    // With a shifted warm start, stage k of this cycle corresponds to stage k + 1 of the previous cycle
+    for (int prev_k : {k + 1, k})
+    {
+      if (prev_k >= _solver->N)
+        continue;
+
+      const auto &cached = _prev_cache[cacheIndex(d, prev_k, prev_slot)];
+      if (cached.valid &&
+          (cached.ego_pos - pos).norm() < _reuse_tolerance &&
+          (cached.obstacle_pos - obstacle_pos).norm() < _reuse_tolerance)
+        return &cached;
     }
+
+    return nullptr;
   }
 
   void LinearizedConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
@@ -154,6 +253,12 @@ namespace MPCPlanner
 
     if (k == 0)
     {
+      if (!_use_guidance) // Stage invariant, set once in the stage template
+      {
+        for (int d = 0; d < _n_discs; d++)
+          setSolverParameterEgoDiscOffset(0, _solver->_params, data.robot_area[d].offset, d);
+      }
+
       for (int i = 0; i < _max_obstacles + _n_other_halfspaces; i++)
       {
 
@@ -167,18 +272,37 @@ namespace MPCPlanner
 
     for (int d = 0; d < _n_discs; d++)
     {
-      if (!_use_guidance)
-        setSolverParameterEgoDiscOffset(k, _solver->_params, data.robot_area[d].offset, d);
+      // Stream the rows of this disc and stage
+      const double *a1 = _halfspaces.a1(d, k);
+      const double *a2 = _halfspaces.a2(d, k);
+      const double *b = _halfspaces.b(d, k);
+      for (int i = 0; i < _num_obstacles; i++)
+      {
+        int obstacle_id = _screening.getObstacle(k, i);
+        if (obstacle_id < 0) // Out of reach (inactive)
+        {
+          setSolverParameterLinConstraintA1(k, _solver->_params, _dummy_a1, constraint_counter);
+          setSolverParameterLinConstraintA2(k, _solver->_params, _dummy_a2, constraint_counter);
+          setSolverParameterLinConstraintB(k, _solver->_params, _dummy_b, constraint_counter);
+        }
+        else
+        {
+          setSolverParameterLinConstraintA1(k, _solver->_params, a1[obstacle_id], constraint_counter);
+          setSolverParameterLinConstraintA2(k, _solver->_params, a2[obstacle_id], constraint_counter);
+          setSolverParameterLinConstraintB(k, _solver->_params, b[obstacle_id], constraint_counter);
+        }
+        constraint_counter++;
+      }
 
-      for (size_t i = 0; i < data.dynamic_obstacles.size() + _n_other_halfspaces; i++)
+      for (int i = _num_obstacles; i < _num_obstacles + _n_other_halfspaces; i++) // Static halfspaces
       {
-        setSolverParameterLinConstraintA1(k, _solver->_params, _a1[d][k](i), constraint_counter);
-        setSolverParameterLinConstraintA2(k, _solver->_params, _a2[d][k](i), constraint_counter);
-        setSolverParameterLinConstraintB(k, _solver->_params, _b[d][k](i), constraint_counter);
+        setSolverParameterLinConstraintA1(k, _solver->_params, a1[i], constraint_counter);
+        setSolverParameterLinConstraintA2(k, _solver->_params, a2[i], constraint_counter);
+        setSolverParameterLinConstraintB(k, _solver->_params, b[i], constraint_counter);
         constraint_counter++;
       }
 
-      for (int i = data.dynamic_obstacles.size() + _n_other_halfspaces; i < _max_obstacles + _n_other_halfspaces; i++)
+      for (int i = _num_obstacles + _n_other_halfspaces; i < _max_obstacles + _n_other_halfspaces; i++)
       {
         setSolverParameterLinConstraintA1(k, _solver->_params, _dummy_a1, constraint_counter);
         setSolverParameterLinConstraintA2(k, _solver->_params, _dummy_a2, constraint_counter);
@@ -221,14 +345,18 @@ namespace MPCPlanner
     if (_use_guidance && !CONFIG["debug_visuals"].as<bool>())
       return;
 
+    if (!shouldVisualize(_name))
+      return;
+
     PROFILE_FUNCTION();
 
     for (int k = 1; k < _solver->N; k++)
     {
-      for (size_t i = 0; i < data.dynamic_obstacles.size(); i++)
+      const std::vector<DynamicObstacle> &obstacles = _obstacles != nullptr ? *_obstacles : data.dynamic_obstacles;
+      for (size_t i = 0; i < obstacles.size(); i++)
       {
-        visualizeLinearConstraint(_a1[0][k](i), _a2[0][k](i), _b[0][k](i), k, _solver->N, _name,
-                                  k == _solver->N - 1 && i == data.dynamic_obstacles.size() - 1); // Publish at the end
+        visualizeLinearConstraint(_halfspaces.a1(0, k)[i], _halfspaces.a2(0, k)[i], _halfspaces.b(0, k)[i], k, _solver->N, _name,
+                                  k == _solver->N - 1 && i == obstacles.size() - 1); // Publish at the end
       }
     }
   }
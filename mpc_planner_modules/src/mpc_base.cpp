@@ -25,8 +25,10 @@ namespace MPCPlanner
     (void)data;
     (void)module_data;
 
-    if (k == 0)
-      LOG_MARK("setParameters()");
+    if (k != 0) // The weights are stage invariant, set once in the stage template
+      return;
+
+    LOG_MARK("setParameters()");
 
     for (auto &weight : _weight_names)
     {
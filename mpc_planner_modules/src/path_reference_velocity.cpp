@@ -3,9 +3,13 @@
 
 #include <mpc_planner_solver/mpc_planner_parameters.h>
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 
 #include <ros_tools/visuals.h>
 #include <ros_tools/spline.h>
+#include <ros_tools/profiling.h>
+
+#include <cmath>
 
 namespace MPCPlanner
 {
@@ -14,15 +18,27 @@ namespace MPCPlanner
       : ControllerModule(ModuleType::OBJECTIVE, solver, "path_reference_velocity")
   {
     _n_segments = CONFIG["contouring"]["num_segments"].as<int>();
+
+    if (CONFIG["velocity_profile"]["enable"].as<bool>())
+    {
+      _velocity_profile = std::make_unique<VelocityProfile>(CONFIG["weights"]["reference_velocity"].as<double>(),
+                                                            CONFIG["velocity_profile"]["max_lateral_acceleration"].as<double>(),
+                                                            CONFIG["velocity_profile"]["max_acceleration"].as<double>(),
+                                                            CONFIG["velocity_profile"]["max_deceleration"].as<double>(),
+                                                            CONFIG["velocity_profile"]["stop_at_end"].as<bool>());
+    }
   }
 
   void PathReferenceVelocity::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
     (void)state;
-    (void)data;
 
-    if (module_data.path_velocity == nullptr && _velocity_spline != nullptr)
+    // Also replaces the spline of a previous path
+    if (module_data.path_velocity != _velocity_spline)
       module_data.path_velocity = _velocity_spline;
+
+    // The velocity reference is the same for all stages, compute it once (after Contouring updated the path segment)
+    computeVelocityParameters(data, module_data, CONFIG["weights"]["reference_velocity"].as<double>());
   }
 
   void PathReferenceVelocity::onDataReceived(RealTimeData &data, std::string &&data_name)
@@ -36,72 +52,99 @@ namespace MPCPlanner
         _velocity_spline = std::make_shared<tk::spline>();
         _velocity_spline->set_points(data.reference_path.s, data.reference_path.v);
       }
+      else if (_velocity_profile != nullptr && data.reference_path.x.size() > 2)
+      {
+        PROFILE_SCOPE("PathReferenceVelocity::VelocityProfile");
+
+        const std::vector<double> *s = &data.reference_path.s;
+        if (!data.reference_path.hasDistance())
+        {
+          _path_s.resize(data.reference_path.x.size());
+          _path_s[0] = 0.;
+          for (size_t i = 1; i < _path_s.size(); i++)
+            _path_s[i] = _path_s[i - 1] + std::hypot(data.reference_path.x[i] - data.reference_path.x[i - 1],
+                                                     data.reference_path.y[i] - data.reference_path.y[i - 1]);
+          s = &_path_s;
+        }
+
+        // Streamed paths only compute the limits of the appended points
+        _velocity_profile->compute(data.reference_path.x, data.reference_path.y, *s, data.reference_path.is_continuation);
+        LOG_MARK("Computed the velocity profile (" << _velocity_profile->numReused() << " points reused)");
+
+        _velocity_spline = std::make_shared<tk::spline>();
+        _velocity_spline->set_points(_velocity_profile->getS(), _velocity_profile->getVelocity());
+      }
+      else
+      {
+        _velocity_spline.reset(); // Constant reference velocity
+      }
     }
   }
 
   void PathReferenceVelocity::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
   {
-    (void)module_data;
     (void)data;
+    (void)module_data;
 
-    static double reference_velocity; //, velocity_weight;
+    // The velocity reference is the same for all stages (stage invariant), set once in the stage template
+    if (k != 0)
+      return;
 
-    // Retrieve once
-    if (k == 0)
-    {
-      // velocity_weight = CONFIG["weights"]["velocity"].as<double>();
-      reference_velocity = CONFIG["weights"]["reference_velocity"].as<double>();
-    }
+    // double velocity_weight = CONFIG["weights"]["velocity"].as<double>();
 
     // Set the parameters for velocity tracking
     // setSolverParameterVelocity(k, _solver->_params, velocity_weight);
 
-    if (data.reference_path.hasVelocity()) // Use a spline-based velocity reference
+    for (int i = 0; i < _n_segments; i++)
+    {
+      const auto &segment = _segment_parameters[i];
+
+      setSolverParameterSplineVA(k, _solver->_params, segment.a, i);
+      setSolverParameterSplineVB(k, _solver->_params, segment.b, i);
+      setSolverParameterSplineVC(k, _solver->_params, segment.c, i);
+      setSolverParameterSplineVD(k, _solver->_params, segment.d, i);
+    }
+  }
+
+  void PathReferenceVelocity::computeVelocityParameters(const RealTimeData &data, const ModuleData &module_data,
+                                                        double reference_velocity)
+  {
+    (void)data;
+    _segment_parameters.resize(_n_segments);
+
+    if (_velocity_spline != nullptr) // Use a spline-based velocity reference (given or computed)
     {
       LOG_MARK("Using spline-based reference velocity");
       for (int i = 0; i < _n_segments; i++)
       {
         int index = module_data.current_path_segment + i;
-        double a, b, c, d;
+        auto &segment = _segment_parameters[i];
 
         if (index < (int)_velocity_spline->m_x_.size() - 1)
         {
-          _velocity_spline->getParameters(index, a, b, c, d);
+          _velocity_spline->getParameters(index, segment.a, segment.b, segment.c, segment.d);
         }
         else
         {
           // Brake at the end
-          a = 0.;
-          b = 0.;
-          c = 0.;
-          d = 0.;
+          segment = {0., 0., 0., 0.};
         }
-
-        setSolverParameterSplineVA(k, _solver->_params, a, i);
-        setSolverParameterSplineVB(k, _solver->_params, b, i);
-        setSolverParameterSplineVC(k, _solver->_params, c, i);
-        setSolverParameterSplineVD(k, _solver->_params, d, i);
       }
     }
     else // Use a constant velocity reference
     {
-      for (int i = 0; i < _n_segments; i++)
-      {
-        setSolverParameterSplineVA(k, _solver->_params, 0., i);
-        setSolverParameterSplineVB(k, _solver->_params, 0., i);
-        setSolverParameterSplineVC(k, _solver->_params, 0., i);
-        setSolverParameterSplineVD(k, _solver->_params, reference_velocity, i); // v = d
-      }
+      for (auto &segment : _segment_parameters)
+        segment = {0., 0., 0., reference_velocity}; // v = d
     }
   }
 
   void PathReferenceVelocity::visualize(const RealTimeData &data, const ModuleData &module_data)
   {
     (void)module_data;
-    if (data.reference_path.empty() || data.reference_path.s.empty())
+    if (data.reference_path.empty() || data.reference_path.s.empty() || _velocity_spline == nullptr)
       return;
 
-    if (!CONFIG["debug_visuals"].as<bool>())
+    if (!CONFIG["debug_visuals"].as<bool>() || !shouldVisualize("path_velocity"))
       return;
 
     LOG_MARK("PathReferenceVelocity::Visualize");
@@ -115,12 +158,14 @@ namespace MPCPlanner
 
     Eigen::Vector2d prev;
     double prev_v = 0.;
-    for (double s = 0.; s < _velocity_spline->m_x_.back(); s += 1.0)
+    // Continued paths do not start at s = 0
+    double s_start = _velocity_spline->m_x_.front();
+    for (double s = s_start; s < _velocity_spline->m_x_.back(); s += 1.0)
     {
       Eigen::Vector2d cur = spline_xy->getPoint(s);
       double v = _velocity_spline->operator()(s);
 
-      if (s > 0.)
+      if (s > s_start)
       {
         line.setColor(0, (v + prev_v) / (2. * 3. * 2.), 0.);
         line.addLine(prev, cur);
@@ -0,0 +1,88 @@
+#include "mpc_planner_modules/polyhedron_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MPCPlanner
+{
+  PolyhedronCache::PolyhedronCache(double margin)
+      : _margin(margin), _inv_cell_size(1. / std::max(margin, 1e-3))
+  {
+  }
+
+  void PolyhedronCache::clear()
+  {
+    _polyhedrons.clear();
+    _path.clear();
+  }
+
+  void PolyhedronCache::store(const vec_Vec2f &path, const vec_E<Polyhedron<2>> &polyhedrons)
+  {
+    _polyhedrons = polyhedrons;
+    _path = path;
+  }
+
+  void PolyhedronCache::findReusable(const vec_Vec2f &path, const std::vector<Eigen::Vector2d> &added,
+                                     vec_E<Polyhedron<2>> &polyhedrons, std::vector<bool> &reused)
+  {
+    int num_segments = (int)path.size() - 1;
+    reused.assign(num_segments, false);
+    polyhedrons.resize(num_segments);
+    if ((int)_polyhedrons.size() != num_segments)
+      return;
+
+    bucket(added);
+
+    // The path shifts forward, such that the previous polyhedron of the same or the next segment may contain the segment
+    for (int i = 0; i < num_segments; i++)
+    {
+      for (int prev : {i, i + 1})
+      {
+        if (prev >= num_segments || !_polyhedrons[prev].inside(path[i]) || !_polyhedrons[prev].inside(path[i + 1]) ||
+            pointsAdded(_path[prev], _path[prev + 1]))
+          continue;
+
+        polyhedrons[i] = _polyhedrons[prev];
+        reused[i] = true;
+        break;
+      }
+    }
+  }
+
+  void PolyhedronCache::bucket(const std::vector<Eigen::Vector2d> &added)
+  {
+    _points = added;
+    _cells.resize(added.size());
+    for (size_t i = 0; i < added.size(); i++)
+      _cells[i] = {cellIndex(added[i](0)), cellIndex(added[i](1)), (int)i};
+
+    std::sort(_cells.begin(), _cells.end());
+  }
+
+  bool PolyhedronCache::pointsAdded(const Vec2f &start, const Vec2f &end) const
+  {
+    if (_cells.empty())
+      return false;
+
+    Vec2f min = (start.cwiseMin(end).array() - _margin).matrix();
+    Vec2f max = (start.cwiseMax(end).array() + _margin).matrix();
+
+    int max_y = cellIndex(max(1));
+    for (int x = cellIndex(min(0)); x <= cellIndex(max(0)); x++)
+    {
+      auto it = std::lower_bound(_cells.begin(), _cells.end(), Cell{x, cellIndex(min(1)), 0});
+      for (; it != _cells.end() && it->x == x && it->y <= max_y; ++it)
+      {
+        const Eigen::Vector2d &point = _points[it->point];
+        if (point(0) >= min(0) && point(0) <= max(0) && point(1) >= min(1) && point(1) <= max(1))
+          return true;
+      }
+    }
+    return false;
+  }
+
+  int PolyhedronCache::cellIndex(double coordinate) const
+  {
+    return (int)std::floor(coordinate * _inv_cell_size);
+  }
+} // namespace MPCPlanner
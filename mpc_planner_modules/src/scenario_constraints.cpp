@@ -40,7 +40,7 @@ namespace MPCPlanner
 #pragma omp parallel for num_threads(4)
     for (auto &solver : _scenario_solvers)
     {
-      *solver->solver = *_solver; // Copy the main solver
+      solver->solver->copyWarmstart(*_solver); // The scenarios are computed along the initial guess
 
       solver->scenario_module.update(data, module_data);
     }
@@ -72,8 +72,9 @@ namespace MPCPlanner
       // auto &solver = _scenario_solvers[s];
       solver->solver->_params.solver_timeout = 1. / CONFIG["control_frequency"].as<double>();
 
-      // Copy solver parameters and initial guess
-      *solver->solver = *_solver; // Copy the main solver
+      // Copy solver parameters and initial guess (the only full copy, the scenario parameters are set on top)
+      // (not swapped: all scenario solvers start from the parameters that the modules set in the main solver)
+      *solver->solver = *_solver;
 
       // Set the scenario constraint parameters for each solver
       for (int k = 0; k < _solver->N; k++)
@@ -102,10 +103,10 @@ namespace MPCPlanner
       return _scenario_solvers.front()->exit_code;
     // auto &best_solver = *_scenario_solvers.front().solver;
 
-    _solver->_output = best_solver->solver->_output; // Load the solution into the main lmpcc solver
+    // Load the solution into the main lmpcc solver (its parameters are all set again before the next solve)
+    _solver->_output = best_solver->solver->_output;
     _solver->_info = best_solver->solver->_info;
-    _solver->_params = best_solver->solver->_params;
-    _solver->copySolverMemory(*(best_solver->solver)); /** @todo: Verify whether this is necessary */
+    _solver->swapSolverMemory(*(best_solver->solver)); // Adopt the memory of the best solver without copying it
 
     return best_solver->exit_code;
   }
@@ -164,9 +165,15 @@ namespace MPCPlanner
 
     LOG_MARK("ScenarioConstraints::visualize");
 
+    // The markers of the scenario module itself are drawn together with the optimized trajectories
+    if (!shouldVisualize(_name + "/optimized_trajectories"))
+      return;
+
     for (auto &solver : _scenario_solvers)
       solver->scenario_module.visualize(data);
 
+    double robot_radius = CONFIG["robot_radius"].as<double>();
+
     // Visualize optimized trajectories
     // Visualize the optimized trajectory
     for (auto &solver : _scenario_solvers)
@@ -177,7 +184,7 @@ namespace MPCPlanner
         for (int k = 1; k < _solver->N; k++)
           trajectory.add(solver->solver->getOutput(k, "x"), solver->solver->getOutput(k, "y"));
 
-        visualizeTrajectory(trajectory, _name + "/optimized_trajectories", false, 0.2, solver->solver->_solver_id, 2 * _scenario_solvers.size());
+        visualizeTrajectory(trajectory, _name + "/optimized_trajectories", robot_radius, false, 0.2, solver->solver->_solver_id, 2 * _scenario_solvers.size());
       }
     }
     VISUALS.getPublisher(_name + "/optimized_trajectories").publish();
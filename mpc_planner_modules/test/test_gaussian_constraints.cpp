@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_modules/gaussian_constraints.h"
+
+#include <mpc_planner_solver/solver_interface.h>
+#include <mpc_planner_solver/state.h>
+
+#include <mpc_planner_types/module_data.h>
+#include <mpc_planner_types/realtime_data.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace MPCPlanner;
+
+class GaussianConstraintsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::string path = std::filesystem::path(__FILE__).parent_path().string() + "/../../mpc_planner_jackal/src/src";
+        path = SYSTEM_CONFIG_PATH(path, "settings");
+        Configuration::getInstance().initialize(path);
+        MUTABLE_CONFIG["debug_output"] = false;
+
+        solver = std::make_shared<Solver>();
+
+        // The robot drives along the x-axis
+        for (int k = 0; k < solver->N; k++)
+        {
+            solver->setEgoPrediction(k, "x", 0.2 * k);
+            solver->setEgoPrediction(k, "y", 0.);
+        }
+        state.set("x", 0.);
+        state.set("y", 0.);
+
+        data.robot_area = {Disc(0., CONFIG["robot_radius"].as<double>())};
+    }
+
+    // An obstacle standing at (x, y) next to the path
+    DynamicObstacle createObstacle(int index, double x, double y, PredictionType type)
+    {
+        DynamicObstacle obstacle(index, Eigen::Vector2d(x, y), 0., CONFIG["obstacle_radius"].as<double>());
+        obstacle.prediction = Prediction(type);
+        for (int k = 0; k < solver->N; k++)
+            obstacle.prediction.modes[0].emplace_back(Eigen::Vector2d(x, y), 0., 0.1, 0.1);
+        return obstacle;
+    }
+
+    std::string parameter(int slot, const std::string &name) const
+    {
+        return "gaussian_obst_" + std::to_string(slot) + "_" + name;
+    }
+
+    std::shared_ptr<Solver> solver;
+    State state;
+    RealTimeData data;
+    ModuleData module_data;
+};
+
+TEST_F(GaussianConstraintsTest, NonGaussianObstaclesGetDummies)
+{
+    GaussianConstraints module(solver);
+    int num_slots = CONFIG["max_obstacles"].as<int>();
+
+    // One Gaussian obstacle, one deterministic obstacle (both reachable) and far away Gaussian obstacles
+    data.dynamic_obstacles = {createObstacle(0, 2., 1., PredictionType::GAUSSIAN),
+                              createObstacle(1, 2., -1., PredictionType::DETERMINISTIC)};
+    for (int i = 2; i < num_slots; i++)
+        data.dynamic_obstacles.push_back(createObstacle(i, -100., 100. + i, PredictionType::GAUSSIAN));
+
+    // Values of a previous cycle should not remain in the solver parameters
+    for (int k = 0; k < solver->N; k++)
+    {
+        for (int i = 0; i < num_slots; i++)
+            solver->setParameter(k, parameter(i, "x"), 1e3);
+    }
+
+    module.update(state, data, module_data);
+    for (int k = 0; k < solver->N; k++)
+        module.setParameters(data, module_data, k);
+
+    bool gaussian_constrained = false;
+    for (int k = 1; k < solver->N; k++)
+    {
+        for (int i = 0; i < num_slots; i++)
+        {
+            double x = solver->getParameter(k, parameter(i, "x"));
+            double y = solver->getParameter(k, parameter(i, "y"));
+            EXPECT_NE(x, 1e3) << "Stale parameter at stage " << k << ", slot " << i;
+            EXPECT_FALSE(x == 2. && y == -1.) << "Deterministic obstacle constrained at stage " << k << ", slot " << i;
+
+            if (x == 2. && y == 1.)
+            {
+                gaussian_constrained = true;
+                EXPECT_DOUBLE_EQ(solver->getParameter(k, parameter(i, "major")), 0.1);
+            }
+            else if (x != -100.) // Not one of the far away obstacles (constrained if screening is disabled): a dummy
+            {
+                EXPECT_DOUBLE_EQ(x, 50.);
+                EXPECT_DOUBLE_EQ(y, 50.);
+                EXPECT_DOUBLE_EQ(solver->getParameter(k, parameter(i, "r")), 0.1);
+            }
+        }
+    }
+    EXPECT_TRUE(gaussian_constrained);
+}
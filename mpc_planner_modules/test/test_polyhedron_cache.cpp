@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_modules/polyhedron_cache.h"
+
+#include <decomp_util/ellipsoid_decomp.h>
+
+#include <mpc_planner_util/occupancy_tracker.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace MPCPlanner;
+
+class PolyhedronCacheTest : public ::testing::Test
+{
+protected:
+    // 10 x 10 m at 5 cm with two rows of 0.6 m deep shelves around an aisle
+    void SetUp() override
+    {
+        map.assign(size * size, 0);
+        fill(1., 1.5, 9., 2.1);
+        fill(1., 3.5, 9., 4.1);
+    }
+
+    void fill(double min_x, double min_y, double max_x, double max_y)
+    {
+        for (int y = (int)(min_y / resolution); y < (int)(max_y / resolution); y++)
+        {
+            for (int x = (int)(min_x / resolution); x < (int)(max_x / resolution); x++)
+                map[y * size + x] = 254;
+        }
+    }
+
+    // Through the aisle, as DecompConstraints::decompose
+    vec_Vec2f createPath(double offset) const
+    {
+        vec_Vec2f path;
+        for (double x = 0.5; x <= 9.5; x += 1.)
+            path.push_back(Vec2f(x + offset, 2.8 + 0.1 * std::sin(x)));
+        return path;
+    }
+
+    void decompose(const vec_Vec2f &path, const std::vector<bool> &reused, vec_E<Polyhedron<2>> &polyhedrons) const
+    {
+        vec_Vec2f obstacles(tracker.getOccupied().begin(), tracker.getOccupied().end());
+        for (size_t i = 0; i + 1 < path.size(); i++)
+        {
+            if (reused[i])
+                continue;
+
+            LineSegment2D segment(path[i], path[i + 1]);
+            segment.set_local_bbox(Vec2f(range, range));
+            segment.set_obs(obstacles);
+            segment.dilate(0.);
+            polyhedrons[i] = segment.get_polyhedron();
+        }
+    }
+
+    // No occupied point lies strictly inside of the polyhedron
+    void expectFree(const Polyhedron<2> &polyhedron, int segment) const
+    {
+        for (auto &point : tracker.getOccupied())
+        {
+            bool outside = false;
+            for (auto &hyperplane : polyhedron.hyperplanes())
+                outside |= hyperplane.signed_dist(point) > -1e-9;
+
+            ASSERT_TRUE(outside) << "Segment " << segment << " contains (" << point(0) << ", " << point(1) << ")";
+        }
+    }
+
+    const int size{200};
+    const double resolution{0.05};
+    const double range{2.};
+
+    std::vector<unsigned char> map;
+    OccupancyTracker tracker;
+};
+
+TEST_F(PolyhedronCacheTest, ReusedPolyhedraExcludeObstacles)
+{
+    PolyhedronCache cache(std::sqrt(2.) * range);
+    vec_E<Polyhedron<2>> polyhedrons;
+    std::vector<bool> reused;
+
+    // First cycle: nothing to reuse
+    tracker.update(map.data(), size, size, 0., 0., resolution);
+    vec_Vec2f path = createPath(0.);
+    cache.findReusable(path, tracker.getAdded(), polyhedrons, reused);
+    EXPECT_EQ(std::count(reused.begin(), reused.end(), true), 0);
+
+    decompose(path, reused, polyhedrons);
+    cache.store(path, polyhedrons);
+
+    // Second cycle: the path moved forward and a small obstacle appeared in the aisle near its end
+    fill(8.4, 2.3, 8.55, 2.45);
+    tracker.update(map.data(), size, size, 0., 0., resolution);
+    ASSERT_FALSE(tracker.getAdded().empty());
+
+    path = createPath(0.1);
+    cache.findReusable(path, tracker.getAdded(), polyhedrons, reused);
+    EXPECT_GT(std::count(reused.begin(), reused.end(), true), 0);
+    EXPECT_FALSE(reused.back()); // Around the new obstacle
+
+    decompose(path, reused, polyhedrons);
+    for (size_t i = 0; i < reused.size(); i++)
+    {
+        if (!reused[i])
+            continue;
+
+        EXPECT_TRUE(polyhedrons[i].inside(path[i]) && polyhedrons[i].inside(path[i + 1]));
+        expectFree(polyhedrons[i], i);
+    }
+
+    // Nothing is reused once cleared
+    cache.clear();
+    cache.findReusable(path, tracker.getAdded(), polyhedrons, reused);
+    EXPECT_EQ(std::count(reused.begin(), reused.end(), true), 0);
+}
@@ -40,6 +40,8 @@ using namespace MPCPlanner;
 namespace MPCPlanner
 {
     class Planner;
+    class ObstacleIngestion;
+    class ReferencePathStream;
 }
 namespace local_planner
 {
@@ -102,6 +104,8 @@ namespace local_planner
         bool _rotate_to_goal{false};
 
         std::unique_ptr<Planner> _planner;
+        std::unique_ptr<ObstacleIngestion> _obstacle_ingestion;
+        std::unique_ptr<ReferencePathStream> _path_stream;
 
         std::unique_ptr<RosnavigationReconfigure> _reconfigure;
 
@@ -138,7 +142,6 @@ namespace local_planner
         double _x_buffer[CAMERA_BUFFER];
         double _y_buffer[CAMERA_BUFFER];
 
-        bool isPathTheSame(const nav_msgs::Path::ConstPtr &path);
 
         void visualize();
     };
@@ -23,6 +23,7 @@ from path_reference_velocity import PathReferenceVelocityModule
 from ellipsoid_constraints import EllipsoidConstraintModule
 from gaussian_constraints import GaussianConstraintModule
 from decomp_constraints import DecompConstraintModule
+from distance_field_constraints import DistanceFieldConstraintModule
 from guidance_constraints import GuidanceConstraintModule
 from linearized_constraints import LinearizedConstraintModule
 from scenario_constraints import ScenarioConstraintModule
@@ -101,6 +102,7 @@ def configuration_tmpc(settings):
     # modules.add_module(GuidanceConstraintModule(settings, constraint_submodule=GaussianConstraintModule))
     modules.add_module(GuidanceConstraintModule(settings, constraint_submodule=EllipsoidConstraintModule))
     modules.add_module(DecompConstraintModule(settings))
+    # modules.add_module(DistanceFieldConstraintModule(settings))  # Alternative to DecompConstraintModule
 
     return model, modules
 
@@ -119,6 +121,7 @@ def configuration_lmpcc(settings):
 
     modules.add_module(EllipsoidConstraintModule(settings))
     modules.add_module(DecompConstraintModule(settings))
+    # modules.add_module(DistanceFieldConstraintModule(settings))  # Alternative to DecompConstraintModule
 
     return model, modules
 
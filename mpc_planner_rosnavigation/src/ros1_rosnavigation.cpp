@@ -4,8 +4,11 @@
 #include <mpc_planner/planner.h>
 
 #include <mpc_planner/data_preparation.h>
+#include <mpc_planner/obstacle_ingestion.h>
+#include <mpc_planner/reference_path_stream.h>
 
 #include <mpc_planner_util/parameters.h>
+#include <mpc_planner_util/data_visualization.h>
 #include <mpc_planner_util/load_yaml.hpp>
 
 #include <ros_tools/visuals.h>
@@ -52,6 +55,7 @@ namespace local_planner
             LOG_INFO("Started ROSNavigation Planner");
 
             VISUALS.init(&general_nh_);
+            startSubscriberMonitorROS1();
 
             // Initialize the configuration
             Configuration::getInstance().initialize(SYSTEM_CONFIG_PATH(__FILE__, "settings"));
@@ -60,6 +64,8 @@ namespace local_planner
 
             // Initialize the planner
             _planner = std::make_unique<Planner>();
+            _obstacle_ingestion = std::make_unique<ObstacleIngestion>();
+            _path_stream = std::make_unique<ReferencePathStream>(CONFIG["downsample_path"].as<double>()); // Keeps every n-th point
 
             // Initialize the ROS interface
             initializeSubscribersAndPublishers(nh);
@@ -398,44 +404,17 @@ namespace local_planner
         _rotate_to_goal = true;
     }
 
-    bool ROSNavigationPlanner::isPathTheSame(const nav_msgs::Path::ConstPtr &msg)
-    {
-        // Check if the path is the same
-        if (_data.reference_path.x.size() != msg->poses.size())
-            return false;
-
-        // Check up to the first two points
-        int num_points = std::min(2, (int)_data.reference_path.x.size());
-        for (int i = 0; i < num_points; i++)
-        {
-            if (!_data.reference_path.pointInPath(i, msg->poses[i].pose.position.x, msg->poses[i].pose.position.y))
-                return false;
-        }
-        return true;
-    }
-
     void ROSNavigationPlanner::pathCallback(const nav_msgs::Path::ConstPtr &msg)
     {
         LOG_MARK("Path callback");
 
         int downsample = CONFIG["downsample_path"].as<double>();
 
-        if (isPathTheSame(msg) || msg->poses.size() < downsample + 1)
+        if (msg->poses.size() < downsample + 1)
             return;
 
-        _data.reference_path.clear();
-
-        int count = 0;
-        for (auto &pose : msg->poses)
-        {
-            if (count % downsample == 0 || count == msg->poses.size() - 1) // Todo
-            {
-                _data.reference_path.x.push_back(pose.pose.position.x);
-                _data.reference_path.y.push_back(pose.pose.position.y);
-                _data.reference_path.psi.push_back(RosTools::quaternionToAngle(pose.pose.orientation));
-            }
-            count++;
-        }
+        if (!_path_stream->update(*msg, _data.reference_path)) // Same path (compares all points)
+            return;
 
         // Fit a clothoid on the global path to sample points on the spline from
         // RosTools::Clothoid2D clothoid(_data.reference_path.x, _data.reference_path.y, _data.reference_path.psi, 2.0);
@@ -459,47 +438,7 @@ namespace local_planner
     {
         LOG_MARK("Obstacle callback");
 
-        _data.dynamic_obstacles.clear();
-
-        for (auto &obstacle : msg->obstacles)
-        {
-            // Save the obstacle
-            _data.dynamic_obstacles.emplace_back(
-                obstacle.id,
-                Eigen::Vector2d(obstacle.pose.position.x, obstacle.pose.position.y),
-                RosTools::quaternionToAngle(obstacle.pose),
-                CONFIG["obstacle_radius"].as<double>());
-            auto &dynamic_obstacle = _data.dynamic_obstacles.back();
-
-            if (obstacle.probabilities.size() == 0) // No Predictions!
-                continue;
-
-            // Save the prediction
-            if (obstacle.probabilities.size() == 1) // One mode
-            {
-                dynamic_obstacle.prediction = Prediction(PredictionType::GAUSSIAN);
-
-                const auto &mode = obstacle.gaussians[0];
-                for (size_t k = 0; k < mode.mean.poses.size(); k++)
-                {
-                    dynamic_obstacle.prediction.modes[0].emplace_back(
-                        Eigen::Vector2d(mode.mean.poses[k].pose.position.x, mode.mean.poses[k].pose.position.y),
-                        RosTools::quaternionToAngle(mode.mean.poses[k].pose.orientation),
-                        mode.major_semiaxis[k],
-                        mode.minor_semiaxis[k]);
-                }
-
-                if (mode.major_semiaxis.back() == 0. || !CONFIG["probabilistic"]["enable"].as<bool>())
-                    dynamic_obstacle.prediction.type = PredictionType::DETERMINISTIC;
-                else
-                    dynamic_obstacle.prediction.type = PredictionType::GAUSSIAN;
-            }
-            else
-            {
-                ROSTOOLS_ASSERT(false, "Multiple modes not yet supported");
-            }
-        }
-        ensureObstacleSize(_data.dynamic_obstacles, _state);
+        _obstacle_ingestion->ingest(*msg, _state, _data.dynamic_obstacles);
 
         if (CONFIG["probabilistic"]["propagate_uncertainty"].as<bool>())
             propagatePredictionUncertainty(_data.dynamic_obstacles);
@@ -533,6 +472,8 @@ namespace local_planner
         }
 
         _planner->reset(_state, _data, success);
+        _obstacle_ingestion->reset();
+        _path_stream->reset(); // The planner reset clears the reference path
         _data.costmap = costmap_;
 
         ros::Duration(1.0 / CONFIG["control_frequency"].as<double>()).sleep();
@@ -1,7 +1,9 @@
 #ifndef ACADOS_SOLVER_INTERFACE_H
 #define ACADOS_SOLVER_INTERFACE_H
 
+#include <functional>
 #include <iostream>
+#include <vector>
 
 #include <mpc_planner_solver/state.h>
 
@@ -46,6 +48,8 @@
 #define NPHIN SOLVER_NPHIN
 #define NR SOLVER_NR
 
+#define EXIT_CODE_CANCELLED -50 // Stopped by the early termination callback
+
 namespace MPCPlanner
 {
     struct AcadosParameters
@@ -174,6 +178,14 @@ namespace MPCPlanner
 
         int _num_iterations;
 
+        std::function<bool(int)> _early_termination;
+
+        std::vector<double> _stage_template; // Stage-invariant parameters as last copied to all stages
+        bool _stage_template_loaded{false};
+
+        /** @brief Index of a parameter of stage k, stage-invariant parameters always map to the template */
+        int parameterIndex(int k, const std::string &parameter);
+
     public:
         Solver(int solver_id = 0);
         ~Solver();
@@ -185,10 +197,24 @@ namespace MPCPlanner
 
         int solve();
 
+        /** @brief Called with the number of completed iterations between iterations, stops the solve when it returns true
+         * (not copied by operator=) */
+        void setEarlyTermination(std::function<bool(int)> &&early_termination);
+
+        /** @brief Only SQP_RTI iterations are run from here, a full SQP solve cannot be stopped */
+        bool canTerminateEarly() const { return _num_iterations > 1; }
+        bool hasTimeout() const { return false; } // solver_timeout is not functional
+
         // PARAMETERS //
+        /** @brief Stage-invariant parameters (e.g., weights) only exist in the template: k is ignored for them and
+         * the value applies to all stages once loadStageTemplate() runs */
         bool hasParameter(std::string &&parameter);
         void setParameter(int k, std::string &&parameter, double value);
         void setParameter(int k, std::string &parameter, double value);
+
+        /** @brief Copy the stage-invariant parameters from stage 0 (the template) to all stages, if they changed.
+         * Called by solve(), such that their setters only need to write the template */
+        void loadStageTemplate();
         double getParameter(int k, std::string &&parameter);
 
         // XINIT //
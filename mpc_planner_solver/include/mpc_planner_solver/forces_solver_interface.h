@@ -6,6 +6,7 @@
 #include <mpc_planner_util/load_yaml.hpp>
 
 #include <memory>
+#include <vector>
 
 #include <Solver.h>
 #include <Solver_memory.h>
@@ -39,6 +40,14 @@ namespace MPCPlanner
 		char *_solver_memory;
 		Solver_mem *_solver_memory_handle;
 
+		bool _has_timeout;
+
+		std::vector<double> _stage_template; // Stage-invariant parameters as last copied to all stages
+		bool _stage_template_loaded{false};
+
+		/** @brief Index of a parameter of stage k, stage-invariant parameters always map to the template */
+		int parameterIndex(int k, const std::string &parameter);
+
 	public:
 		int _solver_id;
 
@@ -65,17 +74,33 @@ namespace MPCPlanner
 		char *getSolverMemory() const;
 		void copySolverMemory(const Solver &other);
 
+		/**
+		 * @brief Exchange the solver memory with another solver without copying it
+		 * @note The handles stay bound to the memory they were created with, such that the solvers always hold distinct
+		 * memory (as the thread-safe storage of Forces requires)
+		 */
+		void swapSolverMemory(Solver &other);
+
+		/** @brief Copy only the initial state and the initial guess from another solver */
+		void copyWarmstart(const Solver &other);
+
 		void setEgoPrediction(unsigned int k, std::string &&var_name, double value);
 		double getEgoPrediction(unsigned int k, std::string &&var_name);
 		void setEgoPredictionPosition(unsigned int k, const Eigen::Vector2d &value);
 		Eigen::Vector2d getEgoPredictionPosition(unsigned int k);
 
-		/** @brief Set and get a solver parameter at index index of stage k */
+		/** @brief Set and get a solver parameter at index index of stage k
+		 * @note Stage-invariant parameters (e.g., weights) only exist in the template: k is ignored for them and the
+		 * value applies to all stages once loadStageTemplate() runs */
 		bool hasParameter(std::string &&parameter);
 		void setParameter(int k, std::string &&parameter, double value);
 		void setParameter(int k, std::string &parameter, double value);
 		double getParameter(int k, std::string &&parameter);
 
+		/** @brief Copy the stage-invariant parameters from stage 0 (the template) to all stages, if they changed.
+		 * Called by solve(), such that their setters only need to write the template */
+		void loadStageTemplate();
+
 		void setXinit(std::string &&state_name, double value);
 		void setXinit(const State &state);
 
@@ -88,6 +113,10 @@ namespace MPCPlanner
 
 		/** @brief Solve the optimization */
 		int solve();
+
+		/** @brief A Forces solve cannot be stopped (no iteration hook), its time can only be limited with solver_timeout */
+		bool canTerminateEarly() const { return false; }
+		bool hasTimeout() const { return _has_timeout; } // Generated with enable_timeout
 		double getOutput(int k, std::string &&state_name) const;
 
 		// Debugging utilities
@@ -22,6 +22,9 @@ namespace MPCPlanner
         void set(std::string &&var_name, double value);
         void print() const;
 
+        /** @brief Names of the state variables (excluding inputs) */
+        std::vector<std::string> getNames() const;
+
     private:
         std::vector<double> _state;
         YAML::Node _config, _model_map;
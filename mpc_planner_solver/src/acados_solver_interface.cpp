@@ -1,7 +1,10 @@
 #include <mpc_planner_solver/acados_solver_interface.h>
+#include <mpc_planner_solver/mpc_planner_parameters.h>
 
 #include <mpc_planner_util/parameters.h>
 
+#include <cstring>
+
 namespace MPCPlanner
 {
     Solver::Solver(int solver_id)
@@ -22,6 +25,11 @@ namespace MPCPlanner
         npar = _config["npar"].as<unsigned int>();
         dt = CONFIG["integrator_step"].as<double>();
 
+        int num_stage_invariant = 0;
+        for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+            num_stage_invariant += STAGE_INVARIANT_PARAMETER_RUNS[r][1];
+        _stage_template.resize(num_stage_invariant);
+
         _num_iterations = CONFIG["solver_settings"]["acados"]["iterations"].as<int>();
         if (CONFIG["solver_settings"]["acados"]["solver_type"].as<std::string>() == "SQP")
             _num_iterations = 1;
@@ -65,6 +73,7 @@ namespace MPCPlanner
     Solver &Solver::operator=(const Solver &rhs)
     {
         _params = rhs._params;
+        _stage_template_loaded = false; // The stages of rhs may not have been loaded
         ocp_nlp_solver_reset_qp_memory(_nlp_solver, _nlp_in, _nlp_out);
 
         // _output = rhs._output;
@@ -79,12 +88,15 @@ namespace MPCPlanner
         _params = AcadosParameters();
         _info = AcadosInfo();
         _output = AcadosOutput();
+        _stage_template_loaded = false;
     }
 
     int Solver::solve()
     {
         int status = 1;
 
+        loadStageTemplate();
+
         // _params.printParameters(_parameter_map);
 
         // Set initial state
@@ -122,6 +134,12 @@ namespace MPCPlanner
 
             if (status != ACADOS_SUCCESS && _info.qp_status != 0)
                 break;
+
+            if (_early_termination && iteration < _num_iterations - 1 && _early_termination(iteration + 1))
+            {
+                status = EXIT_CODE_CANCELLED;
+                break;
+            }
         }
 
         ocp_nlp_get(_nlp_config, _nlp_solver, "nlp_res", &_info.nlp_res);
@@ -165,25 +183,74 @@ namespace MPCPlanner
         return status;
     }
 
+    void Solver::setEarlyTermination(std::function<bool(int)> &&early_termination)
+    {
+        _early_termination = early_termination;
+    }
+
     // PARAMETERS //
     bool Solver::hasParameter(std::string &&parameter)
     {
         return _parameter_map[parameter].IsDefined();
     }
 
+    int Solver::parameterIndex(int k, const std::string &parameter)
+    {
+        const int index = _parameter_map[parameter].as<int>();
+        for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+        {
+            if (index >= STAGE_INVARIANT_PARAMETER_RUNS[r][0] && index < STAGE_INVARIANT_PARAMETER_RUNS[r][0] + STAGE_INVARIANT_PARAMETER_RUNS[r][1])
+                return index; // Stage invariant: always the template
+        }
+        return k * npar + index;
+    }
+
     void Solver::setParameter(int k, std::string &&parameter, double value)
     {
-        _params.all_parameters[k * npar + _parameter_map[parameter].as<int>()] = value;
+        _params.all_parameters[parameterIndex(k, parameter)] = value;
     }
 
     void Solver::setParameter(int k, std::string &parameter, double value)
     {
-        _params.all_parameters[k * npar + _parameter_map[parameter].as<int>()] = value;
+        _params.all_parameters[parameterIndex(k, parameter)] = value;
     }
 
     double Solver::getParameter(int k, std::string &&parameter)
     {
-        return _params.all_parameters[k * npar + _parameter_map[parameter].as<int>()];
+        return _params.all_parameters[parameterIndex(k, parameter)];
+    }
+
+    void Solver::loadStageTemplate()
+    {
+        // Dirty check: compare the template with the values copied last time
+        bool changed = !_stage_template_loaded;
+        int t = 0;
+        for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+        {
+            const int first = STAGE_INVARIANT_PARAMETER_RUNS[r][0];
+            for (int i = first; i < first + STAGE_INVARIANT_PARAMETER_RUNS[r][1]; i++, t++)
+            {
+                if (_stage_template[t] != _params.all_parameters[i])
+                {
+                    _stage_template[t] = _params.all_parameters[i];
+                    changed = true;
+                }
+            }
+        }
+
+        if (!changed)
+            return;
+
+        for (int k = 1; k < N; k++)
+        {
+            for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+            {
+                const int first = STAGE_INVARIANT_PARAMETER_RUNS[r][0];
+                memcpy(&_params.all_parameters[k * npar + first], &_params.all_parameters[first],
+                       STAGE_INVARIANT_PARAMETER_RUNS[r][1] * sizeof(double));
+            }
+        }
+        _stage_template_loaded = true;
     }
 
     // XINIT //
@@ -362,6 +429,8 @@ namespace MPCPlanner
             return "Failure (maximum number of iterations reached)";
         case 3:
             return "Failure (minimum step size reached)";
+        case EXIT_CODE_CANCELLED:
+            return "Cancelled (early termination)";
         case 4:
             break;
         default:
@@ -5,6 +5,10 @@
 #include <ros_tools/logging.h>
 
 #include "mpc_planner_generated.h"
+#include <mpc_planner_solver/mpc_planner_parameters.h>
+
+#include <cstring>
+#include <utility>
 
 extern "C"
 {
@@ -27,6 +31,13 @@ namespace MPCPlanner
 		nvar = _config["nvar"].as<unsigned int>();
 		npar = _config["npar"].as<unsigned int>();
 		dt = CONFIG["integrator_step"].as<double>();
+		_has_timeout = CONFIG["solver_settings"]["forces"]["enable_timeout"].as<bool>();
+
+		int num_stage_invariant = 0;
+		for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+			num_stage_invariant += STAGE_INVARIANT_PARAMETER_RUNS[r][1];
+		_stage_template.resize(num_stage_invariant);
+
 		reset();
 	}
 
@@ -40,6 +51,8 @@ namespace MPCPlanner
 
 		for (size_t i = 0; i < N * nvar; i++)
 			_params.x0[i] = 0.0;
+
+		_stage_template_loaded = false;
 	}
 
 	Solver::~Solver()
@@ -50,6 +63,7 @@ namespace MPCPlanner
 	Solver &Solver::operator=(const Solver &rhs)
 	{
 		_params = rhs._params;
+		_stage_template_loaded = false; // The stages of rhs may not have been loaded
 
 		return *this;
 	}
@@ -61,24 +75,80 @@ namespace MPCPlanner
 		memcpy(_solver_memory, other.getSolverMemory(), Solver_get_mem_size());
 	}
 
+	void Solver::swapSolverMemory(Solver &other)
+	{
+		std::swap(_solver_memory, other._solver_memory);
+		std::swap(_solver_memory_handle, other._solver_memory_handle);
+	}
+
+	void Solver::copyWarmstart(const Solver &other)
+	{
+		memcpy(_params.xinit, other._params.xinit, sizeof(_params.xinit));
+		memcpy(_params.x0, other._params.x0, sizeof(_params.x0));
+	}
+
 	bool Solver::hasParameter(std::string &&parameter)
 	{
 		return _parameter_map[parameter].IsDefined();
 	}
 
+	int Solver::parameterIndex(int k, const std::string &parameter)
+	{
+		const int index = _parameter_map[parameter].as<int>();
+		for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+		{
+			if (index >= STAGE_INVARIANT_PARAMETER_RUNS[r][0] && index < STAGE_INVARIANT_PARAMETER_RUNS[r][0] + STAGE_INVARIANT_PARAMETER_RUNS[r][1])
+				return index; // Stage invariant: always the template
+		}
+		return k * npar + index;
+	}
+
 	void Solver::setParameter(int k, std::string &&parameter, double value)
 	{
-		_params.all_parameters[k * npar + _parameter_map[parameter].as<int>()] = value;
+		_params.all_parameters[parameterIndex(k, parameter)] = value;
 	}
 
 	void Solver::setParameter(int k, std::string &parameter, double value)
 	{
-		_params.all_parameters[k * npar + _parameter_map[parameter].as<int>()] = value;
+		_params.all_parameters[parameterIndex(k, parameter)] = value;
 	}
 
 	double Solver::getParameter(int k, std::string &&parameter)
 	{
-		return _params.all_parameters[k * npar + _parameter_map[parameter].as<int>()];
+		return _params.all_parameters[parameterIndex(k, parameter)];
+	}
+
+	void Solver::loadStageTemplate()
+	{
+		// Dirty check: compare the template with the values copied last time
+		bool changed = !_stage_template_loaded;
+		int t = 0;
+		for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+		{
+			const int first = STAGE_INVARIANT_PARAMETER_RUNS[r][0];
+			for (int i = first; i < first + STAGE_INVARIANT_PARAMETER_RUNS[r][1]; i++, t++)
+			{
+				if (_stage_template[t] != _params.all_parameters[i])
+				{
+					_stage_template[t] = _params.all_parameters[i];
+					changed = true;
+				}
+			}
+		}
+
+		if (!changed)
+			return;
+
+		for (int k = 1; k < N; k++)
+		{
+			for (int r = 0; r < NUM_STAGE_INVARIANT_PARAMETER_RUNS; r++)
+			{
+				const int first = STAGE_INVARIANT_PARAMETER_RUNS[r][0];
+				memcpy(&_params.all_parameters[k * npar + first], &_params.all_parameters[first],
+					   STAGE_INVARIANT_PARAMETER_RUNS[r][1] * sizeof(double));
+			}
+		}
+		_stage_template_loaded = true;
 	}
 
 	void Solver::setXinit(std::string &&state_name, double value)
@@ -217,6 +287,8 @@ namespace MPCPlanner
 
 	int Solver::solve()
 	{
+		loadStageTemplate();
+
 		int exit_code = Solver_solve(&_params, &_output, &_info, _solver_memory_handle, stdout, extfunc_eval_);
 		return exit_code;
 	}
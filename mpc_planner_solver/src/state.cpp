@@ -41,4 +41,15 @@ void State::print() const
             LOG_VALUE(it->first.as<std::string>(), get(it->first.as<std::string>()));
         }
     }
+}
+
+std::vector<std::string> State::getNames() const
+{
+    std::vector<std::string> names;
+    for (YAML::const_iterator it = _model_map.begin(); it != _model_map.end(); ++it)
+    {
+        if (it->second[0].as<std::string>() == "x")
+            names.emplace_back(it->first.as<std::string>());
+    }
+    return names;
 }
\ No newline at end of file
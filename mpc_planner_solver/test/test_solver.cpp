@@ -133,6 +133,41 @@ TEST_F(SolverTest, TestName)
     ASSERT_TRUE(solver2.getParameter(0, "reference_velocity") == 1.);
 }
 
+TEST_F(SolverTest, StageTemplate)
+{
+    Solver solver;
+
+    // Weights are stage invariant: setting the template (stage 0) sets all stages
+    solver.setParameter(0, "reference_velocity", 2.);
+    solver.loadStageTemplate();
+    for (int k = 0; k < solver.N; k++)
+        ASSERT_TRUE(solver.getParameter(k, "reference_velocity") == 2.);
+
+    // Writes to other stages also go to the template and are not lost when it is loaded
+    solver.setParameter(solver.N - 1, "reference_velocity", 5.);
+    ASSERT_TRUE(solver.getParameter(0, "reference_velocity") == 5.);
+    solver.loadStageTemplate();
+    for (int k = 0; k < solver.N; k++)
+        ASSERT_TRUE(solver.getParameter(k, "reference_velocity") == 5.);
+
+    // The stages are not copied again while the template is unchanged
+    int last = (solver.N - 1) * solver.npar + solver._parameter_map["reference_velocity"].as<int>();
+    solver._params.all_parameters[last] = 4.;
+    solver.loadStageTemplate();
+    ASSERT_TRUE(solver._params.all_parameters[last] == 4.);
+
+    solver.setParameter(0, "reference_velocity", 3.);
+    solver.loadStageTemplate();
+    ASSERT_TRUE(solver._params.all_parameters[last] == 3.);
+
+    // Copies load the template again
+    Solver solver2(1);
+    solver2 = solver;
+    solver2._params.all_parameters[last] = 5.;
+    solver2.loadStageTemplate();
+    ASSERT_TRUE(solver2._params.all_parameters[last] == 3.);
+}
+
 // Run all the tests
 int main(int argc, char **argv)
 {
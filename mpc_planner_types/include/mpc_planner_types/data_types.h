@@ -100,6 +100,8 @@ namespace MPCPlanner
         std::vector<double> v;
         std::vector<double> s;
 
+        bool is_continuation{false}; // Continues the previous path (points dropped/appended, s-coordinates unchanged)
+
         ReferencePath(int length = 10);
         void clear();
 
@@ -18,6 +18,8 @@ namespace tk
 
 namespace MPCPlanner
 {
+    class PathLookupTable;
+
     struct ModuleData
     {
         std::vector<StaticObstacle> static_obstacles;
@@ -27,6 +29,7 @@ namespace MPCPlanner
         std::shared_ptr<tk::spline> path_width_left{nullptr};
         std::shared_ptr<tk::spline> path_width_right{nullptr};
         std::shared_ptr<tk::spline> path_velocity{nullptr};
+        std::shared_ptr<PathLookupTable> path_table{nullptr}; // Sampled version of path (cheap lookups)
 
         int current_path_segment{-1};
 
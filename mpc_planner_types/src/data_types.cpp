@@ -72,6 +72,7 @@ namespace MPCPlanner
         psi.clear();
         v.clear();
         s.clear();
+        is_continuation = false;
     }
 
     bool ReferencePath::pointInPath(int point_num, double other_x, double other_y) const
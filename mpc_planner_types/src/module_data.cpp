@@ -8,6 +8,7 @@ namespace MPCPlanner
                 path_width_left.reset();
                 path_width_right.reset();
                 path_velocity.reset();
+                path_table.reset();
                 current_path_segment = -1;
         }
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include <mpc_planner_util/closest_point_search.h>
+
+#include <ros_tools/spline.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Times the windowed closest point search against the bounding box search while driving along a long route
+int main()
+{
+    const int num_points = 10000;
+
+    // A winding 10k point route (~10 km) with varying curvature
+    std::vector<double> x = {0.}, y = {0.};
+    for (int i = 1; i < num_points; i++)
+    {
+        double angle = 1.2 * std::sin(0.05 * i) * std::cos(0.003 * i);
+        x.push_back(x.back() + std::cos(angle));
+        y.push_back(y.back() + std::sin(angle));
+    }
+    RosTools::Spline2D spline(x, y);
+
+    // Robot positions driving along the path with a lateral offset, 0.2 m per control cycle
+    std::vector<Eigen::Vector2d> positions;
+    for (double s = 0.; s < spline.parameterLength(); s += 0.2)
+        positions.push_back(spline.getPoint(s) + 0.3 * spline.getOrthogonal(s));
+
+    ClosestPointSearch windowed, global;
+    windowed.setPath(spline);
+    global.setPath(spline);
+
+    int segment = -1, global_segment = -1;
+    double s, global_s;
+
+    double windowed_time = 0., global_time = 0.;
+    for (auto &position : positions)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        windowed.findClosestPoint(position, segment, s);
+        windowed_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        global.reset(); // Forces the bounding box search
+        global.findClosestPoint(position, global_segment, global_s);
+        global_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    std::cout << "Closest point search on " << num_points << " points (" << positions.size() << " queries):" << std::endl;
+    std::cout << "\tWindowed: " << 1e6 * windowed_time / positions.size() << " us/query ("
+              << windowed.numGlobalSearches() << " global searches)" << std::endl;
+    std::cout << "\tGlobal (bounding boxes): " << 1e6 * global_time / positions.size() << " us/query" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <mpc_planner_util/distance_field.h>
+#include <mpc_planner_util/obstacle_downsampling.h>
+#include <mpc_planner_util/occupancy_tracker.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Warehouse-like map: walls, rows of shelves and a few small obstacles
+void createMap(std::vector<unsigned char> &map, int size, std::mt19937 &generator)
+{
+    map.assign(size * size, 0);
+
+    std::uniform_int_distribution<int> cell(0, size - 1);
+    for (int x = 0; x < size; x++)
+    {
+        map[x] = 254;
+        map[(size - 1) * size + x] = 254;
+    }
+    for (int y = size / 10; y < size - size / 10; y += size / 5)
+    {
+        for (int dy = 0; dy < size / 20; dy++)
+        {
+            for (int x = size / 10; x < size - size / 10; x++)
+                map[(y + dy) * size + x] = 254;
+        }
+    }
+    for (int i = 0; i < size / 5; i++)
+        map[cell(generator) * size + cell(generator)] = 254;
+}
+
+// Move a small obstacle (e.g., a pallet) by one cell
+void moveObstacle(std::vector<unsigned char> &map, int size, int cycle)
+{
+    int y = size / 10 + size / 20 + 2, x = size / 4 + cycle - 1;
+    for (int dy = 0; dy < 4; dy++)
+    {
+        map[(y + dy) * size + x] = 0;
+        map[(y + dy) * size + x + 4] = 254;
+    }
+}
+
+// Times the distance field of DistanceFieldConstraints against the obstacle extraction of DecompConstraints
+int main()
+{
+    const int cycles = 20, N = 30;
+    const double resolution = 0.05;
+
+    std::mt19937 generator(0);
+    std::vector<unsigned char> map;
+
+    for (int size : {200, 400, 1000}) // 10, 20 and 50 m at 5 cm
+    {
+        createMap(map, size, generator);
+
+        DistanceField field(2.);
+        OccupancyTracker tracker;
+        ObstacleDownsampling downsampling(0., true);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        field.update(map.data(), size, size, 0., 0., resolution);
+        double full_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        tracker.update(map.data(), size, size, 0., 0., resolution);
+
+        double incremental_time = 0., query_time = 0., extraction_time = 0., sum = 0.;
+        int num_rows = 0, num_columns = 0;
+        for (int cycle = 1; cycle <= cycles; cycle++)
+        {
+            moveObstacle(map, size, cycle);
+
+            start = std::chrono::high_resolution_clock::now();
+            field.update(map.data(), size, size, 0., 0., resolution);
+            incremental_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            num_rows += field.numUpdatedRows();
+            num_columns += field.numUpdatedColumns();
+
+            // One halfspace per stage along a path through the map
+            start = std::chrono::high_resolution_clock::now();
+            Eigen::Vector2d gradient;
+            for (int k = 0; k < N; k++)
+            {
+                Eigen::Vector2d pos(0.1 * size * resolution + 0.1 * k, 0.15 * size * resolution);
+                sum += field.getDistance(pos, gradient) + gradient(0);
+            }
+            query_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+            // The obstacle points that DecompConstraints passes to the decomposition
+            start = std::chrono::high_resolution_clock::now();
+            tracker.update(map.data(), size, size, 0., 0., resolution);
+            downsampling.apply(tracker.getOccupied(), map.data(), size, size, 0., 0., resolution);
+            extraction_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        std::cout << "Costmap " << size << " x " << size << ": distance field " << 1e3 * full_time << " ms (full), "
+                  << 1e3 * incremental_time / cycles << " ms (incremental, " << num_rows / cycles << " rows, "
+                  << num_columns / cycles << " columns), " << 1e6 * query_time / cycles << " us for " << N << " halfspaces | "
+                  << "decomp extraction " << 1e3 * extraction_time / cycles << " ms for "
+                  << downsampling.getPoints().size() << " points (sum of distances " << sum << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <mpc_planner_util/halfspace_tensor.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Times the halfspace computation of the linearized constraints (run once per planner in T-MPC), scalar and vectorized
+int main()
+{
+    std::cout << "Halfspace kernel (" << (halfspaceKernelUsesAVX2() ? "AVX2" : "scalar") << "):" << std::endl;
+
+    const int max_obstacles = 64, repetitions = 200;
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> position(-20., 20.);
+    std::uniform_real_distribution<double> radius(0.3, 0.6);
+
+    std::vector<double> obstacle_x, obstacle_y, offset;
+    for (int i = 0; i < max_obstacles; i++)
+    {
+        obstacle_x.push_back(position(generator));
+        obstacle_y.push_back(position(generator));
+        offset.push_back(radius(generator) + 0.325);
+    }
+
+    std::vector<double> params; // Stands in for the solver parameters
+
+    for (int num_obstacles : {4, 12, 32, 64})
+    {
+        for (int n_discs : {1, 2, 3})
+        {
+            for (int N : {20, 30, 50})
+            {
+                HalfspaceTensor tensor(n_discs, N, num_obstacles);
+                params.assign((size_t)N * n_discs * num_obstacles * 3, 0.);
+
+                auto run = [&](bool vectorized)
+                {
+                    auto start = std::chrono::high_resolution_clock::now();
+                    for (int r = 0; r < repetitions; r++)
+                    {
+                        Eigen::Vector2d pos(0.01 * r, 0.);
+                        for (int k = 0; k < N; k++)
+                        {
+                            for (int d = 0; d < n_discs; d++)
+                            {
+                                if (vectorized)
+                                    computeObstacleHalfspaces(obstacle_x.data(), obstacle_y.data(), offset.data(), num_obstacles,
+                                                              pos, tensor.a1(d, k), tensor.a2(d, k), tensor.b(d, k));
+                                else
+                                    computeObstacleHalfspacesScalar(obstacle_x.data(), obstacle_y.data(), offset.data(), num_obstacles,
+                                                                    pos, tensor.a1(d, k), tensor.a2(d, k), tensor.b(d, k));
+                            }
+                        }
+
+                        // Stream the tensor into the parameters, as in setParameters
+                        size_t index = 0;
+                        for (int k = 0; k < N; k++)
+                        {
+                            for (int d = 0; d < n_discs; d++)
+                            {
+                                for (int i = 0; i < num_obstacles; i++)
+                                {
+                                    params[index++] = tensor.a1(d, k)[i];
+                                    params[index++] = tensor.a2(d, k)[i];
+                                    params[index++] = tensor.b(d, k)[i];
+                                }
+                            }
+                        }
+                    }
+                    return 1e6 * std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repetitions;
+                };
+
+                double scalar_time = run(false);
+                double kernel_time = run(true);
+
+                std::cout << "\tobstacles: " << num_obstacles << ", discs: " << n_discs << ", N: " << N
+                          << " -> scalar: " << scalar_time << " us, kernel: " << kernel_time << " us (first parameter "
+                          << params[0] << ")" << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
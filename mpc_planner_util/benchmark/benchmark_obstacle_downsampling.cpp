@@ -0,0 +1,74 @@
+#include <mpc_planner_util/obstacle_downsampling.h>
+#include <mpc_planner_util/occupancy_tracker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// 10 x 10 m with rows of 0.6 m deep shelves, walls and a few small obstacles
+void createMap(double resolution, std::vector<unsigned char> &map, int &size)
+{
+    size = std::round(10. / resolution);
+    map.assign(size * size, 0);
+
+    auto fill = [&](double min_x, double min_y, double max_x, double max_y)
+    {
+        for (int y = std::max((int)(min_y / resolution), 0); y < std::min((int)(max_y / resolution), size); y++)
+        {
+            for (int x = std::max((int)(min_x / resolution), 0); x < std::min((int)(max_x / resolution), size); x++)
+                map[y * size + x] = 254;
+        }
+    };
+
+    fill(0., 0., 10., 0.2);
+    fill(0., 9.8, 10., 10.);
+    for (double y = 1.5; y < 9.; y += 2.)
+        fill(1., y, 9., y + 0.6);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> position(0., 10.);
+    for (int i = 0; i < 20; i++)
+    {
+        double x = position(generator), y = position(generator);
+        fill(x, y, x + 0.15, y + 0.15);
+    }
+}
+
+// Times the downsampling of the obstacle points of DecompConstraints in a warehouse-like map
+int main()
+{
+    const int repetitions = 20;
+
+    std::vector<unsigned char> map;
+    int size;
+
+    for (double resolution : {0.025, 0.05, 0.1})
+    {
+        createMap(resolution, map, size);
+
+        OccupancyTracker tracker;
+        tracker.update(map.data(), size, size, 0., 0., resolution);
+
+        for (auto setting : std::vector<std::pair<double, bool>>{{0., false}, {0., true}, {0.1, true}, {0.2, true}})
+        {
+            ObstacleDownsampling downsampling(setting.first, setting.second);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < repetitions; i++)
+                downsampling.apply(tracker.getOccupied(), map.data(), size, size, 0., 0., resolution);
+            double time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repetitions;
+
+            std::cout << "Resolution " << 100. * resolution << " cm, "
+                      << (setting.second ? "boundary only" : "all cells") << ", tolerance " << setting.first << " m: "
+                      << tracker.getOccupied().size() << " -> " << downsampling.getPoints().size() << " points "
+                      << "(offset " << downsampling.getOffset() << " m) in " << 1e6 * time << " us" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <mpc_planner_util/occupancy_tracker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+const double resolution = 0.05;
+std::mt19937 generator(0);
+
+// Occupied cells of a global map, read through a rolling window
+struct World
+{
+    int size;
+    std::vector<unsigned char> cells;
+
+    unsigned char get(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= size || y >= size)
+            return 0;
+        return cells[y * size + x];
+    }
+};
+
+World createWorld(int size, double occupied)
+{
+    std::uniform_real_distribution<double> distribution(0., 1.);
+
+    World world{size, std::vector<unsigned char>(size * size, 0)};
+    for (auto &cell : world.cells)
+        cell = distribution(generator) < occupied ? 254 : 0;
+    return world;
+}
+
+void readWindow(const World &world, int window_x, int window_y, int size, std::vector<unsigned char> &map)
+{
+    map.resize(size * size);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+            map[y * size + x] = world.get(window_x + x, window_y + y);
+    }
+}
+
+// Change a fraction of the cells of the world inside the window
+void churn(World &world, int window_x, int window_y, int size, double fraction)
+{
+    std::uniform_int_distribution<int> cell(0, size - 1);
+    int num_changes = fraction * size * size;
+    for (int i = 0; i < num_changes; i++)
+    {
+        int x = std::min(window_x + cell(generator), world.size - 1), y = std::min(window_y + cell(generator), world.size - 1);
+        world.cells[y * world.size + x] = world.cells[y * world.size + x] == 0 ? 254 : 0;
+    }
+}
+
+// As before: all cells every cycle
+void fullScan(const std::vector<unsigned char> &map, int size, double origin_x, double origin_y,
+              std::vector<Eigen::Vector2d> &occupied)
+{
+    occupied.clear();
+    for (int x = 0; x < size; x++)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            if (map[y * size + x] == 0)
+                continue;
+            occupied.emplace_back(origin_x + (x + 0.5) * resolution, origin_y + (y + 0.5) * resolution);
+        }
+    }
+}
+
+// Cells within range of a diagonal path through the map, one interval per row
+void pathRegion(int size, int path_start, int path_end, int range, std::vector<int> &row_begin, std::vector<int> &row_end)
+{
+    row_begin.assign(size, size);
+    row_end.assign(size, 0);
+    for (int i = path_start; i <= path_end; i++)
+    {
+        for (int y = std::max(i - range, 0); y <= std::min(i + range, size - 1); y++)
+        {
+            row_begin[y] = std::min(row_begin[y], i - range);
+            row_end[y] = std::max(row_end[y], i + range + 1);
+        }
+    }
+}
+
+// Times the extraction on large global costmaps, of the complete map and of the region around a moving path
+void benchmarkRegion()
+{
+    const int cycles = 20, range = 40; // 2 m
+
+    for (int size : {1000, 2000, 4000}) // 50, 100 and 200 m global costmaps at 5 cm
+    {
+        World world = createWorld(size, 0.01);
+
+        OccupancyTracker full_tracker, region_tracker;
+        std::vector<int> row_begin, row_end;
+        std::vector<Eigen::Vector2d> occupied;
+        double full_time = 0., rebuild_time = 0., region_time = 0.;
+
+        // The first update allocates the cache for the complete map
+        pathRegion(size, size / 2, size / 2 + 100, range, row_begin, row_end);
+        region_tracker.setRegion(row_begin, row_end);
+        region_tracker.update(world.cells.data(), size, size, 0., 0., resolution);
+
+        for (int cycle = 0; cycle < cycles; cycle++)
+        {
+            pathRegion(size, size / 2 + cycle, size / 2 + cycle + 100, range, row_begin, row_end); // 5 m path
+
+            auto start = std::chrono::high_resolution_clock::now();
+            fullScan(world.cells, size, 0., 0., occupied);
+            full_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+            // Scan of the complete map when the tracker needs to rebuild
+            full_tracker.reset();
+            start = std::chrono::high_resolution_clock::now();
+            full_tracker.update(world.cells.data(), size, size, 0., 0., resolution);
+            rebuild_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+            // Only the region around the moving path
+            region_tracker.setRegion(row_begin, row_end);
+            start = std::chrono::high_resolution_clock::now();
+            region_tracker.update(world.cells.data(), size, size, 0., 0., resolution);
+            region_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        std::cout << "Global costmap " << size << " x " << size << ": "
+                  << "full scan " << 1e3 * full_time / cycles << " ms, "
+                  << "rebuild " << 1e3 * rebuild_time / cycles << " ms, "
+                  << "around the path " << 1e3 * region_time / cycles << " ms (" << region_tracker.getOccupied().size()
+                  << " of " << full_tracker.getOccupied().size() << " cells)" << std::endl;
+    }
+}
+
+// Times the occupied cell extraction of the decomposition constraints on synthetic static and rolling costmaps
+int main()
+{
+    const int cycles = 20;
+
+    for (bool rolling : {false, true})
+    {
+        for (int size : {100, 200, 400}) // 5, 10 and 20 m at 5 cm
+        {
+            for (double fraction : {0.001, 0.01, 0.1})
+            {
+                World world = createWorld(size + 2 * cycles, 0.1);
+
+                OccupancyTracker tracker;
+                std::vector<unsigned char> map;
+                std::vector<Eigen::Vector2d> occupied;
+                double full_time = 0., incremental_time = 0.;
+
+                for (int cycle = 0; cycle < cycles; cycle++)
+                {
+                    int window_x = rolling ? cycle : 0, window_y = rolling ? cycle / 2 : 0;
+                    churn(world, window_x, window_y, size, fraction);
+                    readWindow(world, window_x, window_y, size, map);
+
+                    auto start = std::chrono::high_resolution_clock::now();
+                    fullScan(map, size, window_x * resolution, window_y * resolution, occupied);
+                    full_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+                    start = std::chrono::high_resolution_clock::now();
+                    tracker.update(map.data(), size, size, window_x * resolution, window_y * resolution, resolution);
+                    if (cycle > 0) // The first update builds the set
+                        incremental_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                }
+
+                std::cout << (rolling ? "Rolling" : "Static") << " costmap " << size << " x " << size << ", churn " << 100. * fraction << "%: "
+                          << "full scan " << 1e6 * full_time / cycles << " us, "
+                          << "incremental " << 1e6 * incremental_time / (cycles - 1) << " us (" << tracker.getOccupied().size()
+                          << " cells)" << std::endl;
+            }
+        }
+    }
+
+    benchmarkRegion();
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <mpc_planner_util/path_lookup_table.h>
+
+#include <ros_tools/spline.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Times point lookups on a curved path in the spline and in the lookup table sampled from it
+int main()
+{
+    // A curved path sampled every 1 m
+    double psi = 0.;
+    std::vector<double> x = {0.}, y = {0.}, s = {0.};
+    for (int i = 1; i < 40; i++)
+    {
+        psi += 0.15 * std::sin(0.2 * i);
+        x.push_back(x.back() + std::cos(psi));
+        y.push_back(y.back() + std::sin(psi));
+        s.push_back(s.back() + std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]));
+    }
+
+    RosTools::Spline2D spline(x, y, s);
+    PathLookupTable table(spline, 0.1);
+
+    int num_lookups = 100000;
+    Eigen::Vector2d sum(0., 0.);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_lookups; i++)
+        sum += spline.getPoint(s.back() * i / num_lookups);
+    double spline_time = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_lookups; i++)
+        sum -= table.getPoint(s.back() * i / num_lookups);
+    double table_time = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "Spline2D::getPoint: " << spline_time / num_lookups << " us, "
+              << "PathLookupTable::getPoint: " << table_time / num_lookups << " us "
+              << "(sum of differences " << sum.norm() << ")" << std::endl;
+
+    return 0;
+}
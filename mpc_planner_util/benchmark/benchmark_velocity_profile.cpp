@@ -0,0 +1,55 @@
+#include <mpc_planner_util/velocity_profile.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Times VelocityProfile::compute on windows of a winding route, computed in full and continued
+int main()
+{
+    const int cycles = 100;
+    const double spacing = 0.5;
+    const double max_velocity = 2., max_lateral_acceleration = 1., max_acceleration = 1., max_deceleration = 1.5;
+
+    // A winding route sampled every 0.5 m
+    std::vector<double> route_x = {0.}, route_y = {0.}, route_s = {0.};
+    double psi = 0.;
+    for (int i = 1; i < 20000; i++)
+    {
+        psi += 0.15 * std::sin(i * 0.05);
+        route_x.push_back(route_x.back() + spacing * std::cos(psi));
+        route_y.push_back(route_y.back() + spacing * std::sin(psi));
+        route_s.push_back(route_s.back() + spacing);
+    }
+
+    for (int length : {200, 1000, 5000})
+    {
+        VelocityProfile rolling(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+        VelocityProfile full(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+        double full_time = 0., rolling_time = 0.;
+
+        for (int cycle = 0; cycle < cycles; cycle++)
+        {
+            int start = 10 * cycle;
+            std::vector<double> x(route_x.begin() + start, route_x.begin() + start + length);
+            std::vector<double> y(route_y.begin() + start, route_y.begin() + start + length);
+            std::vector<double> s(route_s.begin() + start, route_s.begin() + start + length);
+
+            auto begin = std::chrono::high_resolution_clock::now();
+            full.compute(x, y, s);
+            full_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+            begin = std::chrono::high_resolution_clock::now();
+            rolling.compute(x, y, s, cycle > 0);
+            rolling_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        }
+
+        std::cout << "Path of " << length << " points: full " << 1e6 * full_time / cycles << " us, continued "
+                  << 1e6 * rolling_time / cycles << " us per path" << std::endl;
+    }
+
+    return 0;
+}
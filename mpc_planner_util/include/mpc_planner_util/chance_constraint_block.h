@@ -0,0 +1,44 @@
+#ifndef CHANCE_CONSTRAINT_BLOCK_H
+#define CHANCE_CONSTRAINT_BLOCK_H
+
+#include <vector>
+
+namespace MPCPlanner
+{
+    /** @brief Solver parameters of one obstacle constraint slot at one stage */
+    struct ChanceConstraintParameters
+    {
+        double x{0.}, y{0.};
+        double psi{0.};
+        double r{0.};                // Obstacle radius
+        double major{0.}, minor{0.}; // Standard deviations
+        double risk{0.};
+        double chi{1.}; // Quantile of the risk
+    };
+
+    /**
+     * @brief Packed [stage][slot] parameters of the chance constraints (Gaussian and ellipsoidal), computed once per cycle
+     * in the module update and streamed into the solver per stage
+     */
+    class ChanceConstraintBlock
+    {
+    public:
+        void resize(int N, int num_slots);
+
+        ChanceConstraintParameters &at(int k, int slot) { return _parameters[k * _num_slots + slot]; }
+        const ChanceConstraintParameters &at(int k, int slot) const { return _parameters[k * _num_slots + slot]; }
+
+        int numSlots() const { return _num_slots; }
+
+        /** @brief Quantile of the exponential distribution with rate 0.5 (chi-squared, 2 DOF) at 1 - risk, cached per risk */
+        double getChi(double risk);
+
+    private:
+        std::vector<ChanceConstraintParameters> _parameters;
+        int _num_slots{0};
+
+        double _cached_risk{-1.}, _cached_chi{1.};
+    };
+} // namespace MPCPlanner
+
+#endif // CHANCE_CONSTRAINT_BLOCK_H
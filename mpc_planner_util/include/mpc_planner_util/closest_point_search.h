@@ -0,0 +1,88 @@
+#ifndef CLOSEST_POINT_SEARCH_H
+#define CLOSEST_POINT_SEARCH_H
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace RosTools
+{
+    class Spline2D;
+}
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Incremental closest point search on a reference path spline
+     *
+     * The search is restricted to a window of segments around the previous closest point, extended by the distance the
+     * robot travelled since the last call. Within each segment, the closest point is refined with a bounded number of
+     * Newton iterations. A global search over a bounding box hierarchy of the segments is only used on the first call,
+     * after reset() or when the windowed result jumps away from the robot.
+     */
+    class ClosestPointSearch
+    {
+    public:
+        ClosestPointSearch(int window_behind = 2, int window_ahead = 5, int newton_iterations = 3,
+                           double jump_distance = 2.0);
+
+    public:
+        /**
+         * @brief Copy the segment coefficients of the spline and construct the segment bounding boxes
+         * @param keep_progress Continue searching from the previous closest point (the new path should use the same
+         * s-coordinates as the previous path)
+         */
+        void setPath(const RosTools::Spline2D &spline, bool keep_progress = false);
+
+        /** @brief Find the closest point on the path, interface matches RosTools::Spline2D::findClosestPoint */
+        void findClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &s_out);
+
+        /** @brief The next search will be global */
+        void reset();
+
+        int numSegments() const { return (int)_segments.size(); }
+        int numGlobalSearches() const { return _num_global_searches; }
+
+    private:
+        struct Segment
+        {
+            double start, length;
+            Eigen::Vector4d x, y; // Cubic coefficients (a, b, c, d) in the local parameter s - start
+
+            Eigen::Vector2d box_min, box_max;
+
+            Eigen::Vector2d getPoint(double ds) const;
+            Eigen::Vector2d getVelocity(double ds) const;
+            Eigen::Vector2d getAcceleration(double ds) const;
+        };
+
+        std::vector<Segment> _segments;
+
+        // Bounding boxes over ranges of consecutive segments (implicit binary tree, node 1 is the root)
+        std::vector<Eigen::Vector2d> _tree_min, _tree_max;
+        int _tree_leaves{0};
+
+        int _window_behind, _window_ahead;
+        int _newton_iterations;
+        double _jump_distance;
+
+        bool _initialized{false};
+        double _prev_s{0.};
+        Eigen::Vector2d _prev_point;
+
+        int _num_global_searches{0};
+
+        void buildIndex();
+
+        /** @brief Closest point in one segment, returns the squared distance */
+        double searchSegment(int segment, const Eigen::Vector2d &point, double &ds_out) const;
+
+        double searchWindow(const Eigen::Vector2d &point, int first, int last, int &segment_out, double &s_out) const;
+        double searchGlobal(const Eigen::Vector2d &point, int &segment_out, double &s_out) const;
+        void searchNode(int node, const Eigen::Vector2d &point, double &best_sq, int &segment_out, double &s_out) const;
+
+        int findSegment(double s) const;
+    };
+} // namespace MPCPlanner
+
+#endif // CLOSEST_POINT_SEARCH_H
@@ -3,6 +3,7 @@
 #define DATA_VISUALIZATION_H
 
 #include <Eigen/Dense>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,28 @@ namespace MPCPlanner
     struct Halfspace;
     struct ReferencePath;
 
+    /**
+     * @brief Should the markers of a topic be built and published now?
+     *
+     * No when nobody subscribes to the topic, or when the topic was published more recently than its maximum rate
+     * allows (visualization/max_rate, overridden per topic by visualization/topic_rates). Call it before constructing
+     * the markers, a true result counts as a publish.
+     */
+    bool shouldVisualize(const std::string &topic_name);
+
+    /** @brief Set by the ROS node to look up whether a topic has subscribers (otherwise all topics are published) */
+    void setVisualizationSubscriberCheck(std::function<bool(const std::string &)> &&has_subscribers);
+
+#ifdef MPC_PLANNER_ROS
+    /**
+     * @brief Register a subscriber check for ROS 1 nodes (call after ros::init)
+     *
+     * A background thread looks up the subscribers at the master once per second, so that the blocking lookup does
+     * not delay the control loop. The check only reads the result of the last lookup.
+     */
+    void startSubscriberMonitorROS1();
+#endif
+
     RosTools::ROSMarkerPublisher &visualizePathPoints(const ReferencePath &path, const std::string &topic_name,
                                                       bool publish = false, double alpha = 1.0);
 
@@ -27,8 +50,9 @@ namespace MPCPlanner
                                                   bool publish = false, double alpha = 1.0,
                                                   int color_index = 5, int color_max = 10);
 
+    /** @brief The robot radius is passed in, such that callers drawing many trajectories read it once */
     RosTools::ROSMarkerPublisher &visualizeTrajectory(const Trajectory &trajectory, const std::string &topic_name,
-                                                      bool publish = false, double alpha = 0.4,
+                                                      double robot_radius, bool publish = false, double alpha = 0.4,
                                                       int color_index = 0, int color_max = 10,
                                                       bool publish_trace = true, bool publish_regions = true);
 
@@ -0,0 +1,87 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <Eigen/Dense>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Euclidean distance transform of a grid map (e.g., a costmap_2d char map) to its nearest occupied cell
+     *
+     * Exact transform in two separable passes (Felzenszwalb and Huttenlocher): per row, the squared distance to the
+     * closest occupied cell in that row, then per column, the lower envelope of parabolas over these row distances.
+     *
+     * The transform is updated incrementally. Only rows of the map that changed since the previous update are
+     * recomputed in the first pass, and only columns in which the row distances changed in the second pass. Distances
+     * are truncated at a maximum distance, such that a change only affects the field within that distance.
+     * When the origin moves by whole cells (rolling window), the field is shifted and only the cells within the
+     * truncation distance of the edges are recomputed. Any other change of the map geometry recomputes the complete field.
+     */
+    class DistanceField
+    {
+    public:
+        /**
+         * @param max_distance Larger distances [m] are reported as max_distance
+         * @param free_value Cells with this value are free, all others are occupied (costmap_2d::FREE_SPACE = 0)
+         */
+        DistanceField(double max_distance = std::numeric_limits<double>::infinity(), unsigned char free_value = 0);
+
+    public:
+        /** @brief Update the field from a row-major map (index = y * size_x + x) */
+        void update(const unsigned char *map, int size_x, int size_y, double origin_x, double origin_y, double resolution);
+
+        /** @brief Distance [m] to the closest occupied cell center, bilinearly interpolated between cell centers */
+        double getDistance(const Eigen::Vector2d &pos) const;
+
+        /** @brief Distance and its gradient (pointing away from the obstacle, zero inside obstacles) */
+        double getDistance(const Eigen::Vector2d &pos, Eigen::Vector2d &gradient) const;
+
+        /** @brief Distance of a cell [m] */
+        double getCellDistance(int x, int y) const { return _distance[y * _size_x + x]; }
+
+        int numUpdatedRows() const { return _num_rows; } // In the last update
+        int numUpdatedColumns() const { return _num_columns; }
+
+        double getMaxDistance() const { return _max_distance; }
+
+    private:
+        double _max_distance;
+        unsigned char _free_value;
+
+        int _max_cells{0};       // Truncation distance [cells]
+        float _unreachable{0.f}; // Squared row distance of cells beyond the truncation distance
+
+        std::vector<unsigned char> _cache; // Previous map
+        int _size_x{0}, _size_y{0};
+        double _origin_x{0.}, _origin_y{0.}, _resolution{0.};
+
+        std::vector<float> _row_distance; // Squared distance [cells] to the closest occupied cell in the row
+        std::vector<float> _distance;     // Distance [m]
+
+        std::vector<char> _column_changed;
+        std::vector<std::pair<int, int>> _row_ranges; // Rows [begin, end) that need the column pass
+
+        // Buffers of the column pass
+        std::vector<float> _column;
+        std::vector<int> _parabola;
+        std::vector<float> _boundary;
+
+        // Buffers of a shift
+        std::vector<unsigned char> _shifted_cache;
+        std::vector<float> _shifted_values;
+
+        int _num_rows{0}, _num_columns{0};
+
+        void shift(int shift_x, int shift_y);
+        void updateRow(const unsigned char *row, int y, int begin, int end); // Cells [begin, end)
+        void updateColumn(int x, int begin, int end); // Rows [begin, end)
+
+        float cellDistance(int x, int y) const; // Clamped to the map
+    };
+} // namespace MPCPlanner
+
+#endif // DISTANCE_FIELD_H
@@ -0,0 +1,75 @@
+#ifndef HALFSPACE_TENSOR_H
+#define HALFSPACE_TENSOR_H
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+#include <memory>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Linear constraints a1 * x + a2 * y <= b for all discs and stages in one contiguous, aligned block
+     *
+     * Layout is [disc][stage][constraint]: the a1, a2 and b rows of one disc and stage follow each other in memory and
+     * every row is padded to a multiple of the SIMD width, such that each row starts on a 32 byte boundary.
+     */
+    class HalfspaceTensor
+    {
+    public:
+        static constexpr int ALIGNMENT = 32; // Bytes (AVX)
+
+        HalfspaceTensor() = default;
+        HalfspaceTensor(int n_discs, int N, int n_constraints);
+
+    public:
+        /** @brief Allocate the tensor, all constraints are set to zero */
+        void resize(int n_discs, int N, int n_constraints);
+
+        double *a1(int disc, int k) { return row(disc, k, 0); }
+        double *a2(int disc, int k) { return row(disc, k, 1); }
+        double *b(int disc, int k) { return row(disc, k, 2); }
+
+        const double *a1(int disc, int k) const { return row(disc, k, 0); }
+        const double *a2(int disc, int k) const { return row(disc, k, 1); }
+        const double *b(int disc, int k) const { return row(disc, k, 2); }
+
+        int numConstraints() const { return _n_constraints; }
+        int stride() const { return _stride; } // Padded row length
+
+    private:
+        struct AlignedDeleter
+        {
+            void operator()(double *data) const { std::free(data); }
+        };
+
+        std::unique_ptr<double[], AlignedDeleter> _data;
+        int _n_discs{0}, _N{0}, _n_constraints{0}, _stride{0};
+
+        double *row(int disc, int k, int component) const
+        {
+            return _data.get() + ((disc * _N + k) * 3 + component) * _stride;
+        }
+    };
+
+    /**
+     * @brief Halfspaces separating a position from circular obstacles, for all obstacles at once
+     *
+     * For each obstacle i, the normal a = (obstacle_i - pos) / ||obstacle_i - pos|| and the offset
+     * b = a^T obstacle_i - offset_i (the point on the collision circle) are written to @p a1, @p a2 and @p b.
+     * Uses AVX2 when the CPU supports it and a scalar loop otherwise.
+     */
+    void computeObstacleHalfspaces(const double *obstacle_x, const double *obstacle_y, const double *offset,
+                                   int num_obstacles, const Eigen::Vector2d &pos,
+                                   double *a1, double *a2, double *b);
+
+    /** @brief Whether computeObstacleHalfspaces runs the AVX2 kernel on this machine */
+    bool halfspaceKernelUsesAVX2();
+
+    /** @brief Scalar reference of computeObstacleHalfspaces */
+    void computeObstacleHalfspacesScalar(const double *obstacle_x, const double *obstacle_y, const double *offset,
+                                         int num_obstacles, const Eigen::Vector2d &pos,
+                                         double *a1, double *a2, double *b);
+} // namespace MPCPlanner
+
+#endif // HALFSPACE_TENSOR_H
@@ -0,0 +1,55 @@
+#ifndef OBSTACLE_DOWNSAMPLING_H
+#define OBSTACLE_DOWNSAMPLING_H
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Reduces the occupied cells of a grid map to fewer obstacle points for the convex decomposition
+     *
+     * Two optional stages:
+     * - Boundary only: cells of which all four neighbours are occupied are dropped, they are shielded by the boundary.
+     * - Voxel filter: points are replaced by the center of their voxel, with voxels of sqrt(2) * tolerance such that no
+     *   point moves by more than the tolerance.
+     *
+     * The polyhedra stay conservative when they are shrunk by getOffset(). Without any stage enabled, the occupied cells
+     * are passed through without copying them.
+     */
+    class ObstacleDownsampling
+    {
+    public:
+        /** @param tolerance Maximum distance between an occupied cell and the point that replaces it (0 disables the voxel filter) */
+        ObstacleDownsampling(double tolerance = 0., bool boundary_only = false, unsigned char free_value = 0);
+
+    public:
+        /** @brief Downsample the occupied cell centers of a row-major map (index = y * size_x + x) */
+        void apply(const std::vector<Eigen::Vector2d> &occupied, const unsigned char *map, int size_x, int size_y,
+                   double origin_x, double origin_y, double resolution);
+
+        /** @note Refers to the occupied cells passed to apply() if they were not downsampled */
+        const std::vector<Eigen::Vector2d> &getPoints() const { return _passed ? *_passed : _points; }
+
+        /** @brief Distance by which the free space should be shrunk (at least one cell when only boundaries are kept) */
+        double getOffset() const { return _offset; }
+
+    private:
+        double _tolerance;
+        bool _boundary_only;
+        unsigned char _free_value;
+
+        double _offset{0.};
+
+        std::vector<Eigen::Vector2d> _boundary, _points;
+        const std::vector<Eigen::Vector2d> *_passed{nullptr}; // Occupied cells passed through
+        std::vector<std::uint64_t> _voxels;
+
+        bool isBoundary(const Eigen::Vector2d &point, const unsigned char *map, int size_x, int size_y,
+                        double origin_x, double origin_y, double inv_resolution) const;
+    };
+} // namespace MPCPlanner
+
+#endif // OBSTACLE_DOWNSAMPLING_H
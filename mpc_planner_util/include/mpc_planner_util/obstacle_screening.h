@@ -0,0 +1,64 @@
+#ifndef OBSTACLE_SCREENING_H
+#define OBSTACLE_SCREENING_H
+
+#include <mpc_planner_types/data_types.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace YAML
+{
+    class Node;
+}
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Selects, per stage, the obstacles that the robot can reach and assigns them to the solver constraint slots
+     *
+     * An obstacle is relevant at stage k if it is within v_max * k * dt (plus the radii, the largest disc offset and
+     * `obstacle_screening/margin`) of the current robot position, i.e., if the robot could collide with it at that stage. Slots of obstacles that
+     * are not relevant are filled with inactive dummy constraints by the modules, the number of constraints in the
+     * solver does not change. Relevant obstacles keep their own slot. If there are more obstacles than slots, the
+     * obstacles closest to the warm start are kept.
+     *
+     * Without `obstacle_screening/enable`, every obstacle is assigned to its own slot.
+     */
+    class ObstacleScreening
+    {
+    public:
+        /** @param model_map The solver model map, the upper bound of "v" is used as maximum velocity */
+        ObstacleScreening(int num_slots, const YAML::Node &model_map);
+
+    public:
+        /**
+         * @brief Screen the obstacles for all stages, @p ego_positions is the warm start (k = 0 is the current position)
+         * @param chi Quantile of the risk (see ChanceConstraintBlock::getChi), Gaussian obstacles are inflated by
+         * max(3, sqrt(chi)) standard deviations
+         */
+        void update(const std::vector<Eigen::Vector2d> &ego_positions, const std::vector<DynamicObstacle> &obstacles,
+                    const std::vector<Disc> &robot_area, double robot_radius, double dt, double chi = 0.);
+
+        /** @brief Index of the obstacle in this slot, or -1 if the slot should hold a dummy (always for k = 0) */
+        int getObstacle(int k, int slot) const;
+
+        int numSlots() const { return _num_slots; }
+        int numActive() const { return _num_active; } // Active slots over all stages in the last update
+        int numScreened() const { return _num_screened; }
+
+    private:
+        bool _enable;
+        double _margin;
+        double _max_velocity;
+
+        int _num_slots, _N{0};
+        std::vector<int> _slots; // Obstacle per stage and slot [N x num_slots]
+
+        std::vector<std::pair<double, int>> _ranked; // Distance to the warm start, obstacle
+
+        int _num_active{0}, _num_screened{0};
+    };
+} // namespace MPCPlanner
+
+#endif // OBSTACLE_SCREENING_H
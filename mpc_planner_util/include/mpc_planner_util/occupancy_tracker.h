@@ -0,0 +1,83 @@
+#ifndef OCCUPANCY_TRACKER_H
+#define OCCUPANCY_TRACKER_H
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Maintains the world positions of the occupied cells of a (rolling) grid map, e.g., a costmap_2d char map
+     *
+     * The previous map is cached. On an update, rows that did not change are skipped with a memcmp and only the cells
+     * that changed between free and occupied add or remove a point, such that the cost of an update is proportional to
+     * the number of changed cells. When the origin moves by whole cells (rolling window), the cache is shifted and points
+     * that left the map are dropped. Any other change of the map geometry rebuilds the set.
+     *
+     * Optionally, only a region of the map is tracked (one interval of cells per row), for example the area around the
+     * planned path. Cells outside of the region are treated as free.
+     */
+    class OccupancyTracker
+    {
+    public:
+        /** @param free_value Cells with this value are free, all others are occupied (costmap_2d::FREE_SPACE = 0) */
+        OccupancyTracker(unsigned char free_value = 0);
+
+    public:
+        /** @brief Update the occupied cells from a row-major map (index = y * size_x + x) */
+        void update(const unsigned char *map, int size_x, int size_y, double origin_x, double origin_y, double resolution);
+
+        /** @brief Only track cells [row_begin[y], row_end[y]) of each row y in the next updates (cells of that map) */
+        void setRegion(const std::vector<int> &row_begin, const std::vector<int> &row_end);
+        void clearRegion(); // Track the complete map
+
+        void reset();
+
+        /** @brief Cell centers of all occupied cells (unordered) */
+        const std::vector<Eigen::Vector2d> &getOccupied() const { return _points; }
+
+        /** @brief Cell centers that became occupied in the last update (all cells after a rebuild) */
+        const std::vector<Eigen::Vector2d> &getAdded() const { return _added; }
+
+        int numChangedCells() const { return _num_changed; } // In the last update
+        bool lastUpdateRebuilt() const { return _rebuilt; }
+
+    private:
+        unsigned char _free_value;
+
+        std::vector<unsigned char> _cache; // Previous map (free outside of the tracked region)
+        int _size_x{0}, _size_y{0};
+        double _origin_x{0.}, _origin_y{0.}, _resolution{0.};
+        double _center_x{0.}, _center_y{0.}; // World position of the center of cell (0, 0)
+
+        std::vector<int> _row_begin, _row_end;       // Tracked region
+        std::vector<int> _region_begin, _region_end; // Requested region
+        bool _use_region{false};
+
+        std::vector<int> _slot;               // Index in _points of each cell (-1 if free)
+        std::vector<Eigen::Vector2d> _points; // Occupied cell centers
+        std::vector<int> _point_cell;         // Cell of each point
+        std::vector<Eigen::Vector2d> _added;
+
+        std::vector<unsigned char> _shifted_cache;
+        std::vector<int> _shifted_begin, _shifted_end;
+
+        int _num_changed{0};
+        bool _rebuilt{false};
+
+        void clearCache(int size_x, int size_y, double resolution);
+        void shift(int shift_x, int shift_y);
+
+        /** @brief Compare cells [begin, end) of row y with the cache and add or remove points */
+        void updateCells(const unsigned char *row, int y, int begin, int end);
+
+        /** @brief Mark cells [begin, end) of row y as free */
+        void clearCells(int y, int begin, int end);
+
+        void addPoint(int x, int y);
+        void removePoint(int cell);
+    };
+} // namespace MPCPlanner
+
+#endif // OCCUPANCY_TRACKER_H
@@ -4,11 +4,14 @@
 #include <mpc_planner_util/load_yaml.hpp>
 #include <ros_tools/logging.h>
 
+#include <atomic>
+
 #define LOG_MARK(x)                        \
     if (CONFIG["debug_output"].as<bool>()) \
     LOG_HOOK_MSG(x)
 
 #define CONFIG Configuration::getInstance().getYAMLNode()
+#define MUTABLE_CONFIG Configuration::getInstance().getMutableYAMLNode()
 
 namespace YAML
 {
@@ -34,13 +37,28 @@ public:
         loadConfigYaml(config_file, _config); // Load parameters from the YAML file
     }
 
-    YAML::Node &getYAMLNode()
+    /** @brief Read access (CONFIG) */
+    const YAML::Node &getYAMLNode() const
+    {
+        return _config;
+    }
+
+    /**
+     * @brief Write access (MUTABLE_CONFIG), increments the version
+     * @note Write from the thread of the control loop or a callback that is serialized with it (as the ROS callbacks)
+     */
+    YAML::Node &getMutableYAMLNode()
     {
+        _version++;
         return _config;
     }
 
+    /** @brief Incremented on each write access, to detect changes without comparing the configuration */
+    int getVersion() const { return _version; }
+
 private:
     YAML::Node _config;
+    std::atomic<int> _version{0};
 
     Configuration()
     {
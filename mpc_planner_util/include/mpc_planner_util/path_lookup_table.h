@@ -0,0 +1,59 @@
+#ifndef PATH_LOOKUP_TABLE_H
+#define PATH_LOOKUP_TABLE_H
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace RosTools
+{
+    class Spline2D;
+}
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Uniformly sampled arc-length table of a path spline (point, tangent, normal and curvature)
+     *
+     * Built once when a path is received. Lookups interpolate between the two neighbouring samples, which is much cheaper
+     * than evaluating the cubic spline segments. Lookups beyond the ends of the path are clamped to [start, start + length].
+     */
+    class PathLookupTable
+    {
+    public:
+        PathLookupTable(const RosTools::Spline2D &spline, double resolution);
+
+    public:
+        Eigen::Vector2d getPoint(double s) const;
+        Eigen::Vector2d getTangent(double s) const;
+
+        /** @brief Normal vector, matches RosTools::Spline2D::getOrthogonal */
+        Eigen::Vector2d getOrthogonal(double s) const;
+
+        double getPathAngle(double s) const;
+        double getCurvature(double s) const;
+
+        double start() const { return _start; }
+        double length() const { return _length; }
+        int size() const { return (int)_samples.size(); }
+
+    private:
+        struct Sample
+        {
+            Eigen::Vector2d point;
+            Eigen::Vector2d velocity; // Derivative with respect to s
+            Eigen::Vector2d normal;
+            double curvature;
+        };
+
+        std::vector<Sample> _samples;
+
+        double _start, _length; // The path covers s in [start, start + length]
+        double _resolution, _inv_resolution;
+
+        /** @brief Find the sample before s and the normalized position t in [0, 1] between it and the next sample */
+        void locate(double s, int &index, double &t) const;
+    };
+} // namespace MPCPlanner
+
+#endif // PATH_LOOKUP_TABLE_H
@@ -0,0 +1,47 @@
+#ifndef PLANNER_SCOREBOARD_H
+#define PLANNER_SCOREBOARD_H
+
+#include <atomic>
+#include <limits>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Shared state of planners that solve in parallel, used to stop planners that take more than their time share
+     *
+     * Planners report their feasible solutions. Other planners check between iterations whether they exceeded their
+     * share of the planning time. Planners are only cancelled once a feasible solution exists, such that there is always
+     * a solution to fall back on. Objectives are not compared: the objective of an unfinished (SQP-RTI) iterate does not
+     * bound the objective of the converged solution.
+     */
+    class PlannerScoreboard
+    {
+    public:
+        /** @param time_share Time [s] a planner may take once a feasible solution exists */
+        PlannerScoreboard(double time_share = std::numeric_limits<double>::infinity());
+
+    public:
+        /** @brief Clear the scoreboard at the start of a planning cycle */
+        void reset();
+
+        /** @brief Report that a planner found a feasible solution */
+        void reportSolution() { _has_solution = true; }
+
+        /** @brief Should a planner that solved for elapsed_time [s] stop? */
+        bool shouldCancel(double elapsed_time) const;
+
+        void reportCancelled() { _num_cancelled++; }
+
+        bool hasSolution() const { return _has_solution.load(); }
+        double getTimeShare() const { return _time_share; }
+        int numCancelled() const { return _num_cancelled.load(); }
+
+    private:
+        double _time_share;
+
+        std::atomic<bool> _has_solution{false};
+        std::atomic<int> _num_cancelled{0};
+    };
+} // namespace MPCPlanner
+
+#endif // PLANNER_SCOREBOARD_H
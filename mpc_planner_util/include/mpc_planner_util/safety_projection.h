@@ -0,0 +1,70 @@
+#ifndef SAFETY_PROJECTION_H
+#define SAFETY_PROJECTION_H
+
+#include <Eigen/Dense>
+
+#include <ros_tools/projection.h>
+
+#include <functional>
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Douglas-Rachford projection of a position out of circular obstacles
+     *
+     * A projection step only moves the position if it lies inside the (inflated) obstacle or inside the anchor
+     * obstacle. The obstacles of a stage are therefore stored in a uniform grid with cells of the largest radius, such
+     * that only obstacles in the neighbouring cells of the position are projected on. The projection stops as soon as
+     * the position is collision-free.
+     */
+    class SafetyProjection
+    {
+    public:
+        /** @brief Returns the closest occupied point within range of a position, or false if there is none */
+        using ClosestObstacleQuery = std::function<bool(const Eigen::Vector2d &pos, double range, Eigen::Vector2d &closest)>;
+
+        SafetyProjection(int max_iterations = 3);
+
+    public:
+        /** @brief Set the obstacles of one stage (radii including the robot). The first obstacle is the anchor. */
+        void setObstacles(const double *obstacle_x, const double *obstacle_y, const double *radius, int num_obstacles);
+
+        /** @brief Project @p pos out of the obstacles, returns true if it is collision-free afterwards */
+        bool project(Eigen::Vector2d &pos);
+
+        /** @brief Project @p pos out of the obstacles returned by a distance query (e.g., on a costmap) */
+        bool project(Eigen::Vector2d &pos, double radius, const ClosestObstacleQuery &query);
+
+        int numProjectionSteps() const { return _num_steps; } // Since the last setObstacles
+
+    private:
+        struct Cell
+        {
+            int x, y;
+            int obstacle;
+
+            bool operator<(const Cell &other) const { return x < other.x || (x == other.x && y < other.y); }
+        };
+
+        DouglasRachford _dr_projection;
+        int _max_iterations;
+
+        std::vector<Eigen::Vector2d> _obstacles;
+        std::vector<double> _radius;
+        double _max_radius{0.};
+
+        double _inv_cell_size{1.};
+        std::vector<Cell> _cells; // Sorted by cell
+
+        std::vector<int> _candidates;
+        int _num_steps{0};
+
+        /** @brief Obstacles that the projection step would move @p pos for, in their original order */
+        void findCandidates(const Eigen::Vector2d &pos);
+
+        int cellIndex(double coordinate) const;
+    };
+} // namespace MPCPlanner
+
+#endif // SAFETY_PROJECTION_H
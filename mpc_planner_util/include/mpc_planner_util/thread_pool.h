@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Persistent pool of worker threads, optionally pinned to one core each
+     *
+     * Workers are created once and wait for work, such that running tasks in parallel does not spawn threads every
+     * control cycle.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @param num_threads Number of workers (0 = one per available core)
+         * @param pin_threads Pin worker i to core i (Linux only)
+         * @param initialize Called once by each worker (with its index) before it runs tasks, e.g., to set OpenMP options
+         */
+        ThreadPool(int num_threads = 0, bool pin_threads = true, std::function<void(int)> initialize = nullptr);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+    public:
+        /** @brief Run task(i) for i in [0, n) on the workers and wait until all are done */
+        void parallelFor(int n, const std::function<void(int)> &task);
+
+        int numThreads() const { return _workers.size(); }
+
+        static int numAvailableCores();
+
+    private:
+        std::vector<std::thread> _workers;
+
+        std::mutex _mutex;
+        std::condition_variable _work_available, _work_done;
+
+        const std::function<void(int)> *_task{nullptr};
+        int _num_tasks{0};
+        std::atomic<int> _next_task{0};
+        int _num_finished_workers{0};
+        unsigned int _generation{0};
+        bool _stop{false};
+
+        void run(int worker, bool pin, std::function<void(int)> initialize);
+    };
+} // namespace MPCPlanner
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,58 @@
+#ifndef VELOCITY_PROFILE_H
+#define VELOCITY_PROFILE_H
+
+#include <vector>
+
+namespace MPCPlanner
+{
+    /**
+     * @brief Time-optimal velocity profile along the points of a path
+     *
+     * Each point is limited by the maximum velocity and by the lateral acceleration in the curvature of the path through
+     * the point and its neighbours (v <= sqrt(a_lat / curvature)). A forward pass limits the acceleration and a backward
+     * pass limits the deceleration, such that the robot stops at the end of the path. If the path is a window of a longer
+     * route (stop_at_end = false), the last point keeps the curvature limit of its neighbour instead.
+     *
+     * For a continued path (points dropped at the front, points appended at the back, s-coordinates unchanged), the
+     * curvature limits of the points that remain are reused and only those of the new points are computed. Points are
+     * only reused if their position and s-coordinate did not change, such that a path that was refit with the same
+     * s-coordinates is recomputed. The passes are repeated, they are cheap compared to the curvature.
+     */
+    class VelocityProfile
+    {
+    public:
+        VelocityProfile(double max_velocity, double max_lateral_acceleration, double max_acceleration, double max_deceleration,
+                        bool stop_at_end = true);
+
+    public:
+        /** @brief Compute the profile at the points (x, y) with distances s along the path */
+        void compute(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &s,
+                     bool continuation = false);
+
+        const std::vector<double> &getS() const { return _s; }
+        const std::vector<double> &getVelocity() const { return _v; }
+
+        /** @brief Points of which the limits were reused from the previous path */
+        int numReused() const { return _num_reused; }
+
+    private:
+        double _max_velocity;
+        double _max_lateral_acceleration;
+        double _max_acceleration;
+        double _max_deceleration;
+        bool _stop_at_end;
+
+        std::vector<double> _x, _y, _s; // Points of the previous path
+        std::vector<double> _limit;     // Curvature limit per point
+        std::vector<double> _v;
+        int _num_reused{0};
+
+        /** @brief Number of points at the front of the path that are in the previous path, starting at its point offset */
+        int findOverlap(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &s,
+                        int &offset) const;
+
+        double curvatureLimit(const std::vector<double> &x, const std::vector<double> &y, int i) const;
+    };
+} // namespace MPCPlanner
+
+#endif // VELOCITY_PROFILE_H
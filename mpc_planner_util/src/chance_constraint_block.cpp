@@ -0,0 +1,22 @@
+#include <mpc_planner_util/chance_constraint_block.h>
+
+#include <ros_tools/math.h>
+
+namespace MPCPlanner
+{
+    void ChanceConstraintBlock::resize(int N, int num_slots)
+    {
+        _num_slots = num_slots;
+        _parameters.resize(N * num_slots);
+    }
+
+    double ChanceConstraintBlock::getChi(double risk)
+    {
+        if (risk != _cached_risk)
+        {
+            _cached_chi = RosTools::ExponentialQuantile(0.5, 1.0 - risk);
+            _cached_risk = risk;
+        }
+        return _cached_chi;
+    }
+} // namespace MPCPlanner
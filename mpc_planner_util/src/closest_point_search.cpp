@@ -0,0 +1,290 @@
+#include <mpc_planner_util/closest_point_search.h>
+
+#include <ros_tools/spline.h>
+#include <ros_tools/logging.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace MPCPlanner
+{
+    namespace
+    {
+        /** @brief Extend [min_out, max_out] with the extremes of a*t^3 + b*t^2 + c*t + d on [0, length] */
+        void cubicRange(const Eigen::Vector4d &coeffs, double length, double &min_out, double &max_out)
+        {
+            auto evaluate = [&](double t)
+            { return ((coeffs(0) * t + coeffs(1)) * t + coeffs(2)) * t + coeffs(3); };
+
+            auto add = [&](double t)
+            {
+                if (t < 0. || t > length)
+                    return;
+                double value = evaluate(t);
+                min_out = std::min(min_out, value);
+                max_out = std::max(max_out, value);
+            };
+
+            add(0.);
+            add(length);
+
+            // Extremes where the derivative 3a t^2 + 2b t + c is zero
+            double qa = 3. * coeffs(0), qb = 2. * coeffs(1), qc = coeffs(2);
+            if (std::abs(qa) < 1e-12)
+            {
+                if (std::abs(qb) > 1e-12)
+                    add(-qc / qb);
+                return;
+            }
+
+            double discriminant = qb * qb - 4. * qa * qc;
+            if (discriminant < 0.)
+                return;
+
+            double root = std::sqrt(discriminant);
+            add((-qb + root) / (2. * qa));
+            add((-qb - root) / (2. * qa));
+        }
+
+        double boxDistanceSquared(const Eigen::Vector2d &point, const Eigen::Vector2d &box_min, const Eigen::Vector2d &box_max)
+        {
+            if (box_min(0) > box_max(0)) // Empty box
+                return std::numeric_limits<double>::infinity();
+
+            Eigen::Vector2d delta = (box_min - point).cwiseMax(point - box_max).cwiseMax(0.);
+            return delta.squaredNorm();
+        }
+    }
+
+    Eigen::Vector2d ClosestPointSearch::Segment::getPoint(double ds) const
+    {
+        return Eigen::Vector2d(((x(0) * ds + x(1)) * ds + x(2)) * ds + x(3),
+                               ((y(0) * ds + y(1)) * ds + y(2)) * ds + y(3));
+    }
+
+    Eigen::Vector2d ClosestPointSearch::Segment::getVelocity(double ds) const
+    {
+        return Eigen::Vector2d((3. * x(0) * ds + 2. * x(1)) * ds + x(2),
+                               (3. * y(0) * ds + 2. * y(1)) * ds + y(2));
+    }
+
+    Eigen::Vector2d ClosestPointSearch::Segment::getAcceleration(double ds) const
+    {
+        return Eigen::Vector2d(6. * x(0) * ds + 2. * x(1),
+                               6. * y(0) * ds + 2. * y(1));
+    }
+
+    ClosestPointSearch::ClosestPointSearch(int window_behind, int window_ahead, int newton_iterations, double jump_distance)
+        : _window_behind(window_behind), _window_ahead(window_ahead),
+          _newton_iterations(newton_iterations), _jump_distance(jump_distance)
+    {
+    }
+
+    void ClosestPointSearch::setPath(const RosTools::Spline2D &spline, bool keep_progress)
+    {
+        int num_segments = spline.numSegments();
+        _segments.resize(num_segments);
+
+        for (int i = 0; i < num_segments; i++)
+        {
+            Segment &segment = _segments[i];
+
+            spline.getParameters(i,
+                                 segment.x(0), segment.x(1), segment.x(2), segment.x(3),
+                                 segment.y(0), segment.y(1), segment.y(2), segment.y(3));
+
+            segment.start = spline.getSegmentStart(i);
+            double end = (i < num_segments - 1) ? spline.getSegmentStart(i + 1) : spline.parameterLength();
+            segment.length = std::max(end - segment.start, 0.);
+
+            segment.box_min = Eigen::Vector2d::Constant(std::numeric_limits<double>::infinity());
+            segment.box_max = Eigen::Vector2d::Constant(-std::numeric_limits<double>::infinity());
+            cubicRange(segment.x, segment.length, segment.box_min(0), segment.box_max(0));
+            cubicRange(segment.y, segment.length, segment.box_min(1), segment.box_max(1));
+        }
+
+        buildIndex();
+
+        if (!keep_progress)
+            reset();
+    }
+
+    void ClosestPointSearch::buildIndex()
+    {
+        _tree_leaves = 1;
+        while (_tree_leaves < (int)_segments.size())
+            _tree_leaves *= 2;
+
+        _tree_min.assign(2 * _tree_leaves, Eigen::Vector2d::Constant(std::numeric_limits<double>::infinity()));
+        _tree_max.assign(2 * _tree_leaves, Eigen::Vector2d::Constant(-std::numeric_limits<double>::infinity()));
+
+        for (size_t i = 0; i < _segments.size(); i++)
+        {
+            _tree_min[_tree_leaves + i] = _segments[i].box_min;
+            _tree_max[_tree_leaves + i] = _segments[i].box_max;
+        }
+
+        for (int node = _tree_leaves - 1; node >= 1; node--)
+        {
+            _tree_min[node] = _tree_min[2 * node].cwiseMin(_tree_min[2 * node + 1]);
+            _tree_max[node] = _tree_max[2 * node].cwiseMax(_tree_max[2 * node + 1]);
+        }
+    }
+
+    void ClosestPointSearch::reset()
+    {
+        _initialized = false;
+    }
+
+    void ClosestPointSearch::findClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &s_out)
+    {
+        ROSTOOLS_ASSERT(!_segments.empty(), "The closest point search requires a path (call setPath first)");
+
+        double travelled = _initialized ? (point - _prev_point).norm() : 0.;
+
+        // Global search on the first call, after a reset or when the robot moved unexpectedly far
+        bool global = !_initialized || segment_out < 0 || travelled > _jump_distance;
+
+        if (!global)
+        {
+            // Search around the previous closest point, extended by the distance travelled in both directions
+            int first = std::max(findSegment(_prev_s - travelled) - _window_behind, 0);
+            int last = std::min(findSegment(_prev_s + travelled) + _window_ahead, (int)_segments.size() - 1);
+
+            searchWindow(point, first, last, segment_out, s_out);
+
+            // If the minimum lies on the boundary of the window, the true closest point may be outside of it
+            bool on_first_boundary = first > 0 && s_out <= _segments[first].start;
+            bool on_last_boundary = last < (int)_segments.size() - 1 &&
+                                    s_out >= _segments[last].start + _segments[last].length;
+
+            global = on_first_boundary || on_last_boundary;
+        }
+
+        if (global)
+        {
+            searchGlobal(point, segment_out, s_out);
+            _num_global_searches++;
+        }
+
+        _initialized = true;
+        _prev_s = s_out;
+        _prev_point = point;
+    }
+
+    double ClosestPointSearch::searchSegment(int segment, const Eigen::Vector2d &point, double &ds_out) const
+    {
+        const Segment &cur_segment = _segments[segment];
+
+        // Coarse samples to select the starting point of the refinement
+        double best_sq = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 4; i++)
+        {
+            double ds = cur_segment.length * (double)i / 3.;
+            double distance_sq = (cur_segment.getPoint(ds) - point).squaredNorm();
+            if (distance_sq < best_sq)
+            {
+                best_sq = distance_sq;
+                ds_out = ds;
+            }
+        }
+
+        // Newton refinement of d/ds 0.5 ||p(s) - point||^2 = 0
+        double ds = ds_out;
+        for (int i = 0; i < _newton_iterations; i++)
+        {
+            Eigen::Vector2d error = cur_segment.getPoint(ds) - point;
+            Eigen::Vector2d velocity = cur_segment.getVelocity(ds);
+
+            double gradient = error.dot(velocity);
+            double hessian = velocity.squaredNorm() + error.dot(cur_segment.getAcceleration(ds));
+            if (hessian <= 1e-9)
+                break;
+
+            double new_ds = std::min(std::max(ds - gradient / hessian, 0.), cur_segment.length);
+            if (std::abs(new_ds - ds) < 1e-6)
+                break;
+            ds = new_ds;
+        }
+
+        double distance_sq = (cur_segment.getPoint(ds) - point).squaredNorm();
+        if (distance_sq < best_sq)
+        {
+            best_sq = distance_sq;
+            ds_out = ds;
+        }
+
+        return best_sq;
+    }
+
+    double ClosestPointSearch::searchWindow(const Eigen::Vector2d &point, int first, int last,
+                                            int &segment_out, double &s_out) const
+    {
+        double best_sq = std::numeric_limits<double>::infinity();
+
+        for (int i = first; i <= last; i++)
+        {
+            // Skip segments that cannot contain a closer point
+            if (boxDistanceSquared(point, _segments[i].box_min, _segments[i].box_max) >= best_sq)
+                continue;
+
+            double ds;
+            double distance_sq = searchSegment(i, point, ds);
+            if (distance_sq < best_sq)
+            {
+                best_sq = distance_sq;
+                segment_out = i;
+                s_out = _segments[i].start + ds;
+            }
+        }
+
+        return best_sq;
+    }
+
+    double ClosestPointSearch::searchGlobal(const Eigen::Vector2d &point, int &segment_out, double &s_out) const
+    {
+        double best_sq = std::numeric_limits<double>::infinity();
+        searchNode(1, point, best_sq, segment_out, s_out);
+        return best_sq;
+    }
+
+    void ClosestPointSearch::searchNode(int node, const Eigen::Vector2d &point,
+                                        double &best_sq, int &segment_out, double &s_out) const
+    {
+        if (boxDistanceSquared(point, _tree_min[node], _tree_max[node]) >= best_sq)
+            return;
+
+        if (node >= _tree_leaves) // Leaf: a single segment
+        {
+            int segment = node - _tree_leaves;
+
+            double ds;
+            double distance_sq = searchSegment(segment, point, ds);
+            if (distance_sq < best_sq)
+            {
+                best_sq = distance_sq;
+                segment_out = segment;
+                s_out = _segments[segment].start + ds;
+            }
+            return;
+        }
+
+        // Descend into the closest child first to tighten the bound early
+        int left = 2 * node, right = 2 * node + 1;
+        if (boxDistanceSquared(point, _tree_min[right], _tree_max[right]) <
+            boxDistanceSquared(point, _tree_min[left], _tree_max[left]))
+            std::swap(left, right);
+
+        searchNode(left, point, best_sq, segment_out, s_out);
+        searchNode(right, point, best_sq, segment_out, s_out);
+    }
+
+    int ClosestPointSearch::findSegment(double s) const
+    {
+        auto it = std::upper_bound(_segments.begin(), _segments.end(), s,
+                                   [](double value, const Segment &segment)
+                                   { return value < segment.start; });
+
+        return std::max((int)(it - _segments.begin()) - 1, 0);
+    }
+} // namespace MPCPlanner
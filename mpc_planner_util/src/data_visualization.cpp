@@ -6,17 +6,196 @@
 #include <mpc_planner_types/data_types.h>
 #include <mpc_planner_util/parameters.h>
 
+#ifdef MPC_PLANNER_ROS
+#include <ros/master.h>
+#include <ros/names.h>
+#include <ros/this_node.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace MPCPlanner
 {
+    namespace
+    {
+        struct TopicBudget
+        {
+            std::chrono::duration<double> min_period;
+            std::chrono::steady_clock::time_point last_published, last_check;
+            bool published{false};
+            bool checked{false};
+            bool subscribed{true};
+        };
+
+        const std::chrono::duration<double> SUBSCRIBER_CHECK_PERIOD(1.0); // Looking up subscribers is not free
+
+        std::mutex budget_mutex;
+        std::unordered_map<std::string, TopicBudget> topic_budgets;
+        std::function<bool(const std::string &)> subscriber_check;
+
+        double getMaxRate(const std::string &topic_name)
+        {
+            const auto &visualization = CONFIG["visualization"];
+            if (visualization["topic_rates"] && visualization["topic_rates"][topic_name])
+                return visualization["topic_rates"][topic_name].as<double>();
+
+            if (visualization["max_rate"])
+                return visualization["max_rate"].as<double>();
+
+            return 0.;
+        }
+    }
+
+    bool shouldVisualize(const std::string &topic_name)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        auto now = std::chrono::steady_clock::now();
+
+        auto it = topic_budgets.find(topic_name);
+        if (it == topic_budgets.end())
+        {
+            double max_rate = getMaxRate(topic_name);
+            it = topic_budgets.emplace(topic_name, TopicBudget()).first;
+            it->second.min_period = std::chrono::duration<double>(max_rate > 0. ? 1. / max_rate : 0.);
+        }
+        auto &budget = it->second;
+
+        if (subscriber_check && (!budget.checked || now - budget.last_check > SUBSCRIBER_CHECK_PERIOD))
+        {
+            budget.subscribed = subscriber_check(topic_name);
+            budget.last_check = now;
+            budget.checked = true;
+        }
+
+        if (!budget.subscribed)
+            return false;
+
+        if (budget.published && now - budget.last_published < budget.min_period)
+            return false;
+
+        budget.last_published = now;
+        budget.published = true;
+        return true;
+    }
+
+    void setVisualizationSubscriberCheck(std::function<bool(const std::string &)> &&has_subscribers)
+    {
+        std::lock_guard<std::mutex> lock(budget_mutex);
+        subscriber_check = has_subscribers;
+        for (auto &topic : topic_budgets)
+            topic.second.checked = false;
+    }
+
+#ifdef MPC_PLANNER_ROS
+    namespace
+    {
+        /** @brief Looks up the subscribers at the ROS 1 master on its own thread (the XML-RPC call blocks) */
+        class SubscriberMonitorROS1
+        {
+        public:
+            SubscriberMonitorROS1()
+            {
+                _thread = std::thread(&SubscriberMonitorROS1::run, this);
+            }
+
+            ~SubscriberMonitorROS1()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _wake.notify_one();
+                _thread.join();
+            }
+
+            /** @brief Result of the last lookup, true until the topic was looked up */
+            bool hasSubscribers(const std::string &topic_name)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _topics.find(topic_name);
+                if (it == _topics.end()) // The markers are published in the private namespace of the node
+                    it = _topics.emplace(topic_name, Topic{ros::names::resolve("~" + topic_name), std::make_unique<std::atomic<bool>>(true)}).first;
+
+                return it->second.subscribed->load();
+            }
+
+        private:
+            struct Topic
+            {
+                std::string resolved_name;
+                std::unique_ptr<std::atomic<bool>> subscribed;
+            };
+
+            std::unordered_map<std::string, Topic> _topics;
+            std::mutex _mutex; // Not held during the lookup
+
+            std::thread _thread;
+            std::condition_variable _wake;
+            bool _stop{false};
+
+            void run()
+            {
+                std::vector<std::pair<std::string, std::atomic<bool> *>> topics;
+                std::unordered_set<std::string> subscribed_topics;
+                while (true)
+                {
+                    topics.clear();
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _wake.wait_for(lock, SUBSCRIBER_CHECK_PERIOD, [this]()
+                                       { return _stop; });
+                        if (_stop)
+                            return;
+
+                        for (auto &topic : _topics) // Topics are never removed, the flags stay valid
+                            topics.emplace_back(topic.second.resolved_name, topic.second.subscribed.get());
+                    }
+
+                    // One lookup returns the subscribers of all topics
+                    XmlRpc::XmlRpcValue args, result, payload;
+                    args[0] = ros::this_node::getName();
+                    bool reachable = ros::master::execute("getSystemState", args, result, payload, false) && payload.size() > 1;
+
+                    subscribed_topics.clear();
+                    if (reachable)
+                    {
+                        XmlRpc::XmlRpcValue &subscribers = payload[1]; // [[topic, [subscriber nodes]], ...]
+                        for (int i = 0; i < subscribers.size(); i++)
+                            subscribed_topics.insert(static_cast<std::string>(subscribers[i][0]));
+                    }
+
+                    for (auto &topic : topics) // Publish everything while the master does not answer
+                        topic.second->store(!reachable || subscribed_topics.count(topic.first) > 0);
+                }
+            }
+        };
+
+        std::unique_ptr<SubscriberMonitorROS1> subscriber_monitor;
+    }
+
+    void startSubscriberMonitorROS1()
+    {
+        subscriber_monitor = std::make_unique<SubscriberMonitorROS1>();
+        setVisualizationSubscriberCheck([](const std::string &topic_name)
+                                        { return subscriber_monitor->hasSubscribers(topic_name); });
+    }
+#endif
 
     RosTools::ROSMarkerPublisher &visualizeTrajectory(const Trajectory &trajectory, const std::string &topic_name,
-                                                      bool publish, double alpha, int color_index, int color_max,
-                                                      bool publish_trace, bool publish_regions)
+                                                      double robot_radius, bool publish, double alpha, int color_index,
+                                                      int color_max, bool publish_trace, bool publish_regions)
     {
         RosTools::ROSMarkerPublisher &publisher = VISUALS.getPublisher(topic_name);
 
         auto &cylinder = publisher.getNewPointMarker("CYLINDER");
-        cylinder.setScale(2. * CONFIG["robot_radius"].as<double>(), 2. * CONFIG["robot_radius"].as<double>(), 0.01);
+        cylinder.setScale(2. * robot_radius, 2. * robot_radius, 0.01);
 
         auto &line = publisher.getNewLine();
         line.setScale(0.15, 0.15);
@@ -228,8 +407,10 @@ namespace MPCPlanner
     {
         RosTools::ROSMarkerPublisher &publisher = VISUALS.getPublisher(topic_name);
 
+        double robot_radius = CONFIG["robot_radius"].as<double>();
+
         auto &cylinder = publisher.getNewPointMarker("CYLINDER");
-        cylinder.setScale(2. * CONFIG["robot_radius"].as<double>(), 2. * CONFIG["robot_radius"].as<double>(), 0.01);
+        cylinder.setScale(2. * robot_radius, 2. * robot_radius, 0.01);
         cylinder.setColorInt(0, 10, alpha);
 
         for (size_t k = 0; k < trajectory.positions.size(); k++)
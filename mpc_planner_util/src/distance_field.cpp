@@ -0,0 +1,279 @@
+#include <mpc_planner_util/distance_field.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace MPCPlanner
+{
+    DistanceField::DistanceField(double max_distance, unsigned char free_value)
+        : _max_distance(max_distance), _free_value(free_value)
+    {
+    }
+
+    void DistanceField::update(const unsigned char *map, int size_x, int size_y, double origin_x, double origin_y, double resolution)
+    {
+        _num_rows = 0;
+        _num_columns = 0;
+
+        // A rolling window moves by whole cells
+        double cells_x = _resolution > 0. ? (origin_x - _origin_x) / resolution : 0.;
+        double cells_y = _resolution > 0. ? (origin_y - _origin_y) / resolution : 0.;
+        int shift_x = std::lround(cells_x), shift_y = std::lround(cells_y);
+
+        bool rebuild = size_x != _size_x || size_y != _size_y || resolution != _resolution || _cache.empty() ||
+                       std::abs(cells_x - shift_x) > 1e-3 || std::abs(cells_y - shift_y) > 1e-3 ||
+                       std::abs(shift_x) >= size_x || std::abs(shift_y) >= size_y;
+        if (rebuild)
+        {
+            _size_x = size_x;
+            _size_y = size_y;
+            _resolution = resolution;
+
+            _max_cells = size_x + size_y;
+            if (!std::isinf(_max_distance))
+                _max_cells = std::min(_max_cells, (int)std::ceil(_max_distance / resolution));
+            _unreachable = (float)(_max_cells + 1) * (_max_cells + 1);
+
+            _cache.assign(size_x * size_y, 0);
+            _row_distance.assign(size_x * size_y, 0.f);
+            _distance.assign(size_x * size_y, 0.f);
+            _column.resize(size_y);
+            _parabola.resize(size_y);
+            _boundary.resize(size_y + 1);
+
+            shift_x = 0;
+            shift_y = 0;
+        }
+        else if (shift_x != 0 || shift_y != 0)
+        {
+            shift(shift_x, shift_y);
+        }
+        _origin_x = origin_x;
+        _origin_y = origin_y;
+
+        // Rows that moved vertically lose or gain neighbours in all columns
+        _column_changed.assign(size_x, (rebuild || shift_y != 0) ? 1 : 0);
+
+        // Rows that entered the map are always updated
+        int entered_begin = shift_y > 0 ? size_y - shift_y : 0;
+        int entered_end = shift_y > 0 ? size_y : -shift_y;
+
+        // Cells that were kept horizontally, those that entered change the columns within the truncation distance
+        int kept_begin = std::max(0, -shift_x), kept_end = std::min(size_x, size_x - shift_x);
+        int edge_columns = shift_x != 0 ? std::abs(shift_x) + _max_cells : 0;
+
+        // Only the rows within the truncation distance of a changed row can change, as ascending ranges [begin, end)
+        _row_ranges.clear();
+        auto addChangedRow = [&](int y)
+        {
+            int begin = std::max(y - _max_cells, 0), end = std::min(y + _max_cells + 1, size_y);
+            if (!_row_ranges.empty() && begin <= _row_ranges.back().second)
+                _row_ranges.back().second = end;
+            else
+                _row_ranges.emplace_back(begin, end);
+        };
+
+        if (shift_y > 0) // Rows that left the map affect the rows at that edge
+            addChangedRow(0);
+
+        // First pass over the rows that changed
+        for (int y = 0; y < size_y; y++)
+        {
+            const unsigned char *row = map + y * size_x;
+            bool changed = rebuild || (y >= entered_begin && y < entered_end) ||
+                           std::memcmp(row + kept_begin, &_cache[y * size_x + kept_begin], kept_end - kept_begin) != 0;
+            if (!changed && shift_x == 0)
+                continue;
+
+            std::memcpy(&_cache[y * size_x], row, size_x);
+            _num_rows++;
+
+            if (changed)
+            {
+                updateRow(row, y, 0, size_x);
+                addChangedRow(y);
+            }
+            else // Only the cells near the cells that entered or left
+            {
+                updateRow(row, y, 0, std::min(edge_columns, size_x));
+                updateRow(row, y, std::max(size_x - edge_columns, edge_columns), size_x);
+            }
+        }
+
+        if (shift_y < 0)
+            addChangedRow(size_y - 1);
+
+        // Second pass over the columns that changed
+        for (int x = 0; x < size_x; x++)
+        {
+            if (!_column_changed[x])
+                continue;
+
+            if (x < edge_columns || x >= size_x - edge_columns)
+            {
+                updateColumn(x, 0, size_y); // Changed in all rows
+            }
+            else
+            {
+                for (auto &range : _row_ranges)
+                    updateColumn(x, range.first, range.second);
+            }
+            _num_columns++;
+        }
+    }
+
+    void DistanceField::shift(int shift_x, int shift_y)
+    {
+        // Cell (x, y) of the new map was cell (x + shift_x, y + shift_y) of the previous map
+        auto shiftGrid = [&](auto &grid, auto &buffer, auto entered_value)
+        {
+            buffer.resize(grid.size());
+
+            int first_x = std::max(0, -shift_x), last_x = std::min(_size_x, _size_x - shift_x); // [first, last) in the new map
+            int first_y = std::max(0, -shift_y), last_y = std::min(_size_y, _size_y - shift_y);
+            for (int y = 0; y < _size_y; y++)
+            {
+                auto row = buffer.begin() + y * _size_x;
+                if (y < first_y || y >= last_y)
+                {
+                    std::fill(row, row + _size_x, entered_value);
+                    continue;
+                }
+
+                auto source = grid.begin() + (y + shift_y) * _size_x + shift_x;
+                std::fill(row, row + first_x, entered_value);
+                std::copy(source + first_x, source + last_x, row + first_x);
+                std::fill(row + last_x, row + _size_x, entered_value);
+            }
+            grid.swap(buffer);
+        };
+
+        shiftGrid(_cache, _shifted_cache, (unsigned char)0);
+
+        // Cells that entered never compare equal, such that their columns are always updated
+        shiftGrid(_row_distance, _shifted_values, std::numeric_limits<float>::quiet_NaN());
+        shiftGrid(_distance, _shifted_values, (float)_max_distance);
+    }
+
+    void DistanceField::updateRow(const unsigned char *row, int y, int begin, int end)
+    {
+        // Squared distances are capped at the truncation distance (this also keeps the parabola intersections finite)
+        float *row_distance = &_row_distance[y * _size_x];
+
+        int last = -1;
+        for (int x = std::max(begin - _max_cells, 0); x < end; x++) // Closest occupied cell on the left
+        {
+            if (row[x] != _free_value)
+                last = x;
+
+            if (x < begin)
+                continue;
+
+            float distance = (last < 0 || x - last > _max_cells) ? _unreachable : (float)(x - last) * (x - last);
+            if (distance != row_distance[x])
+                _column_changed[x] = 1;
+            row_distance[x] = distance;
+        }
+
+        last = -1;
+        for (int x = std::min(end + _max_cells, _size_x) - 1; x >= begin; x--) // Or on the right
+        {
+            if (row[x] != _free_value)
+                last = x;
+
+            if (x >= end || last < 0 || last - x > _max_cells)
+                continue;
+
+            float distance = (float)(last - x) * (last - x);
+            if (distance < row_distance[x])
+            {
+                _column_changed[x] = 1;
+                row_distance[x] = distance;
+            }
+        }
+    }
+
+    void DistanceField::updateColumn(int x, int begin, int end)
+    {
+        // Rows within the truncation distance of [begin, end) contribute
+        int first = std::max(begin - _max_cells, 0), last = std::min(end + _max_cells, _size_y);
+        int n = last - first;
+        for (int i = 0; i < n; i++)
+            _column[i] = _row_distance[(first + i) * _size_x + x];
+
+        // Lower envelope of the parabolas (i - q)^2 + f(q)
+        auto intersection = [&](int q, int p)
+        {
+            return (float)(((_column[q] + (double)q * q) - (_column[p] + (double)p * p)) / (2. * q - 2. * p));
+        };
+
+        int k = 0;
+        _parabola[0] = 0;
+        _boundary[0] = -std::numeric_limits<float>::infinity();
+        _boundary[1] = std::numeric_limits<float>::infinity();
+        for (int q = 1; q < n; q++)
+        {
+            float s = intersection(q, _parabola[k]);
+            while (k > 0 && s <= _boundary[k])
+            {
+                k--;
+                s = intersection(q, _parabola[k]);
+            }
+
+            k++;
+            _parabola[k] = q;
+            _boundary[k] = s;
+            _boundary[k + 1] = std::numeric_limits<float>::infinity();
+        }
+
+        k = 0;
+        for (int i = begin - first; i < end - first; i++)
+        {
+            while (_boundary[k + 1] < i)
+                k++;
+
+            int p = _parabola[k];
+            float squared_distance = (float)(i - p) * (i - p) + _column[p];
+            _distance[(first + i) * _size_x + x] = squared_distance >= _unreachable ? (float)_max_distance
+                                                                                    : std::sqrt(squared_distance) * _resolution;
+        }
+    }
+
+    float DistanceField::cellDistance(int x, int y) const
+    {
+        x = std::min(std::max(x, 0), _size_x - 1);
+        y = std::min(std::max(y, 0), _size_y - 1);
+        return _distance[y * _size_x + x];
+    }
+
+    double DistanceField::getDistance(const Eigen::Vector2d &pos) const
+    {
+        Eigen::Vector2d gradient;
+        return getDistance(pos, gradient);
+    }
+
+    double DistanceField::getDistance(const Eigen::Vector2d &pos, Eigen::Vector2d &gradient) const
+    {
+        gradient.setZero();
+        if (_distance.empty())
+            return std::numeric_limits<double>::infinity();
+
+        // Bilinear interpolation between the four surrounding cell centers
+        double u = (pos(0) - _origin_x) / _resolution - 0.5;
+        double v = (pos(1) - _origin_y) / _resolution - 0.5;
+        int x = (int)std::floor(u), y = (int)std::floor(v);
+        double tx = std::min(std::max(u - x, 0.), 1.), ty = std::min(std::max(v - y, 0.), 1.);
+
+        double d00 = cellDistance(x, y), d10 = cellDistance(x + 1, y);
+        double d01 = cellDistance(x, y + 1), d11 = cellDistance(x + 1, y + 1);
+        if (std::isinf(d00) || std::isinf(d10) || std::isinf(d01) || std::isinf(d11))
+            return std::numeric_limits<double>::infinity();
+
+        gradient(0) = ((1. - ty) * (d10 - d00) + ty * (d11 - d01)) / _resolution;
+        gradient(1) = ((1. - tx) * (d01 - d00) + tx * (d11 - d10)) / _resolution;
+
+        return (1. - tx) * (1. - ty) * d00 + tx * (1. - ty) * d10 + (1. - tx) * ty * d01 + tx * ty * d11;
+    }
+} // namespace MPCPlanner
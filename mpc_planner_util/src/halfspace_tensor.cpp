@@ -0,0 +1,126 @@
+#include <mpc_planner_util/halfspace_tensor.h>
+
+#include <ros_tools/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HALFSPACE_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+
+namespace MPCPlanner
+{
+    HalfspaceTensor::HalfspaceTensor(int n_discs, int N, int n_constraints)
+    {
+        resize(n_discs, N, n_constraints);
+    }
+
+    void HalfspaceTensor::resize(int n_discs, int N, int n_constraints)
+    {
+        ROSTOOLS_ASSERT(n_discs >= 0 && N >= 0 && n_constraints >= 0, "Halfspace tensor dimensions should be positive");
+
+        constexpr int width = ALIGNMENT / sizeof(double);
+
+        _n_discs = n_discs;
+        _N = N;
+        _n_constraints = n_constraints;
+        _stride = std::max((n_constraints + width - 1) / width * width, width);
+
+        size_t bytes = (size_t)_n_discs * _N * 3 * _stride * sizeof(double); // A multiple of the alignment
+        if (bytes == 0)
+        {
+            _data.reset();
+            return;
+        }
+
+        double *data = static_cast<double *>(std::aligned_alloc(ALIGNMENT, bytes));
+        if (data == nullptr)
+            throw std::bad_alloc();
+
+        std::memset(data, 0, bytes);
+        _data.reset(data);
+    }
+
+    void computeObstacleHalfspacesScalar(const double *obstacle_x, const double *obstacle_y, const double *offset,
+                                         int num_obstacles, const Eigen::Vector2d &pos,
+                                         double *a1, double *a2, double *b)
+    {
+        for (int i = 0; i < num_obstacles; i++)
+        {
+            double diff_x = obstacle_x[i] - pos(0);
+            double diff_y = obstacle_y[i] - pos(1);
+            double inv_dist = 1. / std::sqrt(diff_x * diff_x + diff_y * diff_y);
+
+            a1[i] = diff_x * inv_dist;
+            a2[i] = diff_y * inv_dist;
+            b[i] = a1[i] * obstacle_x[i] + a2[i] * obstacle_y[i] - offset[i];
+        }
+    }
+
+#ifdef HALFSPACE_KERNEL_AVX2
+    namespace
+    {
+        __attribute__((target("avx2,fma"))) void computeObstacleHalfspacesAVX2(
+            const double *obstacle_x, const double *obstacle_y, const double *offset,
+            int num_obstacles, const Eigen::Vector2d &pos,
+            double *a1, double *a2, double *b)
+        {
+            const __m256d pos_x = _mm256_set1_pd(pos(0));
+            const __m256d pos_y = _mm256_set1_pd(pos(1));
+            const __m256d one = _mm256_set1_pd(1.);
+
+            int i = 0;
+            for (; i + 4 <= num_obstacles; i += 4) // Four obstacles at a time
+            {
+                __m256d obs_x = _mm256_loadu_pd(obstacle_x + i);
+                __m256d obs_y = _mm256_loadu_pd(obstacle_y + i);
+
+                __m256d diff_x = _mm256_sub_pd(obs_x, pos_x);
+                __m256d diff_y = _mm256_sub_pd(obs_y, pos_y);
+                __m256d dist_sq = _mm256_fmadd_pd(diff_x, diff_x, _mm256_mul_pd(diff_y, diff_y));
+                __m256d inv_dist = _mm256_div_pd(one, _mm256_sqrt_pd(dist_sq));
+
+                __m256d normal_x = _mm256_mul_pd(diff_x, inv_dist);
+                __m256d normal_y = _mm256_mul_pd(diff_y, inv_dist);
+                __m256d offset_b = _mm256_fmadd_pd(normal_x, obs_x, _mm256_mul_pd(normal_y, obs_y));
+
+                _mm256_storeu_pd(a1 + i, normal_x);
+                _mm256_storeu_pd(a2 + i, normal_y);
+                _mm256_storeu_pd(b + i, _mm256_sub_pd(offset_b, _mm256_loadu_pd(offset + i)));
+            }
+
+            // Remaining obstacles
+            computeObstacleHalfspacesScalar(obstacle_x + i, obstacle_y + i, offset + i, num_obstacles - i, pos,
+                                            a1 + i, a2 + i, b + i);
+        }
+    }
+#endif
+
+    bool halfspaceKernelUsesAVX2()
+    {
+#ifdef HALFSPACE_KERNEL_AVX2
+        static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    void computeObstacleHalfspaces(const double *obstacle_x, const double *obstacle_y, const double *offset,
+                                   int num_obstacles, const Eigen::Vector2d &pos,
+                                   double *a1, double *a2, double *b)
+    {
+#ifdef HALFSPACE_KERNEL_AVX2
+        if (halfspaceKernelUsesAVX2())
+        {
+            computeObstacleHalfspacesAVX2(obstacle_x, obstacle_y, offset, num_obstacles, pos, a1, a2, b);
+            return;
+        }
+#endif
+        computeObstacleHalfspacesScalar(obstacle_x, obstacle_y, offset, num_obstacles, pos, a1, a2, b);
+    }
+} // namespace MPCPlanner
@@ -0,0 +1,80 @@
+#include <mpc_planner_util/obstacle_downsampling.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MPCPlanner
+{
+    ObstacleDownsampling::ObstacleDownsampling(double tolerance, bool boundary_only, unsigned char free_value)
+        : _tolerance(tolerance), _boundary_only(boundary_only), _free_value(free_value)
+    {
+    }
+
+    void ObstacleDownsampling::apply(const std::vector<Eigen::Vector2d> &occupied, const unsigned char *map, int size_x, int size_y,
+                                     double origin_x, double origin_y, double resolution)
+    {
+        _offset = 0.;
+
+        double voxel_size = std::sqrt(2.) * _tolerance;
+        bool voxel_filter = voxel_size > resolution; // Otherwise voxels would not merge cells
+
+        _passed = &occupied;
+        if (!_boundary_only && !voxel_filter) // Nothing to downsample
+            return;
+        _passed = nullptr;
+
+        const std::vector<Eigen::Vector2d> *points = &occupied;
+        if (_boundary_only)
+        {
+            _boundary.clear();
+            double inv_resolution = 1. / resolution;
+            for (auto &point : occupied)
+            {
+                if (isBoundary(point, map, size_x, size_y, origin_x, origin_y, inv_resolution))
+                    _boundary.push_back(point);
+            }
+
+            points = &_boundary;
+            _offset = resolution;
+        }
+
+        if (!voxel_filter)
+        {
+            _points.swap(_boundary);
+            return;
+        }
+
+        _offset = std::max(_offset, _tolerance);
+
+        // One point per occupied voxel, voxels are indexed from the map origin
+        _voxels.clear();
+        for (auto &point : *points)
+        {
+            std::uint64_t voxel_x = (std::uint64_t)std::max(std::floor((point(0) - origin_x) / voxel_size), 0.);
+            std::uint64_t voxel_y = (std::uint64_t)std::max(std::floor((point(1) - origin_y) / voxel_size), 0.);
+            _voxels.push_back((voxel_x << 32) | voxel_y);
+        }
+        std::sort(_voxels.begin(), _voxels.end());
+        _voxels.erase(std::unique(_voxels.begin(), _voxels.end()), _voxels.end());
+
+        _points.clear();
+        for (auto &voxel : _voxels)
+        {
+            _points.emplace_back(origin_x + ((voxel >> 32) + 0.5) * voxel_size,
+                                 origin_y + ((voxel & 0xFFFFFFFF) + 0.5) * voxel_size);
+        }
+    }
+
+    bool ObstacleDownsampling::isBoundary(const Eigen::Vector2d &point, const unsigned char *map, int size_x, int size_y,
+                                          double origin_x, double origin_y, double inv_resolution) const
+    {
+        int x = (int)((point(0) - origin_x) * inv_resolution); // Cell centers are inside the map
+        int y = (int)((point(1) - origin_y) * inv_resolution);
+        if (x <= 0 || y <= 0 || x >= size_x - 1 || y >= size_y - 1) // Unknown beyond the map
+            return true;
+
+        const unsigned char *cell = map + y * size_x + x;
+        return cell[-1] == _free_value || cell[1] == _free_value ||
+               cell[-size_x] == _free_value || cell[size_x] == _free_value;
+    }
+} // namespace MPCPlanner
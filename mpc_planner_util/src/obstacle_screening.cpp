@@ -0,0 +1,106 @@
+#include <mpc_planner_util/obstacle_screening.h>
+
+#include <mpc_planner_util/parameters.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace MPCPlanner
+{
+    ObstacleScreening::ObstacleScreening(int num_slots, const YAML::Node &model_map)
+        : _num_slots(num_slots)
+    {
+        _enable = CONFIG["obstacle_screening"]["enable"].as<bool>();
+        _margin = CONFIG["obstacle_screening"]["margin"].as<double>();
+
+        // Without a velocity bound, every obstacle can be reached
+        _max_velocity = std::numeric_limits<double>::infinity();
+        if (model_map["v"])
+            _max_velocity = std::max(std::abs(model_map["v"][2].as<double>()), std::abs(model_map["v"][3].as<double>()));
+
+        if (_enable && std::isinf(_max_velocity))
+            LOG_WARN("Obstacle screening is enabled, but the model has no velocity \"v\" (no obstacles are screened)");
+    }
+
+    void ObstacleScreening::update(const std::vector<Eigen::Vector2d> &ego_positions, const std::vector<DynamicObstacle> &obstacles,
+                                   const std::vector<Disc> &robot_area, double robot_radius, double dt, double chi)
+    {
+        _N = ego_positions.size();
+        _slots.assign(_N * _num_slots, -1);
+        _num_active = 0;
+        _num_screened = 0;
+
+        // The discs may be ahead of or behind the robot position
+        double max_offset = 0.;
+        for (auto &disc : robot_area)
+            max_offset = std::max(max_offset, std::abs(disc.offset));
+
+        // Uncertain obstacles are inflated by (at least) three standard deviations
+        double uncertainty_scale = std::max(3., std::sqrt(std::max(chi, 0.)));
+
+        int num_obstacles = obstacles.size();
+        for (int k = 1; k < _N; k++)
+        {
+            int *slots = &_slots[k * _num_slots];
+
+            if (!_enable)
+            {
+                for (int i = 0; i < std::min(num_obstacles, _num_slots); i++)
+                    slots[i] = i;
+
+                _num_active += std::min(num_obstacles, _num_slots);
+                continue;
+            }
+
+            double reach = _max_velocity * k * dt + robot_radius + max_offset + _margin;
+
+            _ranked.clear();
+            for (int i = 0; i < num_obstacles; i++)
+            {
+                const auto &obstacle = obstacles[i];
+                const auto &prediction = obstacle.prediction.modes[0][k - 1]; // Predictions start at k = 1
+
+                double radius = obstacle.radius;
+                if (obstacle.prediction.type == PredictionType::GAUSSIAN)
+                    radius += uncertainty_scale * prediction.major_radius;
+
+                if ((prediction.position - ego_positions[0]).norm() - radius > reach)
+                    continue; // Out of reach at this stage
+
+                _ranked.emplace_back((prediction.position - ego_positions[k]).norm() - radius, i);
+            }
+
+            if ((int)_ranked.size() > _num_slots) // Keep the obstacles closest to the warm start
+            {
+                std::nth_element(_ranked.begin(), _ranked.begin() + _num_slots, _ranked.end());
+                _ranked.resize(_num_slots);
+            }
+
+            if (num_obstacles <= _num_slots) // Every obstacle has its own slot
+            {
+                for (auto &ranked : _ranked)
+                    slots[ranked.second] = ranked.second;
+            }
+            else
+            {
+                std::sort(_ranked.begin(), _ranked.end(), [](const std::pair<double, int> &a, const std::pair<double, int> &b)
+                          { return a.second < b.second; });
+
+                for (size_t slot = 0; slot < _ranked.size(); slot++)
+                    slots[slot] = _ranked[slot].second;
+            }
+
+            _num_active += _ranked.size();
+            _num_screened += std::min(num_obstacles, _num_slots) - (int)_ranked.size();
+        }
+    }
+
+    int ObstacleScreening::getObstacle(int k, int slot) const
+    {
+        if (k <= 0 || k >= _N || slot >= _num_slots)
+            return -1;
+
+        return _slots[k * _num_slots + slot];
+    }
+} // namespace MPCPlanner
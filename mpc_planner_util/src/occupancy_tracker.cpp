@@ -0,0 +1,235 @@
+#include <mpc_planner_util/occupancy_tracker.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace MPCPlanner
+{
+    OccupancyTracker::OccupancyTracker(unsigned char free_value)
+        : _free_value(free_value)
+    {
+    }
+
+    void OccupancyTracker::reset()
+    {
+        _cache.clear();
+        _slot.clear();
+        _points.clear();
+        _point_cell.clear();
+        _added.clear();
+        _row_begin.clear();
+        _row_end.clear();
+        _size_x = 0;
+        _size_y = 0;
+    }
+
+    void OccupancyTracker::setRegion(const std::vector<int> &row_begin, const std::vector<int> &row_end)
+    {
+        _region_begin = row_begin;
+        _region_end = row_end;
+        _use_region = true;
+    }
+
+    void OccupancyTracker::clearRegion()
+    {
+        _use_region = false;
+    }
+
+    void OccupancyTracker::update(const unsigned char *map, int size_x, int size_y,
+                                  double origin_x, double origin_y, double resolution)
+    {
+        _num_changed = 0;
+        _rebuilt = false;
+        _added.clear();
+
+        // A rolling window moves by whole cells
+        double cells_x = _resolution > 0. ? (origin_x - _origin_x) / resolution : 0.;
+        double cells_y = _resolution > 0. ? (origin_y - _origin_y) / resolution : 0.;
+        int shift_x = std::lround(cells_x), shift_y = std::lround(cells_y);
+
+        if (size_x != _size_x || size_y != _size_y || resolution != _resolution || _cache.empty() ||
+            std::abs(cells_x - shift_x) > 1e-3 || std::abs(cells_y - shift_y) > 1e-3 ||
+            std::abs(shift_x) >= size_x || std::abs(shift_y) >= size_y)
+        {
+            clearCache(size_x, size_y, resolution); // Everything is compared against a free map
+            _rebuilt = true;
+        }
+        else if (shift_x != 0 || shift_y != 0)
+        {
+            shift(shift_x, shift_y);
+        }
+
+        _origin_x = origin_x;
+        _origin_y = origin_y;
+        _center_x = origin_x + 0.5 * resolution; // As costmap_2d::Costmap2D::mapToWorld
+        _center_y = origin_y + 0.5 * resolution;
+
+        bool use_region = _use_region && (int)_region_begin.size() == size_y && (int)_region_end.size() == size_y;
+        for (int y = 0; y < size_y; y++)
+        {
+            int begin = use_region ? std::max(_region_begin[y], 0) : 0;
+            int end = use_region ? std::min(_region_end[y], size_x) : size_x;
+            if (end <= begin)
+                begin = end = 0;
+
+            // Cells that left the region
+            clearCells(y, _row_begin[y], std::min(_row_end[y], begin));
+            clearCells(y, std::max(_row_begin[y], end), _row_end[y]);
+
+            updateCells(map + y * size_x, y, begin, end);
+
+            _row_begin[y] = begin;
+            _row_end[y] = end;
+        }
+    }
+
+    void OccupancyTracker::updateCells(const unsigned char *row, int y, int begin, int end)
+    {
+        if (end <= begin)
+            return;
+
+        unsigned char *cached_row = &_cache[y * _size_x];
+        if (std::memcmp(row + begin, cached_row + begin, end - begin) == 0)
+            return;
+
+        int x = begin;
+        while (x < end)
+        {
+            // Skip eight equal cells at a time
+            if (x + 8 <= end)
+            {
+                std::uint64_t cells, cached_cells;
+                std::memcpy(&cells, row + x, 8);
+                std::memcpy(&cached_cells, cached_row + x, 8);
+                if (cells == cached_cells)
+                {
+                    x += 8;
+                    continue;
+                }
+            }
+
+            int block_end = std::min(x + 8, end);
+            for (; x < block_end; x++)
+            {
+                if (row[x] == cached_row[x])
+                    continue;
+
+                bool occupied = row[x] != _free_value;
+                bool was_occupied = cached_row[x] != _free_value;
+                if (occupied && !was_occupied)
+                    addPoint(x, y);
+                else if (!occupied && was_occupied)
+                    removePoint(y * _size_x + x);
+
+                cached_row[x] = row[x];
+                _num_changed++;
+            }
+        }
+    }
+
+    void OccupancyTracker::clearCells(int y, int begin, int end)
+    {
+        unsigned char *cached_row = &_cache[y * _size_x];
+        for (int x = begin; x < end; x++)
+        {
+            if (cached_row[x] == _free_value)
+                continue;
+
+            removePoint(y * _size_x + x);
+            cached_row[x] = _free_value;
+            _num_changed++;
+        }
+    }
+
+    void OccupancyTracker::clearCache(int size_x, int size_y, double resolution)
+    {
+        _size_x = size_x;
+        _size_y = size_y;
+        _resolution = resolution;
+
+        int num_cells = size_x * size_y;
+        _cache.assign(num_cells, _free_value);
+        _slot.assign(num_cells, -1);
+        _row_begin.assign(size_y, 0);
+        _row_end.assign(size_y, 0);
+        _points.clear();
+        _point_cell.clear();
+    }
+
+    void OccupancyTracker::shift(int shift_x, int shift_y)
+    {
+        // Cell (x, y) of the new map was cell (x + shift_x, y + shift_y) of the previous map
+        _shifted_cache.assign(_cache.size(), _free_value);
+        _shifted_begin.assign(_size_y, 0);
+        _shifted_end.assign(_size_y, 0);
+
+        int first_x = std::max(0, -shift_x), last_x = std::min(_size_x, _size_x - shift_x); // [first, last) in the new map
+        int first_y = std::max(0, -shift_y), last_y = std::min(_size_y, _size_y - shift_y);
+        for (int y = first_y; y < last_y; y++)
+        {
+            std::memcpy(&_shifted_cache[y * _size_x + first_x],
+                        &_cache[(y + shift_y) * _size_x + first_x + shift_x],
+                        last_x - first_x);
+
+            int begin = std::max(_row_begin[y + shift_y] - shift_x, first_x);
+            int end = std::min(_row_end[y + shift_y] - shift_x, last_x);
+            if (end > begin)
+            {
+                _shifted_begin[y] = begin;
+                _shifted_end[y] = end;
+            }
+        }
+        _cache.swap(_shifted_cache);
+        _row_begin.swap(_shifted_begin);
+        _row_end.swap(_shifted_end);
+
+        // Points keep their world position, drop those that left the map
+        std::fill(_slot.begin(), _slot.end(), -1);
+
+        size_t num_kept = 0;
+        for (size_t i = 0; i < _points.size(); i++)
+        {
+            int x = _point_cell[i] % _size_x - shift_x;
+            int y = _point_cell[i] / _size_x - shift_y;
+            if (x < 0 || x >= _size_x || y < 0 || y >= _size_y)
+                continue;
+
+            int cell = y * _size_x + x;
+            _points[num_kept] = _points[i];
+            _point_cell[num_kept] = cell;
+            _slot[cell] = num_kept;
+            num_kept++;
+        }
+
+        _points.resize(num_kept);
+        _point_cell.resize(num_kept);
+    }
+
+    void OccupancyTracker::addPoint(int x, int y)
+    {
+        int cell = y * _size_x + x;
+        _slot[cell] = _points.size();
+        _points.emplace_back(_center_x + x * _resolution, _center_y + y * _resolution);
+        _point_cell.push_back(cell);
+        _added.push_back(_points.back());
+    }
+
+    void OccupancyTracker::removePoint(int cell)
+    {
+        int slot = _slot[cell];
+        if (slot < 0)
+            return;
+
+        // Move the last point into the slot
+        int last = _points.size() - 1;
+        _points[slot] = _points[last];
+        _point_cell[slot] = _point_cell[last];
+        _slot[_point_cell[slot]] = slot;
+
+        _points.pop_back();
+        _point_cell.pop_back();
+        _slot[cell] = -1;
+    }
+} // namespace MPCPlanner
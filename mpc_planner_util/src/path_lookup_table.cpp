@@ -0,0 +1,122 @@
+#include <mpc_planner_util/path_lookup_table.h>
+
+#include <ros_tools/spline.h>
+#include <ros_tools/logging.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MPCPlanner
+{
+    PathLookupTable::PathLookupTable(const RosTools::Spline2D &spline, double resolution)
+    {
+        ROSTOOLS_ASSERT(resolution > 0., "The path lookup table resolution should be positive");
+
+        _start = spline.getSegmentStart(0); // Not zero for a continued (rolling) path
+        _length = std::max(spline.parameterLength() - _start, 0.);
+
+        // Uniform samples, including both ends of the path (at least two)
+        int num_samples = std::max((int)std::ceil(_length / resolution), 1) + 1;
+        _resolution = _length / (double)(num_samples - 1);
+        _inv_resolution = _resolution > 0. ? 1. / _resolution : 0.;
+
+        _samples.resize(num_samples);
+
+        if (_resolution <= 0.) // Empty path
+        {
+            for (auto &sample : _samples)
+            {
+                sample.point = spline.getPoint(_start);
+                sample.normal = spline.getOrthogonal(_start);
+                sample.velocity = Eigen::Vector2d(1., 0.);
+                sample.curvature = 0.;
+            }
+            return;
+        }
+
+        // Analytic derivatives of the cubic segments (the samples are in increasing s, so the segment only advances)
+        int num_segments = spline.numSegments();
+        int segment = 0;
+        Eigen::Vector4d x, y;
+        spline.getParameters(segment, x(0), x(1), x(2), x(3), y(0), y(1), y(2), y(3));
+        for (int i = 0; i < num_samples; i++)
+        {
+            double s = _start + std::min(i * _resolution, _length);
+            while (segment < num_segments - 1 && s >= spline.getSegmentStart(segment + 1))
+            {
+                segment++;
+                spline.getParameters(segment, x(0), x(1), x(2), x(3), y(0), y(1), y(2), y(3));
+            }
+            double ds = s - spline.getSegmentStart(segment);
+
+            Eigen::Vector2d velocity((3. * x(0) * ds + 2. * x(1)) * ds + x(2),
+                                     (3. * y(0) * ds + 2. * y(1)) * ds + y(2));
+            Eigen::Vector2d acceleration(6. * x(0) * ds + 2. * x(1),
+                                         6. * y(0) * ds + 2. * y(1));
+
+            _samples[i].point = Eigen::Vector2d(((x(0) * ds + x(1)) * ds + x(2)) * ds + x(3),
+                                                ((y(0) * ds + y(1)) * ds + y(2)) * ds + y(3));
+            _samples[i].velocity = velocity;
+            _samples[i].normal = spline.getOrthogonal(s);
+
+            double speed = velocity.norm();
+            _samples[i].curvature = speed > 1e-9
+                                        ? (velocity(0) * acceleration(1) - velocity(1) * acceleration(0)) / (speed * speed * speed)
+                                        : 0.;
+        }
+    }
+
+    void PathLookupTable::locate(double s, int &index, double &t) const
+    {
+        double position = std::min(std::max(s - _start, 0.), _length) * _inv_resolution;
+
+        index = std::min((int)position, (int)_samples.size() - 2);
+        index = std::max(index, 0);
+        t = std::min(std::max(position - index, 0.), 1.);
+    }
+
+    Eigen::Vector2d PathLookupTable::getPoint(double s) const
+    {
+        int i;
+        double t;
+        locate(s, i, t);
+
+        // Cubic Hermite interpolation between the samples
+        const Sample &p0 = _samples[i], &p1 = _samples[i + 1];
+        double t2 = t * t, t3 = t2 * t;
+        return (2. * t3 - 3. * t2 + 1.) * p0.point +
+               (t3 - 2. * t2 + t) * _resolution * p0.velocity +
+               (-2. * t3 + 3. * t2) * p1.point +
+               (t3 - t2) * _resolution * p1.velocity;
+    }
+
+    Eigen::Vector2d PathLookupTable::getTangent(double s) const
+    {
+        int i;
+        double t;
+        locate(s, i, t);
+        return ((1. - t) * _samples[i].velocity + t * _samples[i + 1].velocity).normalized();
+    }
+
+    Eigen::Vector2d PathLookupTable::getOrthogonal(double s) const
+    {
+        int i;
+        double t;
+        locate(s, i, t);
+        return ((1. - t) * _samples[i].normal + t * _samples[i + 1].normal).normalized();
+    }
+
+    double PathLookupTable::getPathAngle(double s) const
+    {
+        Eigen::Vector2d tangent = getTangent(s);
+        return std::atan2(tangent(1), tangent(0));
+    }
+
+    double PathLookupTable::getCurvature(double s) const
+    {
+        int i;
+        double t;
+        locate(s, i, t);
+        return (1. - t) * _samples[i].curvature + t * _samples[i + 1].curvature;
+    }
+} // namespace MPCPlanner
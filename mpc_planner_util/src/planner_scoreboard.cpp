@@ -0,0 +1,23 @@
+#include <mpc_planner_util/planner_scoreboard.h>
+
+namespace MPCPlanner
+{
+    PlannerScoreboard::PlannerScoreboard(double time_share)
+        : _time_share(time_share)
+    {
+    }
+
+    void PlannerScoreboard::reset()
+    {
+        _has_solution = false;
+        _num_cancelled = 0;
+    }
+
+    bool PlannerScoreboard::shouldCancel(double elapsed_time) const
+    {
+        if (!_has_solution.load()) // Nothing to fall back on
+            return false;
+
+        return elapsed_time > _time_share;
+    }
+} // namespace MPCPlanner
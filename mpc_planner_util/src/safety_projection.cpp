@@ -0,0 +1,123 @@
+#include <mpc_planner_util/safety_projection.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MPCPlanner
+{
+    SafetyProjection::SafetyProjection(int max_iterations)
+        : _max_iterations(max_iterations)
+    {
+    }
+
+    void SafetyProjection::setObstacles(const double *obstacle_x, const double *obstacle_y, const double *radius, int num_obstacles)
+    {
+        _obstacles.resize(num_obstacles);
+        _radius.resize(num_obstacles);
+        _cells.resize(num_obstacles);
+        _num_steps = 0;
+
+        _max_radius = 0.;
+        for (int i = 0; i < num_obstacles; i++)
+        {
+            _obstacles[i] = Eigen::Vector2d(obstacle_x[i], obstacle_y[i]);
+            _radius[i] = radius[i];
+            _max_radius = std::max(_max_radius, radius[i]);
+        }
+
+        // A position inside an obstacle is at most one cell away from the cell of the obstacle
+        _inv_cell_size = 1. / std::max(_max_radius, 1e-3);
+
+        for (int i = 0; i < num_obstacles; i++)
+            _cells[i] = {cellIndex(obstacle_x[i]), cellIndex(obstacle_y[i]), i};
+
+        std::sort(_cells.begin(), _cells.end());
+    }
+
+    int SafetyProjection::cellIndex(double coordinate) const
+    {
+        return (int)std::floor(coordinate * _inv_cell_size);
+    }
+
+    void SafetyProjection::findCandidates(const Eigen::Vector2d &pos)
+    {
+        _candidates.clear();
+
+        // Close to the anchor, the step for an obstacle with a larger radius moves the position wherever that obstacle is
+        if ((pos - _obstacles[0]).norm() < _max_radius)
+        {
+            double anchor_distance = (pos - _obstacles[0]).norm();
+            for (size_t i = 0; i < _obstacles.size(); i++)
+            {
+                if (_radius[i] > anchor_distance || (pos - _obstacles[i]).norm() < _radius[i])
+                    _candidates.push_back(i);
+            }
+            return;
+        }
+
+        int cell_x = cellIndex(pos(0)), cell_y = cellIndex(pos(1));
+        for (int x = cell_x - 1; x <= cell_x + 1; x++)
+        {
+            auto it = std::lower_bound(_cells.begin(), _cells.end(), Cell{x, cell_y - 1, 0});
+            for (; it != _cells.end() && it->x == x && it->y <= cell_y + 1; ++it)
+            {
+                if ((pos - _obstacles[it->obstacle]).norm() < _radius[it->obstacle])
+                    _candidates.push_back(it->obstacle);
+            }
+        }
+
+        std::sort(_candidates.begin(), _candidates.end()); // Project in the same order as without culling
+    }
+
+    bool SafetyProjection::project(Eigen::Vector2d &pos)
+    {
+        if (_obstacles.empty()) // There is no anchor
+            return true;
+
+        for (int iterate = 0; iterate < _max_iterations; iterate++)
+        {
+            findCandidates(pos);
+            if (_candidates.empty()) // Collision-free
+                return true;
+
+            // Step through the obstacles in order, a step may move the position into a later (overlapping) obstacle
+            int last = -1;
+            while (true)
+            {
+                auto next = std::upper_bound(_candidates.begin(), _candidates.end(), last);
+                if (next == _candidates.end())
+                    break;
+
+                last = *next;
+                Eigen::Vector2d previous = pos;
+                _dr_projection.douglasRachfordProjection(pos, _obstacles[last], _obstacles[0], _radius[last], pos);
+                _num_steps++;
+
+                if (pos != previous)
+                    findCandidates(pos);
+            }
+        }
+
+        findCandidates(pos);
+        return _candidates.empty();
+    }
+
+    bool SafetyProjection::project(Eigen::Vector2d &pos, double radius, const ClosestObstacleQuery &query)
+    {
+        Eigen::Vector2d anchor, closest;
+        if (!query(pos, radius, anchor)) // Collision-free
+            return true;
+
+        closest = anchor;
+        for (int iterate = 0; iterate < _max_iterations; iterate++)
+        {
+            _dr_projection.douglasRachfordProjection(pos, closest, anchor, radius, pos);
+            _num_steps++;
+
+            if (!query(pos, radius, closest))
+                return true;
+        }
+
+        return false;
+    }
+} // namespace MPCPlanner
@@ -0,0 +1,116 @@
+#include <mpc_planner_util/thread_pool.h>
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace MPCPlanner
+{
+    ThreadPool::ThreadPool(int num_threads, bool pin_threads, std::function<void(int)> initialize)
+    {
+        if (num_threads <= 0)
+            num_threads = numAvailableCores();
+
+        for (int i = 0; i < num_threads; i++)
+            _workers.emplace_back(&ThreadPool::run, this, i, pin_threads, initialize);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _work_available.notify_all();
+
+        for (auto &worker : _workers)
+            worker.join();
+    }
+
+    int ThreadPool::numAvailableCores()
+    {
+#ifdef __linux__
+        cpu_set_t cpus;
+        if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0)
+            return std::max(CPU_COUNT(&cpus), 1);
+#endif
+        return std::max((int)std::thread::hardware_concurrency(), 1);
+    }
+
+    void ThreadPool::parallelFor(int n, const std::function<void(int)> &task)
+    {
+        if (n <= 0)
+            return;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _task = &task;
+        _num_tasks = n;
+        _next_task = 0;
+        _num_finished_workers = 0;
+        _generation++;
+        _work_available.notify_all();
+
+        _work_done.wait(lock, [&]()
+                        { return _num_finished_workers == (int)_workers.size(); });
+        _task = nullptr;
+    }
+
+    void ThreadPool::run(int worker, bool pin, std::function<void(int)> initialize)
+    {
+#ifdef __linux__
+        cpu_set_t available;
+        if (pin && sched_getaffinity(0, sizeof(available), &available) == 0) // Inherited from the creating thread
+        {
+            // Pin to the i-th available core
+            int index = worker % std::max(CPU_COUNT(&available), 1);
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            {
+                if (!CPU_ISSET(cpu, &available) || index-- > 0)
+                    continue;
+
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(cpu, &cpus);
+                pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+                break;
+            }
+        }
+#else
+        (void)pin;
+#endif
+
+        if (initialize)
+            initialize(worker);
+
+        unsigned int generation = 0;
+        while (true)
+        {
+            const std::function<void(int)> *task;
+            int num_tasks;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _work_available.wait(lock, [&]()
+                                     { return _stop || _generation != generation; });
+                if (_stop)
+                    return;
+
+                generation = _generation;
+                task = _task;
+                num_tasks = _num_tasks;
+            }
+
+            // Take tasks until none are left
+            for (int i = _next_task++; i < num_tasks; i = _next_task++)
+                (*task)(i);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _num_finished_workers++;
+            }
+            _work_done.notify_one();
+        }
+    }
+} // namespace MPCPlanner
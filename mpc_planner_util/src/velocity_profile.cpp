@@ -0,0 +1,97 @@
+#include <mpc_planner_util/velocity_profile.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MPCPlanner
+{
+    VelocityProfile::VelocityProfile(double max_velocity, double max_lateral_acceleration, double max_acceleration,
+                                     double max_deceleration, bool stop_at_end)
+        : _max_velocity(max_velocity), _max_lateral_acceleration(max_lateral_acceleration),
+          _max_acceleration(max_acceleration), _max_deceleration(max_deceleration), _stop_at_end(stop_at_end)
+    {
+    }
+
+    void VelocityProfile::compute(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &s,
+                                  bool continuation)
+    {
+        int n = s.size();
+
+        // Curvature limits: keep those of points whose neighbours did not change
+        int offset = 0;
+        int overlap = continuation ? findOverlap(x, y, s, offset) : 0;
+
+        std::vector<double> limit(n);
+        _num_reused = 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (i > 0 && i < overlap - 1) // The first and last point of the overlap have new neighbours
+            {
+                limit[i] = _limit[offset + i];
+                _num_reused++;
+            }
+            else
+            {
+                limit[i] = curvatureLimit(x, y, i);
+            }
+        }
+        _limit.swap(limit);
+        _x = x;
+        _y = y;
+        _s = s;
+
+        _v = _limit;
+        if (n == 0)
+            return;
+
+        // Forward pass: accelerate from the start of the path
+        for (int i = 1; i < n; i++)
+            _v[i] = std::min(_v[i], std::sqrt(_v[i - 1] * _v[i - 1] + 2. * _max_acceleration * (_s[i] - _s[i - 1])));
+
+        // Backward pass: decelerate towards the end of the path (a stop, or the last bend if the route continues)
+        if (_stop_at_end)
+            _v[n - 1] = 0.;
+        else if (n > 1)
+            _v[n - 1] = std::min(_v[n - 1], _limit[n - 2]);
+        for (int i = n - 2; i >= 0; i--)
+            _v[i] = std::min(_v[i], std::sqrt(_v[i + 1] * _v[i + 1] + 2. * _max_deceleration * (_s[i + 1] - _s[i])));
+    }
+
+    int VelocityProfile::findOverlap(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &s,
+                                     int &offset) const
+    {
+        if (s.empty() || _s.empty())
+            return 0;
+
+        auto it = std::lower_bound(_s.begin(), _s.end(), s[0]);
+        if (it == _s.end() || *it != s[0])
+            return 0;
+
+        offset = it - _s.begin();
+        int overlap = 0;
+        while (overlap < (int)s.size() && offset + overlap < (int)_s.size() && _s[offset + overlap] == s[overlap] &&
+               _x[offset + overlap] == x[overlap] && _y[offset + overlap] == y[overlap])
+            overlap++;
+
+        return overlap;
+    }
+
+    double VelocityProfile::curvatureLimit(const std::vector<double> &x, const std::vector<double> &y, int i) const
+    {
+        if (i == 0 || i == (int)x.size() - 1) // No curvature at the ends
+            return _max_velocity;
+
+        // Curvature of the circle through the point and its neighbours: 4 * area / (product of the sides)
+        double ax = x[i] - x[i - 1], ay = y[i] - y[i - 1];
+        double bx = x[i + 1] - x[i], by = y[i + 1] - y[i];
+        double sides = std::hypot(ax, ay) * std::hypot(bx, by) * std::hypot(x[i + 1] - x[i - 1], y[i + 1] - y[i - 1]);
+        if (sides < 1e-12)
+            return _max_velocity;
+
+        double curvature = 2. * std::abs(ax * by - ay * bx) / sides;
+        if (curvature < 1e-9)
+            return _max_velocity;
+
+        return std::min(_max_velocity, std::sqrt(_max_lateral_acceleration / curvature));
+    }
+} // namespace MPCPlanner
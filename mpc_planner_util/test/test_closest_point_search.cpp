@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/closest_point_search.h"
+
+#include <ros_tools/spline.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace MPCPlanner;
+
+// Tests of the closest point search on long reference paths
+class ClosestPointSearchTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A winding 10k point route (~10 km) with varying curvature (the heading stays within 90 degrees of the x-axis
+        // so that the route does not cross itself)
+        x.push_back(0.);
+        y.push_back(0.);
+        for (int i = 1; i < num_points; i++)
+        {
+            double angle = 1.2 * std::sin(0.05 * i) * std::cos(0.003 * i);
+            x.push_back(x.back() + std::cos(angle));
+            y.push_back(y.back() + std::sin(angle));
+        }
+
+        spline = std::make_unique<RosTools::Spline2D>(x, y);
+    }
+
+    // Dense sampling of the complete path as reference
+    double bruteForceDistance(const Eigen::Vector2d &point)
+    {
+        double best = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < spline->numSegments(); i++)
+        {
+            double start = spline->getSegmentStart(i);
+            double end = (i < spline->numSegments() - 1) ? spline->getSegmentStart(i + 1) : spline->parameterLength();
+            for (int j = 0; j <= 20; j++)
+                best = std::min(best, (spline->getPoint(start + (end - start) * j / 20.) - point).norm());
+        }
+        return best;
+    }
+
+    // Robot positions driving along the path with a lateral offset, 0.2 m per control cycle
+    std::vector<Eigen::Vector2d> drive(double offset)
+    {
+        std::vector<Eigen::Vector2d> positions;
+        for (double s = 0.; s < spline->parameterLength(); s += 0.2)
+            positions.push_back(spline->getPoint(s) + offset * spline->getOrthogonal(s));
+        return positions;
+    }
+
+    const int num_points{10000};
+    std::vector<double> x, y;
+    std::unique_ptr<RosTools::Spline2D> spline;
+};
+
+TEST_F(ClosestPointSearchTest, MatchesGlobalSearch)
+{
+    ClosestPointSearch search;
+    search.setPath(*spline);
+
+    int segment = -1;
+    double s;
+    auto positions = drive(0.3);
+    for (size_t i = 0; i < positions.size(); i += 997) // Skips ahead, exercising the global fallback
+    {
+        search.findClosestPoint(positions[i], segment, s);
+
+        double distance = (spline->getPoint(s) - positions[i]).norm();
+        EXPECT_LE(distance, bruteForceDistance(positions[i]) + 1e-3);
+    }
+}
+
+TEST_F(ClosestPointSearchTest, FollowsPathWithoutGlobalSearch)
+{
+    ClosestPointSearch windowed, global;
+    windowed.setPath(*spline);
+    global.setPath(*spline);
+
+    int segment = -1, global_segment = -1;
+    double s, global_s;
+    for (auto &position : drive(0.3))
+    {
+        windowed.findClosestPoint(position, segment, s);
+
+        global.reset(); // Forces the bounding box search
+        global.findClosestPoint(position, global_segment, global_s);
+
+        ASSERT_NEAR((spline->getPoint(s) - position).norm(), (spline->getPoint(global_s) - position).norm(), 1e-3);
+    }
+
+    EXPECT_EQ(windowed.numGlobalSearches(), 1); // Only the initial search
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/distance_field.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the distance field of DistanceFieldConstraints against the exact distances on the costmap
+class DistanceFieldTest : public ::testing::Test
+{
+protected:
+    // Warehouse-like map: walls, rows of shelves and a few small obstacles
+    void createMap(int map_size)
+    {
+        size = map_size;
+        map.assign(size * size, 0);
+
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        for (int x = 0; x < size; x++)
+        {
+            map[x] = 254;
+            map[(size - 1) * size + x] = 254;
+        }
+        for (int y = size / 10; y < size - size / 10; y += size / 5)
+        {
+            for (int dy = 0; dy < size / 20; dy++)
+            {
+                for (int x = size / 10; x < size - size / 10; x++)
+                    map[(y + dy) * size + x] = 254;
+            }
+        }
+        for (int i = 0; i < size / 5; i++)
+            map[cell(generator) * size + cell(generator)] = 254;
+    }
+
+    // Move a small obstacle (e.g., a pallet) by one cell
+    void moveObstacle(int cycle)
+    {
+        int y = size / 10 + size / 20 + 2, x = size / 4 + cycle - 1;
+        for (int dy = 0; dy < 4; dy++)
+        {
+            map[(y + dy) * size + x] = 0;
+            map[(y + dy) * size + x + 4] = 254;
+        }
+    }
+
+    double bruteForceDistance(int x, int y) const
+    {
+        double best = std::numeric_limits<double>::infinity();
+        for (int oy = 0; oy < size; oy++)
+        {
+            for (int ox = 0; ox < size; ox++)
+            {
+                if (map[oy * size + ox] != 0)
+                    best = std::min(best, std::hypot(ox - x, oy - y) * resolution);
+            }
+        }
+        return best;
+    }
+
+    std::vector<unsigned char> map;
+    int size;
+    const double resolution{0.05};
+
+    std::mt19937 generator{0};
+};
+
+TEST_F(DistanceFieldTest, MatchesBruteForce)
+{
+    createMap(60);
+
+    DistanceField field, truncated_field(0.5);
+    for (int cycle = 0; cycle < 5; cycle++)
+    {
+        if (cycle > 0)
+            moveObstacle(cycle);
+
+        field.update(map.data(), size, size, 0., 0., resolution);
+        truncated_field.update(map.data(), size, size, 0., 0., resolution);
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                double distance = bruteForceDistance(x, y);
+                ASSERT_NEAR(field.getCellDistance(x, y), distance, 1e-4) << "Cycle " << cycle << " (" << x << ", " << y << ")";
+                ASSERT_NEAR(std::min(truncated_field.getCellDistance(x, y), 0.5), std::min(distance, 0.5), 1e-4);
+            }
+        }
+    }
+}
+
+TEST_F(DistanceFieldTest, RollingWindowMatchesRebuild)
+{
+    // A window that moves over a larger map by whole cells
+    createMap(120);
+    std::vector<int> window_x = {10, 10, 13, 11, 11, 40, 39, 39};
+    std::vector<int> window_y = {20, 22, 22, 17, 17, 18, 60, 59};
+    const int window = 50;
+    std::vector<unsigned char> window_map(window * window);
+
+    DistanceField field(0.5);
+    for (size_t cycle = 0; cycle < window_x.size(); cycle++)
+    {
+        if (cycle == 4)
+            moveObstacle(1); // Also change the map inside of the window
+
+        for (int y = 0; y < window; y++)
+        {
+            for (int x = 0; x < window; x++)
+                window_map[y * window + x] = map[(window_y[cycle] + y) * size + window_x[cycle] + x];
+        }
+
+        double origin_x = window_x[cycle] * resolution, origin_y = window_y[cycle] * resolution;
+        field.update(window_map.data(), window, window, origin_x, origin_y, resolution);
+
+        DistanceField rebuilt_field(0.5);
+        rebuilt_field.update(window_map.data(), window, window, origin_x, origin_y, resolution);
+        for (int y = 0; y < window; y++)
+        {
+            for (int x = 0; x < window; x++)
+                ASSERT_NEAR(field.getCellDistance(x, y), rebuilt_field.getCellDistance(x, y), 1e-5) << "Cycle " << cycle << " (" << x << ", " << y << ")";
+        }
+
+        // Only the rows that entered and the columns within the truncation distance of the edges are updated
+        if (cycle == 1)
+        {
+            EXPECT_EQ(field.numUpdatedRows(), 2);
+        }
+        else if (cycle == 2)
+        {
+            EXPECT_LT(field.numUpdatedColumns(), window);
+        }
+    }
+}
+
+TEST_F(DistanceFieldTest, GradientPointsAway)
+{
+    size = 100;
+    map.assign(size * size, 0);
+    map[50 * size + 50] = 254; // Obstacle at (2.525, 2.525)
+
+    DistanceField field;
+    field.update(map.data(), size, size, 0., 0., resolution);
+
+    Eigen::Vector2d gradient;
+    Eigen::Vector2d pos(3.3, 2.9);
+    double distance = field.getDistance(pos, gradient);
+
+    Eigen::Vector2d expected = pos - Eigen::Vector2d(2.525, 2.525);
+    EXPECT_NEAR(distance, expected.norm(), 0.05);
+    EXPECT_GT(gradient.normalized().dot(expected.normalized()), 0.99);
+}
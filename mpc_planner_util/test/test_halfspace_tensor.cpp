@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/halfspace_tensor.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the halfspace computation of the linearized constraints (run once per planner in T-MPC)
+class HalfspaceTensorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> position(-20., 20.);
+        std::uniform_real_distribution<double> radius(0.3, 0.6);
+
+        for (int i = 0; i < max_obstacles; i++)
+        {
+            obstacle_x.push_back(position(generator));
+            obstacle_y.push_back(position(generator));
+            offset.push_back(radius(generator) + 0.325);
+        }
+    }
+
+    const int max_obstacles{64};
+    std::vector<double> obstacle_x, obstacle_y, offset;
+};
+
+TEST_F(HalfspaceTensorTest, Alignment)
+{
+    HalfspaceTensor tensor(2, 30, 13);
+
+    EXPECT_EQ(tensor.numConstraints(), 13);
+    EXPECT_EQ(tensor.stride() % 4, 0);
+    for (int d = 0; d < 2; d++)
+    {
+        for (int k = 0; k < 30; k++)
+        {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(tensor.a1(d, k)) % HalfspaceTensor::ALIGNMENT, 0u);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(tensor.b(d, k)) % HalfspaceTensor::ALIGNMENT, 0u);
+            EXPECT_EQ(tensor.a2(d, k), tensor.a1(d, k) + tensor.stride()); // Rows of one disc and stage are adjacent
+        }
+    }
+}
+
+TEST_F(HalfspaceTensorTest, MatchesScalar)
+{
+    Eigen::Vector2d pos(0.5, -1.);
+    for (int num_obstacles : {0, 1, 3, 4, 7, 13, 64}) // Includes remainders of the vector width
+    {
+        HalfspaceTensor tensor(1, 2, num_obstacles);
+        computeObstacleHalfspaces(obstacle_x.data(), obstacle_y.data(), offset.data(), num_obstacles, pos,
+                                  tensor.a1(0, 0), tensor.a2(0, 0), tensor.b(0, 0));
+        computeObstacleHalfspacesScalar(obstacle_x.data(), obstacle_y.data(), offset.data(), num_obstacles, pos,
+                                        tensor.a1(0, 1), tensor.a2(0, 1), tensor.b(0, 1));
+
+        for (int i = 0; i < num_obstacles; i++)
+        {
+            EXPECT_NEAR(tensor.a1(0, 0)[i], tensor.a1(0, 1)[i], 1e-12);
+            EXPECT_NEAR(tensor.a2(0, 0)[i], tensor.a2(0, 1)[i], 1e-12);
+            EXPECT_NEAR(tensor.b(0, 0)[i], tensor.b(0, 1)[i], 1e-10);
+
+            // The point on the collision circle lies on the halfspace boundary
+            Eigen::Vector2d normal(tensor.a1(0, 0)[i], tensor.a2(0, 0)[i]);
+            Eigen::Vector2d boundary = Eigen::Vector2d(obstacle_x[i], obstacle_y[i]) - offset[i] * normal;
+            EXPECT_NEAR(normal.norm(), 1., 1e-12);
+            EXPECT_NEAR(normal.dot(boundary), tensor.b(0, 0)[i], 1e-10);
+        }
+    }
+}
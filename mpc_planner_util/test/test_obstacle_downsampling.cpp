@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/obstacle_downsampling.h"
+#include "mpc_planner_util/occupancy_tracker.h"
+
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the obstacle points passed to the decomposition of DecompConstraints in a warehouse-like map
+class ObstacleDownsamplingTest : public ::testing::Test
+{
+protected:
+    // 10 x 10 m with rows of 0.6 m deep shelves, walls and a few small obstacles
+    void createMap(double map_resolution)
+    {
+        resolution = map_resolution;
+        size = std::round(10. / resolution);
+        map.assign(size * size, 0);
+
+        auto fill = [&](double min_x, double min_y, double max_x, double max_y)
+        {
+            for (int y = std::max((int)(min_y / resolution), 0); y < std::min((int)(max_y / resolution), size); y++)
+            {
+                for (int x = std::max((int)(min_x / resolution), 0); x < std::min((int)(max_x / resolution), size); x++)
+                    map[y * size + x] = 254;
+            }
+        };
+
+        fill(0., 0., 10., 0.2);
+        fill(0., 9.8, 10., 10.);
+        for (double y = 1.5; y < 9.; y += 2.)
+            fill(1., y, 9., y + 0.6);
+
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> position(0., 10.);
+        for (int i = 0; i < 20; i++)
+        {
+            double x = position(generator), y = position(generator);
+            fill(x, y, x + 0.15, y + 0.15);
+        }
+
+        tracker.reset();
+        tracker.update(map.data(), size, size, 0., 0., resolution);
+    }
+
+    std::vector<unsigned char> map;
+    int size;
+    double resolution;
+
+    OccupancyTracker tracker;
+};
+
+TEST_F(ObstacleDownsamplingTest, VoxelFilterWithinTolerance)
+{
+    createMap(0.025);
+
+    ObstacleDownsampling downsampling(0.1);
+    downsampling.apply(tracker.getOccupied(), map.data(), size, size, 0., 0., resolution);
+    EXPECT_LT(downsampling.getPoints().size(), tracker.getOccupied().size());
+    EXPECT_DOUBLE_EQ(downsampling.getOffset(), 0.1);
+
+    // Every occupied cell has a point within the tolerance
+    for (auto &cell : tracker.getOccupied())
+    {
+        double closest = 1e9;
+        for (auto &point : downsampling.getPoints())
+            closest = std::min(closest, (point - cell).norm());
+        ASSERT_LE(closest, 0.1 + 1e-9);
+    }
+}
+
+TEST_F(ObstacleDownsamplingTest, BoundaryOnly)
+{
+    createMap(0.05);
+
+    ObstacleDownsampling downsampling(0., true);
+    downsampling.apply(tracker.getOccupied(), map.data(), size, size, 0., 0., resolution);
+
+    // Kept cells have a free neighbour or lie at the edge of the map
+    for (auto &point : downsampling.getPoints())
+    {
+        int x = point(0) / resolution, y = point(1) / resolution;
+        bool edge = x == 0 || y == 0 || x == size - 1 || y == size - 1;
+        ASSERT_TRUE(edge || map[y * size + x - 1] == 0 || map[y * size + x + 1] == 0 ||
+                    map[(y - 1) * size + x] == 0 || map[(y + 1) * size + x] == 0);
+    }
+    EXPECT_LT(downsampling.getPoints().size(), tracker.getOccupied().size() / 2);
+}
+
+TEST_F(ObstacleDownsamplingTest, DisabledPassesThrough)
+{
+    createMap(0.05);
+
+    // Voxels smaller than the cells do not merge anything
+    ObstacleDownsampling downsampling(0.02, false);
+    downsampling.apply(tracker.getOccupied(), map.data(), size, size, 0., 0., resolution);
+    EXPECT_EQ(&downsampling.getPoints(), &tracker.getOccupied());
+    EXPECT_DOUBLE_EQ(downsampling.getOffset(), 0.);
+}
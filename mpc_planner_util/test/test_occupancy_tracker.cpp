@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/occupancy_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the occupied cell extraction of the decomposition constraints on synthetic rolling costmaps
+class OccupancyTrackerTest : public ::testing::Test
+{
+protected:
+    // Occupied cells of a global map (10% occupied), read through a rolling window
+    struct World
+    {
+        int size;
+        std::vector<unsigned char> cells;
+
+        unsigned char get(int x, int y) const
+        {
+            if (x < 0 || y < 0 || x >= size || y >= size)
+                return 0;
+            return cells[y * size + x];
+        }
+    };
+
+    World createWorld(int size)
+    {
+        World world{size, std::vector<unsigned char>(size * size, 0)};
+        for (auto &cell : world.cells)
+            cell = occupied_distribution(generator) < 0.1 ? 254 : 0;
+        return world;
+    }
+
+    void readWindow(const World &world, int window_x, int window_y, int size, std::vector<unsigned char> &map)
+    {
+        map.resize(size * size);
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+                map[y * size + x] = world.get(window_x + x, window_y + y);
+        }
+    }
+
+    // Change a fraction of the cells of the world inside the window
+    void churn(World &world, int window_x, int window_y, int size, double fraction)
+    {
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        int num_changes = fraction * size * size;
+        for (int i = 0; i < num_changes; i++)
+        {
+            int x = std::min(window_x + cell(generator), world.size - 1), y = std::min(window_y + cell(generator), world.size - 1);
+            world.cells[y * world.size + x] = world.cells[y * world.size + x] == 0 ? 254 : 0;
+        }
+    }
+
+    // As before: all cells every cycle
+    void fullScan(const std::vector<unsigned char> &map, int size, double origin_x, double origin_y,
+                  std::vector<Eigen::Vector2d> &occupied)
+    {
+        occupied.clear();
+        for (int x = 0; x < size; x++)
+        {
+            for (int y = 0; y < size; y++)
+            {
+                if (map[y * size + x] == 0)
+                    continue;
+                occupied.emplace_back(origin_x + (x + 0.5) * resolution, origin_y + (y + 0.5) * resolution);
+            }
+        }
+    }
+
+    // Cells within range of a diagonal path through the map, one interval per row
+    void pathRegion(int size, int path_start, int path_end, int range, std::vector<int> &row_begin, std::vector<int> &row_end)
+    {
+        row_begin.assign(size, size);
+        row_end.assign(size, 0);
+        for (int i = path_start; i <= path_end; i++)
+        {
+            for (int y = std::max(i - range, 0); y <= std::min(i + range, size - 1); y++)
+            {
+                row_begin[y] = std::min(row_begin[y], i - range);
+                row_end[y] = std::max(row_end[y], i + range + 1);
+            }
+        }
+    }
+
+    void regionScan(const std::vector<unsigned char> &map, int size, const std::vector<int> &row_begin, const std::vector<int> &row_end,
+                    std::vector<Eigen::Vector2d> &occupied)
+    {
+        occupied.clear();
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = std::max(row_begin[y], 0); x < std::min(row_end[y], size); x++)
+            {
+                if (map[y * size + x] != 0)
+                    occupied.emplace_back((x + 0.5) * resolution, (y + 0.5) * resolution);
+            }
+        }
+    }
+
+    static std::vector<std::pair<double, double>> sorted(const std::vector<Eigen::Vector2d> &points)
+    {
+        std::vector<std::pair<double, double>> result;
+        for (auto &point : points)
+            result.emplace_back(std::round(point(0) / 1e-6) * 1e-6, std::round(point(1) / 1e-6) * 1e-6);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    const double resolution{0.05};
+    std::mt19937 generator{0};
+    std::uniform_real_distribution<double> occupied_distribution{0., 1.};
+};
+
+TEST_F(OccupancyTrackerTest, MatchesFullScan)
+{
+    const int size = 80;
+    World world = createWorld(400);
+
+    OccupancyTracker tracker;
+    std::vector<unsigned char> map;
+    std::vector<Eigen::Vector2d> expected;
+
+    int window_x = 100, window_y = 100;
+    for (int cycle = 0; cycle < 30; cycle++)
+    {
+        // Drive diagonally, sometimes not moving the window, sometimes jumping
+        window_x += cycle % 3;
+        window_y += (cycle % 4 == 0) ? 1 : 0;
+        if (cycle == 20)
+            window_x += 2 * size;
+
+        churn(world, window_x, window_y, size, 0.01);
+        readWindow(world, window_x, window_y, size, map);
+
+        tracker.update(map.data(), size, size, window_x * resolution, window_y * resolution, resolution);
+        fullScan(map, size, window_x * resolution, window_y * resolution, expected);
+
+        ASSERT_EQ(sorted(tracker.getOccupied()), sorted(expected)) << "Cycle " << cycle;
+    }
+}
+
+TEST_F(OccupancyTrackerTest, MatchesRegionScan)
+{
+    const int size = 200, range = 20;
+    World world = createWorld(size);
+
+    OccupancyTracker tracker;
+    std::vector<unsigned char> map;
+    std::vector<int> row_begin, row_end;
+    std::vector<Eigen::Vector2d> expected;
+
+    for (int cycle = 0; cycle < 30; cycle++)
+    {
+        // The path moves along the diagonal, sometimes jumping
+        int path_start = 2 * cycle + (cycle >= 20 ? 60 : 0);
+        pathRegion(size, path_start, path_start + 50, range, row_begin, row_end);
+
+        churn(world, 0, 0, size, 0.01);
+        readWindow(world, 0, 0, size, map);
+
+        tracker.setRegion(row_begin, row_end);
+        tracker.update(map.data(), size, size, 0., 0., resolution);
+        regionScan(map, size, row_begin, row_end, expected);
+
+        ASSERT_EQ(sorted(tracker.getOccupied()), sorted(expected)) << "Cycle " << cycle;
+    }
+}
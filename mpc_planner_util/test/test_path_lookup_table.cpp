@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/path_lookup_table.h"
+
+#include <ros_tools/spline.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the path lookup table against the spline it samples
+class PathLookupTableTest : public ::testing::Test
+{
+protected:
+    // A curved path sampled every 1 m
+    void createPath(double s_start, std::vector<double> &x, std::vector<double> &y, std::vector<double> &s)
+    {
+        double psi = 0.;
+        x = {0.};
+        y = {0.};
+        s = {s_start};
+        for (int i = 1; i < 40; i++)
+        {
+            psi += 0.15 * std::sin(0.2 * i);
+            x.push_back(x.back() + std::cos(psi));
+            y.push_back(y.back() + std::sin(psi));
+            s.push_back(s.back() + std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]));
+        }
+    }
+
+    void compare(const RosTools::Spline2D &spline, const PathLookupTable &table, double s_start, double s_end)
+    {
+        EXPECT_NEAR(table.start(), s_start, 1e-9);
+        EXPECT_NEAR(table.start() + table.length(), s_end, 1e-9);
+
+        double max_point_error = 0., max_normal_error = 0.;
+        for (double s = s_start; s <= s_end; s += 0.013)
+        {
+            max_point_error = std::max(max_point_error, (table.getPoint(s) - spline.getPoint(s)).norm());
+            max_normal_error = std::max(max_normal_error, (table.getOrthogonal(s) - spline.getOrthogonal(s)).norm());
+        }
+
+        EXPECT_LT(max_point_error, 1e-3);
+        EXPECT_LT(max_normal_error, 1e-2);
+    }
+};
+
+TEST_F(PathLookupTableTest, MatchesSpline)
+{
+    std::vector<double> x, y, s;
+    createPath(0., x, y, s);
+    RosTools::Spline2D spline(x, y, s);
+
+    PathLookupTable table(spline, 0.1);
+    compare(spline, table, 0., s.back());
+}
+
+TEST_F(PathLookupTableTest, MatchesContinuedSpline)
+{
+    // A continued (rolling) path does not start at s = 0
+    std::vector<double> x, y, s;
+    createPath(12.5, x, y, s);
+    RosTools::Spline2D spline(x, y, s);
+
+    PathLookupTable table(spline, 0.1);
+    compare(spline, table, 12.5, s.back());
+}
+
+TEST_F(PathLookupTableTest, ClampsOutOfRange)
+{
+    std::vector<double> x, y, s;
+    createPath(12.5, x, y, s);
+    RosTools::Spline2D spline(x, y, s);
+    PathLookupTable table(spline, 0.1);
+
+    // Lookups beyond the ends of the path return the ends
+    for (double offset : {0.5, 3., 100.})
+    {
+        EXPECT_NEAR((table.getPoint(12.5 - offset) - table.getPoint(12.5)).norm(), 0., 1e-9);
+        EXPECT_NEAR((table.getPoint(s.back() + offset) - table.getPoint(s.back())).norm(), 0., 1e-9);
+
+        EXPECT_NEAR((table.getOrthogonal(12.5 - offset) - table.getOrthogonal(12.5)).norm(), 0., 1e-9);
+        EXPECT_NEAR((table.getTangent(s.back() + offset) - table.getTangent(s.back())).norm(), 0., 1e-9);
+        EXPECT_NEAR(table.getCurvature(s.back() + offset), table.getCurvature(s.back()), 1e-9);
+    }
+
+    EXPECT_NEAR((table.getPoint(12.0) - spline.getPoint(12.5)).norm(), 0., 1e-3);
+    EXPECT_NEAR((table.getPoint(s.back() + 1.) - spline.getPoint(s.back())).norm(), 0., 1e-3);
+}
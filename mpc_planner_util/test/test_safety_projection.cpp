@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/safety_projection.h"
+
+#include <random>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// The culled projection against projecting on all obstacles
+class SafetyProjectionTest : public ::testing::Test
+{
+protected:
+    // Obstacles moving in a 30 x 30 m area, the robot drives through the middle
+    void createScene(int num_obstacles, double min_separation)
+    {
+        std::mt19937 generator(num_obstacles);
+        std::uniform_real_distribution<double> position(-15., 15.);
+        std::uniform_real_distribution<double> velocity(-1., 1.);
+
+        obstacle_x.assign(N, std::vector<double>());
+        obstacle_y.assign(N, std::vector<double>());
+        radius.assign(num_obstacles, 0.4 + 0.325);
+
+        std::vector<Eigen::Vector2d> start, direction;
+        while ((int)start.size() < num_obstacles)
+        {
+            Eigen::Vector2d candidate(position(generator), position(generator));
+
+            bool separated = true;
+            for (auto &other : start)
+                separated &= (candidate - other).norm() > min_separation;
+
+            if (separated)
+            {
+                start.push_back(candidate);
+                direction.push_back(Eigen::Vector2d(velocity(generator), velocity(generator)));
+            }
+        }
+
+        for (int k = 0; k < N; k++)
+        {
+            for (int i = 0; i < num_obstacles; i++)
+            {
+                // Translate all obstacles together, keeping the separation
+                Eigen::Vector2d obstacle = start[i] + direction[0] * k * dt;
+                obstacle_x[k].push_back(obstacle(0));
+                obstacle_y[k].push_back(obstacle(1));
+            }
+        }
+
+        robot.clear();
+        for (int k = 0; k < N; k++)
+            robot.emplace_back(-15. + 30. * k / (double)N, 0.5 * std::sin(0.3 * k));
+    }
+
+    // As before: 3 Douglas-Rachford iterations over all obstacles
+    void projectAll(int k, Eigen::Vector2d &pos)
+    {
+        for (int iterate = 0; iterate < 3; iterate++)
+        {
+            for (size_t i = 0; i < obstacle_x[k].size(); i++)
+            {
+                dr_projection.douglasRachfordProjection(pos, Eigen::Vector2d(obstacle_x[k][i], obstacle_y[k][i]),
+                                                        Eigen::Vector2d(obstacle_x[k][0], obstacle_y[k][0]),
+                                                        radius[i], pos);
+            }
+        }
+    }
+
+    const int N{30};
+    const double dt{0.2};
+
+    std::vector<std::vector<double>> obstacle_x, obstacle_y;
+    std::vector<double> radius;
+    std::vector<Eigen::Vector2d> robot;
+
+    DouglasRachford dr_projection;
+};
+
+TEST_F(SafetyProjectionTest, MatchesFullProjection)
+{
+    // Obstacles that do not overlap, that may overlap and a dense crowd
+    for (auto scene : std::vector<std::pair<int, double>>{{30, 3.}, {30, 0.}, {200, 0.}})
+    {
+        createScene(scene.first, scene.second);
+
+        SafetyProjection projection;
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> offset(-1., 1.);
+        for (int k = 0; k < N; k++)
+        {
+            projection.setObstacles(obstacle_x[k].data(), obstacle_y[k].data(), radius.data(), obstacle_x[k].size());
+
+            // Positions inside, next to and far from the obstacles (including the anchor)
+            std::vector<Eigen::Vector2d> positions = {robot[k]};
+            for (size_t i = 0; i < obstacle_x[k].size(); i += 3)
+            {
+                for (int sample = 0; sample < 3; sample++)
+                    positions.emplace_back(obstacle_x[k][i] + offset(generator), obstacle_y[k][i] + offset(generator));
+            }
+
+            for (auto &position : positions)
+            {
+                Eigen::Vector2d expected = position, culled = position;
+                projectAll(k, expected);
+                projection.project(culled);
+
+                ASSERT_NEAR((expected - culled).norm(), 0., 1e-9) << scene.first << " obstacles, stage " << k;
+            }
+        }
+    }
+}
+
+TEST_F(SafetyProjectionTest, DistanceQuery)
+{
+    // A single occupied point
+    Eigen::Vector2d occupied(1., 1.);
+    auto query = [&](const Eigen::Vector2d &pos, double range, Eigen::Vector2d &closest)
+    {
+        closest = occupied;
+        return (pos - occupied).norm() < range;
+    };
+
+    SafetyProjection projection;
+    Eigen::Vector2d pos(1.2, 1.1);
+    EXPECT_TRUE(projection.project(pos, 0.5, query));
+    EXPECT_GE((pos - occupied).norm(), 0.5 - 1e-9);
+
+    Eigen::Vector2d free_pos(3., 3.);
+    EXPECT_TRUE(projection.project(free_pos, 0.5, query));
+    EXPECT_EQ(free_pos, Eigen::Vector2d(3., 3.));
+}
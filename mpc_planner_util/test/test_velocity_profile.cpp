@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "mpc_planner_util/velocity_profile.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace MPCPlanner;
+
+// Tests of the curvature- and acceleration-limited velocity profile on synthetic paths
+class VelocityProfileTest : public ::testing::Test
+{
+protected:
+    // A winding route sampled every 0.5 m, of which a window is streamed
+    struct Path
+    {
+        std::vector<double> x, y, s;
+    };
+
+    Path createRoute(int num_points)
+    {
+        Path route;
+        double psi = 0.;
+        for (int i = 0; i < num_points; i++)
+        {
+            if (i == 0)
+            {
+                route.x.push_back(0.);
+                route.y.push_back(0.);
+                route.s.push_back(0.);
+                continue;
+            }
+            psi += 0.15 * std::sin(i * 0.05); // Alternating bends
+            route.x.push_back(route.x.back() + spacing * std::cos(psi));
+            route.y.push_back(route.y.back() + spacing * std::sin(psi));
+            route.s.push_back(route.s.back() + std::hypot(route.x[i] - route.x[i - 1], route.y[i] - route.y[i - 1]));
+        }
+        return route;
+    }
+
+    Path window(const Path &route, int start, int length)
+    {
+        Path result;
+        for (int i = start; i < start + length; i++)
+        {
+            result.x.push_back(route.x[i]);
+            result.y.push_back(route.y[i]);
+            result.s.push_back(route.s[i]);
+        }
+        return result;
+    }
+
+    const double spacing{0.5};
+    const double max_velocity{2.}, max_lateral_acceleration{1.}, max_acceleration{1.}, max_deceleration{1.5};
+};
+
+TEST_F(VelocityProfileTest, RespectsLimits)
+{
+    Path route = createRoute(400);
+
+    VelocityProfile profile(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+    profile.compute(route.x, route.y, route.s);
+
+    const auto &v = profile.getVelocity();
+    ASSERT_EQ(v.size(), route.s.size());
+    ASSERT_EQ(v.back(), 0.); // Stops at the end
+
+    for (size_t i = 1; i < v.size(); i++)
+    {
+        double ds = route.s[i] - route.s[i - 1];
+        ASSERT_LE(v[i], max_velocity + 1e-9);
+        ASSERT_LE(v[i] * v[i] - v[i - 1] * v[i - 1], 2. * max_acceleration * ds + 1e-9) << "Point " << i;
+        ASSERT_LE(v[i - 1] * v[i - 1] - v[i] * v[i], 2. * max_deceleration * ds + 1e-9) << "Point " << i;
+    }
+
+    // On a circle of radius 1 m, the lateral acceleration limits the velocity to 1 m/s
+    Path circle;
+    for (int i = 0; i < 200; i++)
+    {
+        double angle = i * 0.05;
+        circle.x.push_back(std::cos(angle));
+        circle.y.push_back(std::sin(angle));
+        circle.s.push_back(angle);
+    }
+    profile.compute(circle.x, circle.y, circle.s);
+    for (size_t i = 1; i < circle.s.size() - 1; i++)
+        ASSERT_LE(profile.getVelocity()[i], std::sqrt(max_lateral_acceleration * 1.) + 1e-3);
+    ASSERT_NEAR(profile.getVelocity()[100], 1., 1e-3);
+}
+
+TEST_F(VelocityProfileTest, WindowOfLongerRoute)
+{
+    Path route = createRoute(400);
+    Path path = window(route, 0, 200);
+
+    VelocityProfile stopping(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+    VelocityProfile open(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration, false);
+    stopping.compute(path.x, path.y, path.s);
+    open.compute(path.x, path.y, path.s);
+
+    // The window end is not a stop, the velocity there is limited by the last bend and the acceleration
+    const auto &v = open.getVelocity();
+    ASSERT_GT(v.back(), 0.);
+    double ds = path.s.back() - path.s[path.s.size() - 2];
+    ASSERT_LE(v.back() * v.back() - v[v.size() - 2] * v[v.size() - 2], 2. * max_acceleration * ds + 1e-9);
+
+    // Away from the end, both profiles are the same
+    for (size_t i = 0; i < v.size() / 2; i++)
+        ASSERT_EQ(v[i], stopping.getVelocity()[i]) << "Point " << i;
+}
+
+TEST_F(VelocityProfileTest, ContinuationMatchesFullComputation)
+{
+    Path route = createRoute(2000);
+
+    VelocityProfile rolling(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+    VelocityProfile full(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+
+    for (int cycle = 0; cycle < 50; cycle++)
+    {
+        // Points are dropped at the front and appended at the back, the window length varies
+        Path path = window(route, 7 * cycle, 200 + (cycle % 5) * 3);
+
+        rolling.compute(path.x, path.y, path.s, cycle > 0);
+        full.compute(path.x, path.y, path.s);
+
+        if (cycle > 0)
+        {
+            ASSERT_GT(rolling.numReused(), 0);
+        }
+
+        ASSERT_EQ(rolling.getVelocity(), full.getVelocity()) << "Cycle " << cycle;
+    }
+}
+
+TEST_F(VelocityProfileTest, ChangedPointsAreRecomputed)
+{
+    Path route = createRoute(400);
+    Path path = window(route, 0, 200);
+
+    VelocityProfile rolling(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+    VelocityProfile full(max_velocity, max_lateral_acceleration, max_acceleration, max_deceleration);
+    rolling.compute(path.x, path.y, path.s);
+
+    // The path was refit with the same s-coordinates, but a bend moved
+    Path moved = window(route, 10, 200);
+    for (int i = 50; i < 100; i++)
+        moved.y[i] += 0.5 * std::sin((i - 50) * M_PI / 50.);
+
+    rolling.compute(moved.x, moved.y, moved.s, true);
+    full.compute(moved.x, moved.y, moved.s);
+
+    ASSERT_GT(rolling.numReused(), 0); // Before and after the bend
+    ASSERT_LT(rolling.numReused(), 200 - 50);
+    ASSERT_EQ(rolling.getVelocity(), full.getVelocity());
+}
@@ -232,24 +232,45 @@ def generate_parameter_cpp_code(settings, model):
 
     cpp_file.write("namespace MPCPlanner{\n\n")
 
+    # Stage-invariant parameters are only set in the stage template (stage 0), the solver copies them to all stages
+    runs = settings["params"].stage_invariant_runs()
+    header_file.write("// Stage-invariant parameters as runs {first index, length}, copied from stage 0 to all stages\n")
+    if len(runs) > 0:
+        header_file.write(f"const int STAGE_INVARIANT_PARAMETER_RUNS[][2] = {{{', '.join([f'{{{run[0]}, {run[1]}}}' for run in runs])}}};\n")
+    else:
+        header_file.write("const int STAGE_INVARIANT_PARAMETER_RUNS[][2] = {{0, 0}};\n")
+    header_file.write(f"const int NUM_STAGE_INVARIANT_PARAMETER_RUNS = {len(runs)};\n\n")
+    header_file.write("// The setters of stage-invariant parameters ignore k and write the template, like Solver::setParameter\n")
+
+    param_names = {idx: param for param, idx in settings["params"]._params.items() if param != "num parameters"}
     for key, indices in settings["params"].parameter_bundles.items():
         function_name = key.replace("_", " ").title().replace(" ", "")
 
+        stage_invariant = all([settings["params"].is_stage_invariant(param_names[index]) for index in indices])
+        if stage_invariant:
+            offset = ""  # Written to the template, regardless of k
+        else:
+            offset = f"k * {settings['params'].length()} + "
+
         if len(indices) == 1:
             header_file.write(f"void setSolverParameter{function_name}(int k, {param_name}& params, const double value, int index=0);\n")
             cpp_file.write(f"void setSolverParameter{function_name}(int k, {param_name}& params, const double value, int index){{\n")
             cpp_file.write("\t(void)index;\n")
-            cpp_file.write(f"\tparams.all_parameters[k * {settings['params'].length()} + {indices[0]}] = value;\n")
+            if stage_invariant:
+                cpp_file.write("\t(void)k;\n")
+            cpp_file.write(f"\tparams.all_parameters[{offset}{indices[0]}] = value;\n")
         else:
             header_file.write(f"void setSolverParameter{function_name}(int k, {param_name}& params, const double value, int index);\n")
             cpp_file.write(f"void setSolverParameter{function_name}(int k, {param_name}& params, const double value, int index){{\n")
+            if stage_invariant:
+                cpp_file.write("\t(void)k;\n")
             for i, index in enumerate(indices):
                 if i == 0:
                     cpp_file.write(f"\tif(index == {i})\n")
                 else:
                     cpp_file.write(f"\telse if(index == {i})\n")
 
-                cpp_file.write(f"\t\tparams.all_parameters[k * {settings['params'].length()} + {index}] = value;\n")
+                cpp_file.write(f"\t\tparams.all_parameters[{offset}{index}] = value;\n")
 
         cpp_file.write("}\n")
 
@@ -322,7 +343,7 @@ def generate_rqtreconfigure(settings):
     rqt_header.write("\t\t\t_first_reconfigure_callback = false;\n")
     rqt_header.write("\t\t}else{\n")
     for idx, param in enumerate(rqt_params):
-        rqt_header.write(f'\t\t\tCONFIG{settings["params"].rqt_param_config_names[idx](param)} = config.{param};\n')
+        rqt_header.write(f'\t\t\tMUTABLE_CONFIG{settings["params"].rqt_param_config_names[idx](param)} = config.{param};\n')
     rqt_header.write("\t\t}\n")
 
     rqt_header.write("\t}\n\n")
@@ -402,7 +423,7 @@ def generate_ros2_rqtreconfigure(settings):
     rqt_header.write("\t{\n")
     for idx, param in enumerate(rqt_params):
         rqt_header.write(
-            f"\t\tupdateParam<double>(parameters, \"{param}\", CONFIG{settings['params'].rqt_param_config_names[idx](param)});\n"
+            f"\t\tupdateParam<double>(parameters, \"{param}\", MUTABLE_CONFIG{settings['params'].rqt_param_config_names[idx](param)});\n"
         )
 
     rqt_header.write("\n")
@@ -19,6 +19,8 @@ class Parameters:
         self.rqt_param_min_values = []
         self.rqt_param_max_values = []
 
+        self.stage_invariant_params = []  # Identical in all stages, loaded from the stage template
+
         self._param_idx = 0
         self._p = None
 
@@ -30,6 +32,7 @@ class Parameters:
         bundle_name=None,
         rqt_min_value=0.0,
         rqt_max_value=100.0,
+        stage_invariant=None,
     ):
         """
         Adds a parameter to the parameter dictionary.
@@ -38,6 +41,7 @@ class Parameters:
             parameter (Any): The parameter to be added.
             add_to_rqt_reconfigure (bool, optional): Whether to add the parameter to the RQT Reconfigure. Defaults to False.
             rqt_config_name (function, optional): A function that returns the name of the parameter in CONFIG for the parameter in RQT Reconfigure. Defaults to lambda p: f'["weights"]["{p}"]'.
+            stage_invariant (bool, optional): Whether the parameter has the same value in all stages. It is then only set in the stage template and copied to all stages by the solver. Defaults to add_to_rqt_reconfigure (weights).
         """
 
         if parameter in self._params.keys():
@@ -52,6 +56,12 @@ class Parameters:
         else:
             self.parameter_bundles[bundle_name].append(copy.deepcopy(self._param_idx))
 
+        if stage_invariant is None:
+            stage_invariant = add_to_rqt_reconfigure
+
+        if stage_invariant:
+            self.stage_invariant_params.append(parameter)
+
         self._param_idx += 1
 
         if add_to_rqt_reconfigure:
@@ -63,6 +73,19 @@ class Parameters:
     def length(self):
         return self._param_idx
 
+    def is_stage_invariant(self, parameter):
+        return parameter in self.stage_invariant_params
+
+    def stage_invariant_runs(self):
+        """Returns the indices of the stage-invariant parameters as consecutive runs [first index, length]"""
+        runs = []
+        for idx in sorted([self._params[param] for param in self.stage_invariant_params]):
+            if len(runs) > 0 and runs[-1][0] + runs[-1][1] == idx:
+                runs[-1][1] += 1
+            else:
+                runs.append([idx, 1])
+        return runs
+
     def load(self, p):
         self._p = p
 
@@ -91,6 +114,8 @@ class Parameters:
         for param, idx in self._params.items():
             if param in self.rqt_params:
                 print_value(f"{idx}", f"{param} (in rqt_reconfigure)", tab=True)
+            elif param in self.stage_invariant_params:
+                print_value(f"{idx}", f"{param} (stage invariant)", tab=True)
             else:
                 print_value(f"{idx}", f"{param}", tab=True)
         print("----------")